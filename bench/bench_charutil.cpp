@@ -0,0 +1,406 @@
+/*
+ *  bench_charutil.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This program measures the throughput of IsUTF8Valid(),
+ *      ConvertUTF8ToUTF16(), ConvertUTF16ToUTF8(), MeasureUTF8(),
+ *      CountUTF8CodePoints(), CountUTF16CodePoints(), and the construction
+ *      of a UTF8Index for input sizes from 16 octets to 256 MiB, for both
+ *      UTF-16 byte orders, for each SIMD tier supported by the processor,
+ *      and for each of the generated corpora (see corpus.h).  Each result is
+ *      reported in GB/s of input and in millions of code points per second.
+ *
+ *      The following options are accepted:
+ *          --filter=<text>     Run only benchmarks whose name contains text
+ *          --max-size=<octets> Skip input sizes larger than the given size
+ *          --min-time=<secs>   Minimum time to run each benchmark (0.1)
+ *          --seed=<number>     Seed used to generate the corpora
+ *          --csv               Produce comma-separated output
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <terra/charutil/character_utilities.h>
+#include <terra/charutil/utf8_index.h>
+#include "simd_dispatch.h"
+#include "corpus.h"
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// A function to measure, which returns a value that depends on the result so
+// that the work cannot be optimized away
+struct Benchmark
+{
+    std::string name;
+    std::function<std::size_t(const Bench::Corpus &,
+                              std::vector<std::uint8_t> &)> function;
+    std::vector<std::uint8_t> Bench::Corpus::*input;
+};
+
+// Options given on the command line
+struct Options
+{
+    std::string filter;
+    std::size_t max_size = std::size_t{256} << 20;
+    double min_time = 0.1;
+    std::uint64_t seed = Bench::Default_Corpus_Seed;
+    bool csv = false;
+};
+
+// Value that depends on the result of every iteration
+volatile std::size_t Sink;
+
+/*
+ *  MakeBenchmarks()
+ *
+ *  Description:
+ *      Produce the list of functions to measure.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The list of benchmarks.
+ *
+ *  Comments:
+ *      The output buffer given to each function is large enough for any of
+ *      the conversions.
+ */
+std::vector<Benchmark> MakeBenchmarks()
+{
+    return
+    {
+        {"IsUTF8Valid",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return std::size_t{IsUTF8Valid(corpus.utf8)};
+         },
+         &Bench::Corpus::utf8},
+        {"ConvertUTF8ToUTF16/LE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &out)
+         {
+             return ConvertUTF8ToUTF16(corpus.utf8, out, true).second;
+         },
+         &Bench::Corpus::utf8},
+        {"ConvertUTF8ToUTF16/BE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &out)
+         {
+             return ConvertUTF8ToUTF16(corpus.utf8, out, false).second;
+         },
+         &Bench::Corpus::utf8},
+        {"ConvertUTF16ToUTF8/LE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &out)
+         {
+             return ConvertUTF16ToUTF8(corpus.utf16le, out, true).second;
+         },
+         &Bench::Corpus::utf16le},
+        {"ConvertUTF16ToUTF8/BE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &out)
+         {
+             return ConvertUTF16ToUTF8(corpus.utf16be, out, false).second;
+         },
+         &Bench::Corpus::utf16be},
+        {"MeasureUTF8",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return MeasureUTF8(corpus.utf8).utf16_length;
+         },
+         &Bench::Corpus::utf8},
+        {"UTF8Index",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return UTF8Index(corpus.utf8).CodePoints();
+         },
+         &Bench::Corpus::utf8},
+        {"CountUTF8CodePoints",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return CountUTF8CodePoints(corpus.utf8);
+         },
+         &Bench::Corpus::utf8},
+        {"CountUTF16CodePoints/LE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return CountUTF16CodePoints(corpus.utf16le, true);
+         },
+         &Bench::Corpus::utf16le},
+        {"CountUTF16CodePoints/BE",
+         [](const Bench::Corpus &corpus, std::vector<std::uint8_t> &)
+         {
+             return CountUTF16CodePoints(corpus.utf16be, false);
+         },
+         &Bench::Corpus::utf16be}
+    };
+}
+
+/*
+ *  Measure()
+ *
+ *  Description:
+ *      Call the benchmark function repeatedly until the minimum time has
+ *      elapsed.
+ *
+ *  Parameters:
+ *      benchmark [in]
+ *          The benchmark to measure.
+ *
+ *      corpus [in]
+ *          The input data.
+ *
+ *      out [out]
+ *          The output buffer.
+ *
+ *      min_time [in]
+ *          The minimum time in seconds over which to measure.
+ *
+ *  Returns:
+ *      The number of iterations and the total elapsed time in seconds.
+ *
+ *  Comments:
+ *      The number of iterations is increased until a batch of iterations
+ *      takes at least the minimum time, much like Google Benchmark.
+ */
+std::pair<std::size_t, double> Measure(const Benchmark &benchmark,
+                                       const Bench::Corpus &corpus,
+                                       std::vector<std::uint8_t> &out,
+                                       double min_time)
+{
+    std::size_t iterations = 1;
+
+    // Warm the caches and the branch predictors
+    Sink = Sink + benchmark.function(corpus, out);
+
+    while (true)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            Sink = Sink + benchmark.function(corpus, out);
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        if ((elapsed.count() >= min_time) || (iterations >= (1u << 30)))
+        {
+            return {iterations, elapsed.count()};
+        }
+
+        // Estimate the iterations needed, growing by no more than 10x
+        double scale = (elapsed.count() > 0.0) ?
+                           (min_time * 1.4 / elapsed.count()) : 10.0;
+        iterations = static_cast<std::size_t>(
+            static_cast<double>(iterations) * std::clamp(scale, 2.0, 10.0));
+    }
+}
+
+/*
+ *  Report()
+ *
+ *  Description:
+ *      Print the result of a benchmark.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The full name of the benchmark.
+ *
+ *      corpus [in]
+ *          The input data.
+ *
+ *      benchmark [in]
+ *          The benchmark that was measured.
+ *
+ *      measurement [in]
+ *          The number of iterations and the total elapsed time in seconds.
+ *
+ *      csv [in]
+ *          Produce comma-separated output?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Report(const std::string &name,
+            const Bench::Corpus &corpus,
+            const Benchmark &benchmark,
+            const std::pair<std::size_t, double> &measurement,
+            bool csv)
+{
+    const auto &[iterations, elapsed] = measurement;
+    double seconds = elapsed / static_cast<double>(iterations);
+    double octets = static_cast<double>((corpus.*benchmark.input).size());
+    double gbps = octets / seconds / 1e9;
+    double mcps = static_cast<double>(corpus.code_points) / seconds / 1e6;
+
+    if (csv)
+    {
+        std::printf("%s,%zu,%zu,%.1f,%.3f,%.1f\n",
+                    name.c_str(),
+                    (corpus.*benchmark.input).size(),
+                    iterations,
+                    seconds * 1e9,
+                    gbps,
+                    mcps);
+    }
+    else
+    {
+        std::printf("%-56s %11.1f ns %12zu %10.3f %12.1f\n",
+                    name.c_str(),
+                    seconds * 1e9,
+                    iterations,
+                    gbps,
+                    mcps);
+    }
+    std::fflush(stdout);
+}
+
+/*
+ *  ParseOptions()
+ *
+ *  Description:
+ *      Parse the command-line options.
+ *
+ *  Parameters:
+ *      argc [in]
+ *          The number of arguments.
+ *
+ *      argv [in]
+ *          The arguments.
+ *
+ *      options [out]
+ *          The parsed options.
+ *
+ *  Returns:
+ *      True if the options are valid, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+
+        if (argument.starts_with("--filter="))
+        {
+            options.filter = argument.substr(9);
+        }
+        else if (argument.starts_with("--max-size="))
+        {
+            options.max_size = std::strtoull(argv[i] + 11, nullptr, 10);
+        }
+        else if (argument.starts_with("--min-time="))
+        {
+            options.min_time = std::strtod(argv[i] + 11, nullptr);
+        }
+        else if (argument.starts_with("--seed="))
+        {
+            options.seed = std::strtoull(argv[i] + 7, nullptr, 0);
+        }
+        else if (argument == "--csv")
+        {
+            options.csv = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::vector<std::pair<SIMD::Tier, const char *>> tiers =
+    {
+        {SIMD::Tier::Scalar, "scalar"},
+        {SIMD::Tier::SSE42, "sse42"},
+        {SIMD::Tier::AVX2, "avx2"},
+        {SIMD::Tier::AVX512, "avx512"}
+    };
+    const std::vector<Benchmark> benchmarks = MakeBenchmarks();
+    Options options;
+
+    if (!ParseOptions(argc, argv, options)) return EXIT_FAILURE;
+
+    if (options.csv)
+    {
+        std::printf("name,octets,iterations,ns_per_iteration,gb_per_second,"
+                    "mcp_per_second\n");
+    }
+    else
+    {
+        std::printf("%-56s %14s %12s %10s %12s\n",
+                    "Benchmark",
+                    "Time",
+                    "Iterations",
+                    "GB/s",
+                    "Mcp/s");
+        std::printf("%s\n", std::string(108, '-').c_str());
+    }
+
+    for (std::size_t size = 16; size <= options.max_size; size *= 16)
+    {
+        for (std::string_view corpus_name : Bench::CorpusNames())
+        {
+            const Bench::Corpus corpus =
+                Bench::GenerateCorpus(corpus_name, size, options.seed);
+            std::vector<std::uint8_t> out(
+                std::max(corpus.utf8.size() * 2,
+                         corpus.utf16le.size() * 3 / 2));
+
+            for (const auto &[tier, tier_name] : tiers)
+            {
+                if (!SIMD::SetTier(tier)) continue;
+
+                for (const Benchmark &benchmark : benchmarks)
+                {
+                    std::string name = benchmark.name + "/" + tier_name +
+                                       "/" + corpus.name + "/" +
+                                       std::to_string(size);
+                    if (name.find(options.filter) == std::string::npos)
+                    {
+                        continue;
+                    }
+
+                    Report(name,
+                           corpus,
+                           benchmark,
+                           Measure(benchmark, corpus, out, options.min_time),
+                           options.csv);
+                }
+            }
+
+            SIMD::SetTier(SIMD::GetSupportedTier());
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,420 @@
+/*
+ *  corpus.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements a generator that synthesizes text used to
+ *      measure the performance of the library.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <terra/charutil/character_utilities.h>
+#include "corpus.h"
+
+namespace Terra::CharUtil::Bench
+{
+
+namespace
+{
+
+// Pseudo-random number generator (SplitMix64), used rather than the standard
+// library distributions since those may produce different sequences on
+// different platforms
+class Random
+{
+    public:
+        explicit Random(std::uint64_t seed) : state{seed} {}
+
+        // Return the next value in the sequence
+        std::uint64_t Next()
+        {
+            std::uint64_t z = (state += 0x9e37'79b9'7f4a'7c15);
+            z = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9;
+            z = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11eb;
+            return z ^ (z >> 31);
+        }
+
+        // Return a value in the range [low, high]
+        std::uint32_t Range(std::uint32_t low, std::uint32_t high)
+        {
+            return low + static_cast<std::uint32_t>(Next() % (high - low + 1));
+        }
+
+        // Return true with the given percent probability
+        bool Chance(std::uint32_t percent) { return Range(0, 99) < percent; }
+
+    protected:
+        std::uint64_t state;
+};
+
+// Lowercase Latin-1 letters with diacritical marks
+constexpr std::array<char32_t, 30> Accented_Letters =
+{
+    U'à', U'á', U'â', U'ã', U'ä', U'å', U'æ', U'ç', U'è', U'é',
+    U'ê', U'ë', U'ì', U'í', U'î', U'ï', U'ð', U'ñ', U'ò', U'ó',
+    U'ô', U'õ', U'ö', U'ø', U'ù', U'ú', U'û', U'ü', U'ý', U'ÿ'
+};
+
+/*
+ *  AppendUTF8()
+ *
+ *  Description:
+ *      Append the UTF-8 encoding of the given character to the string.
+ *
+ *  Parameters:
+ *      utf8 [in/out]
+ *          The string to which the character is appended.
+ *
+ *      character [in]
+ *          The character to append, which must be a Unicode scalar value.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void AppendUTF8(std::vector<std::uint8_t> &utf8, char32_t character)
+{
+    if (character < 0x80)
+    {
+        utf8.push_back(static_cast<std::uint8_t>(character));
+    }
+    else if (character < 0x800)
+    {
+        utf8.push_back(static_cast<std::uint8_t>(0xc0 | (character >> 6)));
+        utf8.push_back(static_cast<std::uint8_t>(0x80 | (character & 0x3f)));
+    }
+    else if (character < 0x10000)
+    {
+        utf8.push_back(static_cast<std::uint8_t>(0xe0 | (character >> 12)));
+        utf8.push_back(
+            static_cast<std::uint8_t>(0x80 | ((character >> 6) & 0x3f)));
+        utf8.push_back(static_cast<std::uint8_t>(0x80 | (character & 0x3f)));
+    }
+    else
+    {
+        utf8.push_back(static_cast<std::uint8_t>(0xf0 | (character >> 18)));
+        utf8.push_back(
+            static_cast<std::uint8_t>(0x80 | ((character >> 12) & 0x3f)));
+        utf8.push_back(
+            static_cast<std::uint8_t>(0x80 | ((character >> 6) & 0x3f)));
+        utf8.push_back(static_cast<std::uint8_t>(0x80 | (character & 0x3f)));
+    }
+}
+
+/*
+ *  AppendWordSeparator()
+ *
+ *  Description:
+ *      Append the text that follows a word in space-separated scripts.
+ *
+ *  Parameters:
+ *      random [in/out]
+ *          The pseudo-random number generator.
+ *
+ *      text [in/out]
+ *          The text to which the separator is appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Most words are followed by a space, and some by punctuation or the
+ *      end of a line.
+ */
+void AppendWordSeparator(Random &random, std::u32string &text)
+{
+    std::uint32_t choice = random.Range(0, 99);
+
+    if (choice < 8)
+    {
+        text += U", ";
+    }
+    else if (choice < 14)
+    {
+        text += U". ";
+    }
+    else if (choice < 16)
+    {
+        text += U".\n";
+    }
+    else
+    {
+        text += U' ';
+    }
+}
+
+/*
+ *  NextWord()
+ *
+ *  Description:
+ *      Append the next word (or run of characters) of the named corpus.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the corpus.
+ *
+ *      random [in/out]
+ *          The pseudo-random number generator.
+ *
+ *      text [in/out]
+ *          The text to which the word is appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      An unknown name results in an exception, though the name is checked
+ *      by the caller before generating any text.
+ */
+void NextWord(std::string_view name, Random &random, std::u32string &text)
+{
+    std::uint32_t length = random.Range(1, 10);
+
+    if (name == "ascii")
+    {
+        for (std::uint32_t i = 0; i < length; i++)
+        {
+            text += static_cast<char32_t>(random.Range(U'a', U'z'));
+        }
+        AppendWordSeparator(random, text);
+    }
+    else if (name == "latin")
+    {
+        // Roughly one letter in six carries an accent
+        for (std::uint32_t i = 0; i < length; i++)
+        {
+            if (random.Chance(16))
+            {
+                text += Accented_Letters[random.Range(
+                    0,
+                    static_cast<std::uint32_t>(Accented_Letters.size() - 1))];
+            }
+            else
+            {
+                text += static_cast<char32_t>(random.Range(U'a', U'z'));
+            }
+        }
+        AppendWordSeparator(random, text);
+    }
+    else if (name == "cyrillic")
+    {
+        // Words occasionally start with a capital letter
+        text += static_cast<char32_t>(random.Chance(10) ?
+                                          random.Range(U'А', U'Я') :
+                                          random.Range(U'а', U'я'));
+        for (std::uint32_t i = 1; i < length; i++)
+        {
+            text += static_cast<char32_t>(random.Range(U'а', U'я'));
+        }
+        AppendWordSeparator(random, text);
+    }
+    else if (name == "cjk")
+    {
+        // Ideographs are not separated by spaces, but runs are separated by
+        // CJK punctuation and occasionally by an ASCII number
+        for (std::uint32_t i = 0; i < length; i++)
+        {
+            text += static_cast<char32_t>(random.Range(0x4e00, 0x9fff));
+        }
+        std::uint32_t choice = random.Range(0, 99);
+        if (choice < 50)
+        {
+            text += U'，';
+        }
+        else if (choice < 80)
+        {
+            text += U'。';
+        }
+        else if (choice < 90)
+        {
+            text += std::u32string(random.Range(1, 4),
+                                   static_cast<char32_t>(U'0' + choice % 10));
+        }
+        else
+        {
+            text += U'\n';
+        }
+    }
+    else if (name == "emoji")
+    {
+        // Mostly emoji with occasional short ASCII words
+        if (random.Chance(20))
+        {
+            for (std::uint32_t i = 0; i < (length + 1) / 2; i++)
+            {
+                text += static_cast<char32_t>(random.Range(U'a', U'z'));
+            }
+        }
+        else
+        {
+            for (std::uint32_t i = 0; i < (length + 1) / 2; i++)
+            {
+                text += static_cast<char32_t>(random.Chance(50) ?
+                                                  random.Range(0x1f600,
+                                                               0x1f64f) :
+                                                  random.Range(0x1f300,
+                                                               0x1f5ff));
+            }
+        }
+        text += U' ';
+    }
+    else if (name == "adversarial")
+    {
+        // Every character has a randomly chosen encoded length, defeating
+        // any code that optimizes for runs of characters of equal length
+        for (std::uint32_t i = 0; i < length; i++)
+        {
+            switch (random.Range(1, 4))
+            {
+                case 1:
+                    text += static_cast<char32_t>(random.Range(0x21, 0x7e));
+                    break;
+
+                case 2:
+                    text += static_cast<char32_t>(random.Range(0x80, 0x7ff));
+                    break;
+
+                case 3:
+                    text += static_cast<char32_t>(random.Chance(50) ?
+                                                      random.Range(0x800,
+                                                                   0xd7ff) :
+                                                      random.Range(0xe000,
+                                                                   0xfffd));
+                    break;
+
+                default:
+                    text += static_cast<char32_t>(random.Range(0x10000,
+                                                               0x10ffff));
+                    break;
+            }
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("Unknown corpus name");
+    }
+}
+
+} // namespace
+
+/*
+ *  CorpusNames()
+ *
+ *  Description:
+ *      Return the names of all of the corpora that may be generated.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The names of the corpora.
+ *
+ *  Comments:
+ *      None.
+ */
+const std::vector<std::string_view> &CorpusNames()
+{
+    static const std::vector<std::string_view> names =
+    {
+        "ascii",
+        "latin",
+        "cyrillic",
+        "cjk",
+        "emoji",
+        "adversarial"
+    };
+
+    return names;
+}
+
+/*
+ *  GenerateCorpus()
+ *
+ *  Description:
+ *      Generate the named corpus in UTF-8, UTF-16LE, and UTF-16BE.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the corpus, which is one of those returned by
+ *          CorpusNames().
+ *
+ *      size [in]
+ *          The maximum length of the UTF-8 text in octets.  The text will be
+ *          no more than three octets shorter.
+ *
+ *      seed [in]
+ *          The seed for the pseudo-random sequence.
+ *
+ *  Returns:
+ *      The generated corpus.
+ *
+ *  Comments:
+ *      An exception is thrown if the name is not known.
+ */
+Corpus GenerateCorpus(std::string_view name,
+                      std::size_t size,
+                      std::uint64_t seed)
+{
+    Random random(seed);
+    Corpus corpus{std::string(name), {}, {}, {}, 0};
+    std::u32string text;
+
+    if (std::find(CorpusNames().begin(), CorpusNames().end(), name) ==
+        CorpusNames().end())
+    {
+        throw std::invalid_argument("Unknown corpus name");
+    }
+
+    // Generate text until the UTF-8 encoding reaches the requested size
+    corpus.utf8.reserve(size + 4);
+    while (corpus.utf8.size() < size)
+    {
+        text.clear();
+        NextWord(name, random, text);
+
+        for (char32_t character : text)
+        {
+            std::size_t length = corpus.utf8.size();
+
+            AppendUTF8(corpus.utf8, character);
+            if (corpus.utf8.size() > size)
+            {
+                corpus.utf8.resize(length);
+                break;
+            }
+            corpus.code_points++;
+        }
+
+        // Stop if the next character did not fit
+        if ((corpus.utf8.size() + 4) > size) break;
+    }
+
+    // Produce the UTF-16 encodings
+    for (bool little_endian : {true, false})
+    {
+        std::vector<std::uint8_t> &utf16 = little_endian ? corpus.utf16le :
+                                                           corpus.utf16be;
+        utf16.resize(corpus.utf8.size() * 2);
+        auto [result, length] =
+            ConvertUTF8ToUTF16(corpus.utf8, utf16, little_endian);
+        if (!result) throw std::logic_error("Generated invalid UTF-8");
+        utf16.resize(length);
+    }
+
+    return corpus;
+}
+
+} // namespace Terra::CharUtil::Bench
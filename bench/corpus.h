@@ -0,0 +1,60 @@
+/*
+ *  corpus.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Definitions for a generator that synthesizes text used to measure
+ *      the performance of the library.  Text is produced from a seeded
+ *      pseudo-random sequence, so the same seed always produces the same
+ *      text on every platform.  Each corpus has a distinct mix of scripts:
+ *
+ *          ascii       - English-like words of ASCII letters and punctuation
+ *          latin       - Latin text where some letters carry accents
+ *          cyrillic    - Words of Cyrillic letters separated by ASCII spaces
+ *          cjk         - CJK ideographs with CJK punctuation
+ *          emoji       - Mostly emoji (surrogate pairs in UTF-16)
+ *          adversarial - Characters of randomly alternating encoded length
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Terra::CharUtil::Bench
+{
+
+// The seed used when none is specified
+constexpr std::uint64_t Default_Corpus_Seed = 0x5eed'c0de'2024'0001;
+
+// Generated text in each encoding
+struct Corpus
+{
+    std::string name;
+    std::vector<std::uint8_t> utf8;
+    std::vector<std::uint8_t> utf16le;
+    std::vector<std::uint8_t> utf16be;
+    std::size_t code_points;
+};
+
+// Return the names of all of the corpora that may be generated
+const std::vector<std::string_view> &CorpusNames();
+
+// Generate the named corpus with a UTF-8 length of at most the given size
+Corpus GenerateCorpus(std::string_view name,
+                      std::size_t size,
+                      std::uint64_t seed = Default_Corpus_Seed);
+
+} // namespace Terra::CharUtil::Bench
@@ -9,8 +9,9 @@
  *      Paul E. Jones <paulej@packetizer.com>
  *
  *  Description:
- *      Utility functions to assist in converting between UTF-8 and UTF-16
- *      (either little endian or big endian).
+ *      Utility functions to assist in converting between UTF-8, UTF-16, and
+ *      UTF-32 (either little endian or big endian), and between those and
+ *      Latin-1 (ISO-8859-1).
  *
  *  Portability Issues:
  *      None.
@@ -18,8 +19,14 @@
 
 #pragma once
 
+#include <bit>
 #include <span>
 #include <utility>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
 #include <cstdint>
 #include <cstddef>
 #include <limits>
@@ -48,6 +55,44 @@ constexpr std::size_t Max_UTF16_String =
     (((std::numeric_limits<std::size_t>::max() >>
         ((sizeof(std::size_t) * CHAR_BIT) >> 1)) << 1) / 3);
 
+// Reason a UTF-8 or UTF-16 string was found to be invalid
+enum class UnicodeError
+{
+    None,                                       // No error
+    TruncatedSequence,                          // Sequence ends prematurely
+    InvalidLeadOctet,                           // Octet cannot begin a sequence
+    Overlong,                                   // Overlong UTF-8 encoding
+    Surrogate,                                  // UTF-8 encodes a surrogate
+    OutOfRange,                                 // Character above 0x10ffff
+    UnpairedSurrogate                           // UTF-16 surrogate not paired
+};
+
+// Result of a conversion that may consume only part of the input
+struct ConversionResult
+{
+    bool success;                               // False if input is invalid
+    std::size_t consumed;                       // Input octets consumed
+    std::size_t produced;                       // Output octets produced
+    UnicodeError error{UnicodeError::None};     // Reason for any failure
+};
+
+// Result of validating a string
+struct ValidationResult
+{
+    UnicodeError error;                         // Reason for any failure
+    std::size_t position;                       // Offset of invalid sequence
+};
+
+// Result of validating and measuring a UTF-8 string
+struct UTF8Measurement
+{
+    bool valid;                                 // False if input is invalid
+    bool ascii;                                 // True if only ASCII
+    std::size_t code_points;                    // Number of code points
+    std::size_t utf16_length;                   // Octets required as UTF-16
+    UnicodeError error{UnicodeError::None};     // Reason for any failure
+};
+
 /*
  *  ConvertUTF8ToUTF16()
  *
@@ -76,9 +121,256 @@ constexpr std::size_t Max_UTF16_String =
  *      UTF-16 output span.
  *
  *  Comments:
- *      None.
+ *      To learn where and why the conversion failed, call
+ *      ConvertUTF8ToUTF16Partial() instead.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out,
+    bool little_endian);
+
+/*
+ *  ConvertUTF8ToUTF16<Endian>()
+ *
+ *  Description:
+ *      This function is the same as ConvertUTF8ToUTF16() above, except that
+ *      the byte order of the UTF-16 output is given as a template parameter
+ *      rather than tested at run time.
+ *
+ *  Parameters:
+ *      Endian [template]
+ *          Either std::endian::little or std::endian::big.
+ *
+ *      in [in]
+ *          As for ConvertUTF8ToUTF16() above.
+ *
+ *      out [out]
+ *          As for ConvertUTF8ToUTF16() above.
+ *
+ *  Returns:
+ *      As for ConvertUTF8ToUTF16() above.
+ *
+ *  Comments:
+ *      Since the byte order is fixed at compile time, each instantiation
+ *      has no per-character test of the byte order.  The function taking a
+ *      boolean calls one of these instantiations.
  */
+template<std::endian Endian>
 std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out);
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and convert it to a string of
+ *      UTF-16 code units in the host's byte order, as held by a
+ *      std::u16string.  This function will not insert a byte-order-mark
+ *      (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format (e.g., a std::u8string_view).
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST have at least as many code units as the input has octets,
+ *          though the encoding length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of code units (not octets!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      The code units are written directly into the output span, so no
+ *      intermediate octet buffer or copy is required.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16(std::span<const char8_t> in,
+                                                std::span<char16_t> out);
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and return
+ *      a newly allocated vector holding the UTF-16 octets.  This function
+ *      will not insert byte-order-mark (BOM) octets.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The UTF-16 octets, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so the vector
+ *      is allocated once with exactly the required length.
+ */
+std::optional<std::vector<std::uint8_t>> ConvertUTF8ToUTF16(
+    std::span<const std::uint8_t> in,
+    bool little_endian);
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and return a newly allocated
+ *      UTF-16 string in the host's byte order.  This function will not insert
+ *      a byte-order-mark (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *  Returns:
+ *      The UTF-16 string, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so the string
+ *      is allocated once with exactly the required length.
+ */
+std::optional<std::u16string> ConvertUTF8ToUTF16(std::string_view in);
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and return a UTF-16 string in
+ *      the host's byte order, allocated from the given memory resource.  This
+ *      function will not insert a byte-order-mark (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      resource [in]
+ *          The memory resource from which to allocate the UTF-16 string.
+ *
+ *  Returns:
+ *      The UTF-16 string, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so one
+ *      allocation of exactly the required length is made from the resource.
+ */
+std::optional<std::pmr::u16string> ConvertUTF8ToUTF16(
+    std::string_view in,
+    std::pmr::memory_resource *resource);
+
+/*
+ *  ConvertUTF8ToUTF16Partial()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  This function
+ *      will not insert byte-order-mark (BOM) octets.  The endianness is
+ *      specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The span into which the UTF-16 string is written.  This may be
+ *          of any size.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid sequence begins and the error indicates why it is
+ *      invalid.  In either case, the number of octets produced is the length
+ *      of the valid UTF-16 output written.
+ *
+ *  Comments:
+ *      A character is never split, so the input consumed always ends on a
+ *      character boundary.  An incomplete sequence at the end of the input
+ *      is an error.
+ */
+ConversionResult ConvertUTF8ToUTF16Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out,
+                                           bool little_endian);
+
+/*
+ *  ConvertUTF8ToUTF16Partial<Endian>()
+ *
+ *  Description:
+ *      This function is the same as ConvertUTF8ToUTF16Partial() above, except
+ *      that the byte order of the UTF-16 output is given as a template
+ *      parameter rather than tested at run time.
+ *
+ *  Parameters:
+ *      Endian [template]
+ *          Either std::endian::little or std::endian::big.
+ *
+ *      in [in]
+ *          As for ConvertUTF8ToUTF16Partial() above.
+ *
+ *      out [out]
+ *          As for ConvertUTF8ToUTF16Partial() above.
+ *
+ *  Returns:
+ *      As for ConvertUTF8ToUTF16Partial() above.
+ *
+ *  Comments:
+ *      Since the byte order is fixed at compile time, each instantiation
+ *      has no per-character test of the byte order.  The function taking a
+ *      boolean calls one of these instantiations.
+ */
+template<std::endian Endian>
+ConversionResult ConvertUTF8ToUTF16Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out);
+
+/*
+ *  ConvertUTF8ToUTF16Lossy()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format, replacing each ill-formed subsequence with the
+ *      replacement character U+FFFD rather than failing.  This function will
+ *      not insert byte-order-mark (BOM) octets.  The endianness is specified
+ *      via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format, which need not be valid.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets (not characters!) in the resulting UTF-16 output
+ *      span.
+ *
+ *  Comments:
+ *      Ill-formed subsequences are replaced following the "maximal subpart"
+ *      practice described in Section 3.9 of the Unicode Standard: each
+ *      maximal prefix of a valid sequence, or each octet that cannot begin
+ *      one, yields a single U+FFFD.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16Lossy(
     std::span<const std::uint8_t> in,
     std::span<std::uint8_t> out,
     bool little_endian);
@@ -121,7 +413,8 @@ std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
  *      UTF-8 output span.
  *
  *  Comments:
- *      None.
+ *      To learn where and why the conversion failed, call
+ *      ConvertUTF16ToUTF8Partial() instead.
  */
 std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
                                             std::span<const std::uint8_t> in,
@@ -129,28 +422,699 @@ std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
                                             bool little_endian);
 
 /*
- *  IsUTF8Valid()
+ *  ConvertUTF16ToUTF8<Endian>()
  *
  *  Description:
- *      This function will process the sequence of octets and verify that it
- *      is a valid UTF-8 sequence.  By "valid", it means the sequence of
- *      octets conform to the encoding described in IETF RFC 3629.
+ *      This function is the same as ConvertUTF16ToUTF8() above, except that
+ *      the byte order of the UTF-16 input is given as a template parameter
+ *      rather than tested at run time.
  *
  *  Parameters:
- *      octets [in]
- *          The sequence of octets to process.
+ *      Endian [template]
+ *          Either std::endian::little or std::endian::big.
+ *
+ *      in [in]
+ *          As for ConvertUTF16ToUTF8() above.
+ *
+ *      out [out]
+ *          As for ConvertUTF16ToUTF8() above.
  *
  *  Returns:
- *      True if the octet sequence is a valid UTF-8 sequence or false otherwise.
+ *      As for ConvertUTF16ToUTF8() above.
  *
  *  Comments:
- *      This  does not ensure that the arrangement of a sequence of Unicode code
- *      points have a valid meaning or would result in the rendering of a
- *      character.  For example, while a Zero Width Joiner (ZWJ) can be used to
- *      join two or more code points to produce a single, visible character on
- *      the screen, this function makes no attempt to verify that such sequences
- *      make sense.
+ *      Since the byte order is fixed at compile time, each instantiation
+ *      has no per-character test of the byte order.  The function taking a
+ *      boolean calls one of these instantiations.
  */
-bool IsUTF8Valid(std::span<const std::uint8_t> octets);
+template<std::endian Endian>
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out);
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a string of UTF-16 code units in the host's
+ *      byte order, as held by a std::u16string, and convert it to UTF-8.
+ *      The UTF-16 string must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string (e.g., a std::u16string_view).
+ *          The number of code units must not be greater than half of
+ *          Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST have at least three octets for each input code unit, though
+ *          the encoding length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      The code units are read directly from the input span, so no
+ *      intermediate octet buffer or copy is required.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8(std::span<const char16_t> in,
+                                                std::span<char8_t> out);
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and return
+ *      a newly allocated vector holding the UTF-8 octets.  The UTF-16 octets
+ *      must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The UTF-8 octets, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so the vector
+ *      is allocated once with exactly the required length.
+ */
+std::optional<std::vector<std::uint8_t>> ConvertUTF16ToUTF8(
+    std::span<const std::uint8_t> in,
+    bool little_endian);
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a UTF-16 string in the host's byte order and
+ *      return a newly allocated UTF-8 string.  The UTF-16 string must NOT
+ *      have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *  Returns:
+ *      The UTF-8 string, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so the string
+ *      is allocated once with exactly the required length.
+ */
+std::optional<std::string> ConvertUTF16ToUTF8(std::u16string_view in);
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a UTF-16 string in the host's byte order and
+ *      return a UTF-8 string allocated from the given memory resource.  The
+ *      UTF-16 string must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      resource [in]
+ *          The memory resource from which to allocate the UTF-8 string.
+ *
+ *  Returns:
+ *      The UTF-8 string, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      The length of the output is computed before converting, so one
+ *      allocation of exactly the required length is made from the resource.
+ */
+std::optional<std::pmr::string> ConvertUTF16ToUTF8(
+    std::u16string_view in,
+    std::pmr::memory_resource *resource);
+
+/*
+ *  ConvertUTF16ToUTF8Partial()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  The UTF-16
+ *      octets must NOT have a byte-order-mark (BOM) at the start.  The
+ *      endianness is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The span into which the UTF-8 string is written.  This may be of
+ *          any size.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid character begins and the error indicates why it is
+ *      invalid.  In either case, the number of octets produced is the length
+ *      of the valid UTF-8 output written.
+ *
+ *  Comments:
+ *      A surrogate pair is never split, so the input consumed always ends on
+ *      a character boundary.  An unpaired surrogate or an odd octet at the
+ *      end of the input is an error.
+ */
+ConversionResult ConvertUTF16ToUTF8Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out,
+                                           bool little_endian);
+
+/*
+ *  ConvertUTF16ToUTF8Partial<Endian>()
+ *
+ *  Description:
+ *      This function is the same as ConvertUTF16ToUTF8Partial() above, except
+ *      that the byte order of the UTF-16 input is given as a template
+ *      parameter rather than tested at run time.
+ *
+ *  Parameters:
+ *      Endian [template]
+ *          Either std::endian::little or std::endian::big.
+ *
+ *      in [in]
+ *          As for ConvertUTF16ToUTF8Partial() above.
+ *
+ *      out [out]
+ *          As for ConvertUTF16ToUTF8Partial() above.
+ *
+ *  Returns:
+ *      As for ConvertUTF16ToUTF8Partial() above.
+ *
+ *  Comments:
+ *      Since the byte order is fixed at compile time, each instantiation
+ *      has no per-character test of the byte order.  The function taking a
+ *      boolean calls one of these instantiations.
+ */
+template<std::endian Endian>
+ConversionResult ConvertUTF16ToUTF8Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out);
+
+/*
+ *  ConvertUTF16ToUTF8Lossy()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format, replacing each unpaired surrogate (and an odd
+ *      final octet) with the replacement character U+FFFD rather than
+ *      failing.  The UTF-16 octets must NOT have a byte-order-mark (BOM) at
+ *      the start.  The endianness is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string, which need not be valid.  The
+ *          length must not be greater than Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string, plus
+ *          three octets if the input length is odd.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      input is too long or the output span is too small.  On success, the
+ *      length value indicates the number of octets (not characters!) in the
+ *      resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8Lossy(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertUTF8ToUTF32()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-32 format.  This function will not insert byte-order-mark
+ *      (BOM) octets.  The endianness is specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-32 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 4x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-32 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF32(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertUTF32ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-32 format and convert
+ *      them to UTF-8 format.  The UTF-32 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness is indicated
+ *      via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-32 string.  The length must be a multiple
+ *          of four octets.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-32 string.  This span
+ *          MUST be at least as large as the input span, since no character
+ *          requires more than four octets when encoded as UTF-8.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-32 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      Surrogates and values above 0x10ffff are rejected.
+ */
+std::pair<bool, std::size_t> ConvertUTF32ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertUTF16ToUTF32()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-32 format.  The UTF-16 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness of both the input
+ *      and the output is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The UTF-32 string derived from the given UTF-16 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 and UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-32 output span.
+ *
+ *  Comments:
+ *      An unpaired surrogate or an odd octet at the end of the input is an
+ *      error.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF32(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertUTF32ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-32 format and convert
+ *      them to UTF-16 format.  The UTF-32 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness of both the input
+ *      and the output is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-32 string.  The length must be a multiple
+ *          of four octets.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-32 string.  This span
+ *          MUST be at least as large as the input span, since characters
+ *          outside of the Basic Multilingual Plane (BMP) are encoded as
+ *          surrogate pairs of the same length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 and UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-32 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      Surrogates and values above 0x10ffff are rejected.
+ */
+std::pair<bool, std::size_t> ConvertUTF32ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertLatin1ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in Latin-1 (ISO-8859-1)
+ *      format and convert them to UTF-8 format.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in Latin-1 format.  Every octet value is valid.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given Latin-1 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets in the resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertLatin1ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out);
+
+/*
+ *  ConvertUTF8ToLatin1()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to Latin-1 (ISO-8859-1) format.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The Latin-1 string derived from the given UTF-8 string.  This span
+ *          MUST be at least as large as the input span, though the encoding
+ *          length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting Latin-1 output span.
+ *
+ *  Comments:
+ *      The conversion fails if the input is not valid UTF-8 or if it contains
+ *      a character above 0xff, which cannot be represented in Latin-1.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToLatin1(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out);
+
+/*
+ *  ConvertLatin1ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in Latin-1 (ISO-8859-1)
+ *      format and convert them to UTF-16 format.  This function will not
+ *      insert byte-order-mark (BOM) octets.  The endianness is specified via
+ *      the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in Latin-1 format.  Every octet value is valid.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given Latin-1 string.  This span
+ *          MUST be at least 2x larger than the input span.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets (not characters!) in the resulting UTF-16 output
+ *      span, which is always twice the input length.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertLatin1ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  ConvertUTF16ToLatin1()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to Latin-1 (ISO-8859-1) format.  The UTF-16 octets must NOT have
+ *      a byte-order-mark (BOM) at the start.  The endianness is indicated via
+ *      the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The Latin-1 string derived from the given UTF-16 string.  This span
+ *          MUST be at least half the length of the input span.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting Latin-1 output span,
+ *      which is always half the input length.
+ *
+ *  Comments:
+ *      The conversion fails if the input has an odd length or if it contains
+ *      a character above 0xff (including any surrogate), which cannot be
+ *      represented in Latin-1.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToLatin1(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian);
+
+/*
+ *  IsUTF8Valid()
+ *
+ *  Description:
+ *      This function will process the sequence of octets and verify that it
+ *      is a valid UTF-8 sequence.  By "valid", it means the sequence of
+ *      octets conform to the encoding described in IETF RFC 3629, which
+ *      excludes overlong encodings, surrogates, and values above 0x10ffff.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      True if the octet sequence is a valid UTF-8 sequence or false otherwise.
+ *
+ *  Comments:
+ *      This  does not ensure that the arrangement of a sequence of Unicode code
+ *      points have a valid meaning or would result in the rendering of a
+ *      character.  For example, while a Zero Width Joiner (ZWJ) can be used to
+ *      join two or more code points to produce a single, visible character on
+ *      the screen, this function makes no attempt to verify that such sequences
+ *      make sense.
+ */
+bool IsUTF8Valid(std::span<const std::uint8_t> octets);
+
+/*
+ *  ValidateUTF8()
+ *
+ *  Description:
+ *      This function will process the sequence of octets and verify that it
+ *      is a valid UTF-8 sequence as IsUTF8Valid() does, additionally
+ *      reporting where and why the sequence is invalid.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      The result of the validation.  If the sequence is valid, the error is
+ *      UnicodeError::None and the position is the length of the sequence.
+ *      Otherwise, the position is the offset of the first octet of the
+ *      invalid sequence.
+ *
+ *  Comments:
+ *      The error is located in the same pass over the input, so this is no
+ *      more costly than IsUTF8Valid().
+ */
+ValidationResult ValidateUTF8(std::span<const std::uint8_t> octets);
+
+/*
+ *  UTF16LengthFromUTF8()
+ *
+ *  Description:
+ *      This function will compute the number of octets required to encode
+ *      the given UTF-8 string as UTF-16.  This allows the caller to allocate
+ *      an output buffer of exactly the required size.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string to measure.
+ *
+ *  Returns:
+ *      The length in octets (not characters!) of the UTF-16 encoding of the
+ *      given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-8 (see IsUTF8Valid()).  Note that the output span
+ *      given to ConvertUTF8ToUTF16() must still be at least 2x the length
+ *      of the input span.
+ */
+std::size_t UTF16LengthFromUTF8(std::span<const std::uint8_t> in);
+
+/*
+ *  UTF8LengthFromUTF16()
+ *
+ *  Description:
+ *      This function will compute the number of octets required to encode
+ *      the given UTF-16 string as UTF-8.  This allows the caller to allocate
+ *      an output buffer of exactly the required size.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string to measure.  An odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length in octets (not characters!) of the UTF-8 encoding of the
+ *      given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-16 (i.e., all surrogates are properly paired).
+ *      Note that the output span given to ConvertUTF16ToUTF8() must still be
+ *      at least 1.5x the length of the input span.
+ */
+std::size_t UTF8LengthFromUTF16(std::span<const std::uint8_t> in,
+                                bool little_endian);
+
+/*
+ *  CountUTF8CodePoints()
+ *
+ *  Description:
+ *      This function will count the number of code points (characters) in
+ *      the given UTF-8 string without producing any output.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string to count.
+ *
+ *  Returns:
+ *      The number of code points in the given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-8 (see IsUTF8Valid()).  Every octet other than a
+ *      continuation octet is counted.
+ */
+std::size_t CountUTF8CodePoints(std::span<const std::uint8_t> in);
+
+/*
+ *  CountUTF16CodePoints()
+ *
+ *  Description:
+ *      This function will count the number of code points (characters) in
+ *      the given UTF-16 string without producing any output.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string to count.  An odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points in the given string, where a surrogate
+ *      pair is counted as a single code point.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-16 (i.e., all surrogates are properly paired).
+ *      Every code unit other than a low surrogate is counted.
+ */
+std::size_t CountUTF16CodePoints(std::span<const std::uint8_t> in,
+                                 bool little_endian);
+
+/*
+ *  MeasureUTF8()
+ *
+ *  Description:
+ *      This function will verify that the given sequence of octets is a
+ *      valid UTF-8 sequence as IsUTF8Valid() does and, in the same pass over
+ *      the input, count the code points, compute the number of octets
+ *      required to encode the string as UTF-16, and determine whether the
+ *      string contains only ASCII characters.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      The measurement of the string.  If the string is not valid UTF-8,
+ *      valid is false, error indicates the reason, and the remaining values
+ *      are zero.
+ *
+ *  Comments:
+ *      This produces the same results as calling IsUTF8Valid(),
+ *      CountUTF8CodePoints(), and UTF16LengthFromUTF8() in turn, but the
+ *      input is processed in blocks small enough to remain in the processor
+ *      cache, so the input is read from memory only once.
+ */
+UTF8Measurement MeasureUTF8(std::span<const std::uint8_t> octets);
 
 } // namespace Terra::CharUtil
@@ -0,0 +1,516 @@
+/*
+ *  constexpr_utilities.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header-only implementations of IsUTF8Valid(), ConvertUTF8ToUTF16(),
+ *      and ConvertUTF16ToUTF8() that may be evaluated at compile time.  These
+ *      allow string literals and other constant data to be validated or
+ *      converted when compiling, such as when producing static lookup tables.
+ *
+ *      The functions accept and produce the same results as the functions of
+ *      the same name in character_utilities.h, but they process one character
+ *      at a time and do not use SIMD instructions.  At run time, the functions
+ *      in character_utilities.h should be preferred.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <span>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "character_utilities.h"
+
+namespace Terra::CharUtil::Constexpr
+{
+
+namespace Detail
+{
+
+/*
+ *  DecodeUTF8()
+ *
+ *  Description:
+ *      Decode the UTF-8 character at the start of the given span.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets, which may be std::uint8_t or char8_t values.
+ *
+ *      character [out]
+ *          The decoded character.
+ *
+ *  Returns:
+ *      The length of the sequence, or zero if the octets at the start of the
+ *      span are not a well-formed UTF-8 sequence.
+ *
+ *  Comments:
+ *      Well-formed sequences are those defined in Table 3-7 of the Unicode
+ *      Standard, so overlong encodings, surrogates, and values above 0x10ffff
+ *      are all rejected.
+ */
+template<typename Octet>
+constexpr std::size_t DecodeUTF8(std::span<const Octet> in,
+                                 std::uint32_t &character)
+{
+    std::uint8_t lead = static_cast<std::uint8_t>(in[0]);
+    std::size_t length{};
+    std::uint8_t lower = 0x80;                  // Bounds of second octet
+    std::uint8_t upper = 0xbf;
+
+    // Handle the most common case first
+    if (lead < 0x80)
+    {
+        character = lead;
+        return 1;
+    }
+
+    // Determine the sequence length and the range of the second octet
+    if ((lead >= 0xc2) && (lead <= 0xdf))
+    {
+        length = 2;
+        character = lead & 0x1f;
+    }
+    else if ((lead >= 0xe0) && (lead <= 0xef))
+    {
+        length = 3;
+        character = lead & 0x0f;
+        if (lead == 0xe0) lower = 0xa0;
+        if (lead == 0xed) upper = 0x9f;
+    }
+    else if ((lead >= 0xf0) && (lead <= 0xf4))
+    {
+        length = 4;
+        character = lead & 0x07;
+        if (lead == 0xf0) lower = 0x90;
+        if (lead == 0xf4) upper = 0x8f;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (in.size() < length) return 0;
+
+    // Accumulate the continuation octets
+    for (std::size_t i = 1; i < length; i++)
+    {
+        std::uint8_t octet = static_cast<std::uint8_t>(in[i]);
+
+        if ((octet < lower) || (octet > upper)) return 0;
+        character = (character << 6) | (octet & 0x3f);
+
+        // Only the second octet has a restricted range
+        lower = 0x80;
+        upper = 0xbf;
+    }
+
+    return length;
+}
+
+/*
+ *  UTF8ToUTF16()
+ *
+ *  Description:
+ *      Convert the given UTF-8 string to UTF-16 code units, passing each
+ *      code unit to the given function to store.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      store [in]
+ *          A function taking the index and value of each code unit to store.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  On success, the length value
+ *      indicates the number of code units stored.
+ *
+ *  Comments:
+ *      The caller must ensure there is space for as many code units as the
+ *      input has octets.
+ */
+template<typename Octet, typename Store>
+constexpr std::pair<bool, std::size_t> UTF8ToUTF16(std::span<const Octet> in,
+                                                   Store store)
+{
+    std::size_t produced{};
+
+    for (std::size_t i = 0; i < in.size();)
+    {
+        std::uint32_t character{};
+        std::size_t length = DecodeUTF8(in.subspan(i), character);
+
+        if (length == 0) return {false, 0};
+        i += length;
+
+        // Characters beyond the BMP are stored as a surrogate pair
+        if (character > 0xffff)
+        {
+            character -= 0x10000;
+            store(produced++,
+                  static_cast<std::uint16_t>(0xd800 + (character >> 10)));
+            store(produced++,
+                  static_cast<std::uint16_t>(0xdc00 + (character & 0x3ff)));
+        }
+        else
+        {
+            store(produced++, static_cast<std::uint16_t>(character));
+        }
+    }
+
+    return {true, produced};
+}
+
+/*
+ *  UTF16ToUTF8()
+ *
+ *  Description:
+ *      Convert a UTF-16 string, read one code unit at a time via the given
+ *      function, to UTF-8.
+ *
+ *  Parameters:
+ *      units [in]
+ *          The number of UTF-16 code units in the input string.
+ *
+ *      load [in]
+ *          A function taking an index and returning that code unit.
+ *
+ *      out [out]
+ *          The span into which the UTF-8 string is written.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  On success, the length value
+ *      indicates the number of octets written.
+ *
+ *  Comments:
+ *      The caller must ensure there is space for three octets per code unit.
+ */
+template<typename Load, typename Octet>
+constexpr std::pair<bool, std::size_t> UTF16ToUTF8(std::size_t units,
+                                                   Load load,
+                                                   std::span<Octet> out)
+{
+    std::size_t produced{};
+
+    for (std::size_t i = 0; i < units; i++)
+    {
+        std::uint32_t character = load(i);
+
+        // A high surrogate must be followed by a low surrogate
+        if ((character >= 0xd800) && (character <= 0xdbff))
+        {
+            if (++i >= units) return {false, 0};
+            std::uint32_t low_surrogate = load(i);
+            if ((low_surrogate < 0xdc00) || (low_surrogate > 0xdfff))
+            {
+                return {false, 0};
+            }
+            character = 0x10000 + ((character - 0xd800) << 10) +
+                        (low_surrogate - 0xdc00);
+        }
+        else if ((character >= 0xdc00) && (character <= 0xdfff))
+        {
+            return {false, 0};
+        }
+
+        // Encode the character
+        if (character < 0x80)
+        {
+            out[produced++] = static_cast<Octet>(character);
+        }
+        else if (character < 0x800)
+        {
+            out[produced++] = static_cast<Octet>(0xc0 | (character >> 6));
+            out[produced++] = static_cast<Octet>(0x80 | (character & 0x3f));
+        }
+        else if (character < 0x10000)
+        {
+            out[produced++] = static_cast<Octet>(0xe0 | (character >> 12));
+            out[produced++] =
+                static_cast<Octet>(0x80 | ((character >> 6) & 0x3f));
+            out[produced++] = static_cast<Octet>(0x80 | (character & 0x3f));
+        }
+        else
+        {
+            out[produced++] = static_cast<Octet>(0xf0 | (character >> 18));
+            out[produced++] =
+                static_cast<Octet>(0x80 | ((character >> 12) & 0x3f));
+            out[produced++] =
+                static_cast<Octet>(0x80 | ((character >> 6) & 0x3f));
+            out[produced++] = static_cast<Octet>(0x80 | (character & 0x3f));
+        }
+    }
+
+    return {true, produced};
+}
+
+} // namespace Detail
+
+/*
+ *  IsUTF8Valid()
+ *
+ *  Description:
+ *      This function will check to see if the given span of octets is a
+ *      valid UTF-8 string.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The span of octets to check.
+ *
+ *  Returns:
+ *      True if the string is valid UTF-8, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr bool IsUTF8Valid(std::span<const std::uint8_t> octets)
+{
+    for (std::size_t i = 0; i < octets.size();)
+    {
+        std::uint32_t character{};
+        std::size_t length = Detail::DecodeUTF8(octets.subspan(i), character);
+
+        if (length == 0) return false;
+        i += length;
+    }
+
+    return true;
+}
+
+/*
+ *  IsUTF8Valid()
+ *
+ *  Description:
+ *      This function will check to see if the given UTF-8 string is valid.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The string to check (e.g., a std::u8string_view).
+ *
+ *  Returns:
+ *      True if the string is valid UTF-8, false if not.
+ *
+ *  Comments:
+ *      Note that a span constructed from a string literal includes the
+ *      terminating null character, so a std::u8string_view should be given
+ *      instead.
+ */
+constexpr bool IsUTF8Valid(std::span<const char8_t> text)
+{
+    for (std::size_t i = 0; i < text.size();)
+    {
+        std::uint32_t character{};
+        std::size_t length = Detail::DecodeUTF8(text.subspan(i), character);
+
+        if (length == 0) return false;
+        i += length;
+    }
+
+    return true;
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format.  This function will not insert byte-order-mark
+ *      (BOM) octets.  The endianness is specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out,
+    bool little_endian)
+{
+    // Ensure the output span is sufficiently large
+    if (out.size() < (in.size() * 2)) return {false, 0};
+
+    auto [result, length] = Detail::UTF8ToUTF16(
+        in,
+        [&](std::size_t i, std::uint16_t code_unit)
+        {
+            std::uint8_t high = static_cast<std::uint8_t>(code_unit >> 8);
+            std::uint8_t low = static_cast<std::uint8_t>(code_unit & 0xff);
+
+            out[i * 2] = little_endian ? low : high;
+            out[i * 2 + 1] = little_endian ? high : low;
+        });
+    if (!result) return {false, 0};
+
+    return {true, length * 2};
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and convert it to a string of
+ *      UTF-16 code units, as held by a std::u16string.  This function will
+ *      not insert a byte-order-mark (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format (e.g., a std::u8string_view).
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST have at least as many code units as the input has octets,
+ *          though the encoding length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of code units (not octets!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+    std::span<const char8_t> in,
+    std::span<char16_t> out)
+{
+    // Ensure the output span is sufficiently large
+    if (out.size() < in.size()) return {false, 0};
+
+    auto [result, length] = Detail::UTF8ToUTF16(
+        in,
+        [&](std::size_t i, std::uint16_t code_unit)
+        {
+            out[i] = static_cast<char16_t>(code_unit);
+        });
+    if (!result) return {false, 0};
+
+    return {true, length};
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format.  The UTF-16 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness is indicated
+ *      via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.  The length must not be greater
+ *          than Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out,
+    bool little_endian)
+{
+    // The input must be a whole number of code units and the output span
+    // must be sufficiently large
+    if ((in.size() & 1) != 0) return {false, 0};
+    if (in.size() > Max_UTF16_String) return {false, 0};
+    if (out.size() < (in.size() + in.size() / 2)) return {false, 0};
+
+    return Detail::UTF16ToUTF8(
+        in.size() / 2,
+        [&](std::size_t i) -> std::uint32_t
+        {
+            std::uint32_t first = in[i * 2];
+            std::uint32_t second = in[i * 2 + 1];
+
+            return little_endian ? ((second << 8) | first) :
+                                   ((first << 8) | second);
+        },
+        out);
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a string of UTF-16 code units, as held by a
+ *      std::u16string, and convert it to UTF-8.  The string must NOT have a
+ *      byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string (e.g., a std::u16string_view).
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST have at least three octets for each input code unit.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
+    std::span<const char16_t> in,
+    std::span<char8_t> out)
+{
+    // Ensure the output span is sufficiently large
+    if (in.size() > (out.size() / 3)) return {false, 0};
+
+    return Detail::UTF16ToUTF8(
+        in.size(),
+        [&](std::size_t i) -> std::uint32_t { return in[i]; },
+        out);
+}
+
+} // namespace Terra::CharUtil::Constexpr
@@ -0,0 +1,146 @@
+/*
+ *  parallel_utilities.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Functions that convert or validate very large strings using multiple
+ *      threads.  The input is split into chunks at character boundaries.
+ *      When converting, the length of each converted chunk is computed so
+ *      that the position of each chunk in the output is known, and then the
+ *      chunks are converted concurrently directly into the output span.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <span>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace Terra::CharUtil
+{
+
+// The minimum number of input octets given to each thread; inputs too short
+// to give at least two threads this many octets are processed on the calling
+// thread
+constexpr std::size_t Min_Parallel_Chunk = 64 * 1024;
+
+/*
+ *  ConvertUTF8ToUTF16Parallel()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format using multiple threads.  This function will not
+ *      insert byte-order-mark (BOM) octets.  The endianness is specified via
+ *      the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      The result is identical to that of ConvertUTF8ToUTF16().  If the
+ *      conversion fails, the contents of the output span are unspecified.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16Parallel(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out,
+    bool little_endian,
+    std::size_t threads = 0);
+
+/*
+ *  ConvertUTF16ToUTF8Parallel()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format using multiple threads.  The UTF-16 octets must
+ *      NOT have a byte-order-mark (BOM) at the start.  The endianness is
+ *      indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.  The length must not be greater
+ *          than Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      The result is identical to that of ConvertUTF16ToUTF8().  If the
+ *      conversion fails, the contents of the output span are unspecified.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8Parallel(
+    std::span<const std::uint8_t> in,
+    std::span<std::uint8_t> out,
+    bool little_endian,
+    std::size_t threads = 0);
+
+/*
+ *  IsUTF8ValidParallel()
+ *
+ *  Description:
+ *      This function will check to see if the given span of octets is a
+ *      valid UTF-8 string using multiple threads.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The span of octets to check.
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      True if the string is valid UTF-8, false if not.
+ *
+ *  Comments:
+ *      The result is identical to that of IsUTF8Valid().  All threads stop
+ *      shortly after any thread finds an invalid sequence.
+ */
+bool IsUTF8ValidParallel(std::span<const std::uint8_t> octets,
+                         std::size_t threads = 0);
+
+} // namespace Terra::CharUtil
@@ -0,0 +1,49 @@
+/*
+ *  utf16_to_utf8_converter.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines an object that will convert a stream of UTF-16
+ *      octets (either little endian or big endian) to UTF-8 as successive
+ *      chunks of the stream become available.  A character or surrogate pair
+ *      may be split across chunks at any octet.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include "character_utilities.h"
+
+namespace Terra::CharUtil
+{
+
+class UTF16ToUTF8Converter
+{
+    public:
+        UTF16ToUTF8Converter(bool little_endian);
+        ~UTF16ToUTF8Converter() = default;
+
+        ConversionResult Feed(std::span<const std::uint8_t> in,
+                              std::span<std::uint8_t> out);
+        bool Finish();
+        void Reset();
+
+    protected:
+        bool little_endian;
+        std::array<std::uint8_t, 4> pending;
+        std::size_t pending_length;
+};
+
+} // namespace Terra::CharUtil
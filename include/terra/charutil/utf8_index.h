@@ -0,0 +1,62 @@
+/*
+ *  utf8_index.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines an object that maps between code point positions
+ *      and octet offsets within a UTF-8 string without scanning the string
+ *      from the start.  The octet offset of every Nth code point (the
+ *      stride) is recorded in a single pass over the string, so that a
+ *      lookup examines at most one stride of the string.
+ *
+ *      The object refers to the string given to the constructor, which must
+ *      remain unchanged and in existence for as long as the object is used.
+ *      The string must be valid UTF-8 (see IsUTF8Valid() or MeasureUTF8()),
+ *      as results are otherwise meaningless.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Terra::CharUtil
+{
+
+class UTF8Index
+{
+    public:
+        // Code points between recorded offsets when none is specified
+        static constexpr std::size_t Default_Stride = 256;
+
+        UTF8Index(std::span<const std::uint8_t> text,
+                  std::size_t stride = Default_Stride);
+        ~UTF8Index() = default;
+
+        std::size_t CodePoints() const noexcept;
+        std::optional<std::size_t> OffsetOf(std::size_t position) const;
+        std::optional<std::size_t> PositionOf(std::size_t offset) const;
+        std::optional<std::span<const std::uint8_t>> Substring(
+                                                std::size_t position,
+                                                std::size_t count) const;
+
+    protected:
+        std::span<const std::uint8_t> text;
+        std::size_t stride;
+        std::size_t code_points;
+        std::vector<std::size_t> offsets;
+};
+
+} // namespace Terra::CharUtil
@@ -0,0 +1,49 @@
+/*
+ *  utf8_to_utf16_converter.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines an object that will convert a stream of UTF-8
+ *      octets to UTF-16 (either little endian or big endian) as successive
+ *      chunks of the stream become available.  A multi-octet character may
+ *      be split across chunks.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include "character_utilities.h"
+
+namespace Terra::CharUtil
+{
+
+class UTF8ToUTF16Converter
+{
+    public:
+        UTF8ToUTF16Converter(bool little_endian);
+        ~UTF8ToUTF16Converter() = default;
+
+        ConversionResult Feed(std::span<const std::uint8_t> in,
+                              std::span<std::uint8_t> out);
+        bool Finish();
+        void Reset();
+
+    protected:
+        bool little_endian;
+        std::array<std::uint8_t, 4> pending;
+        std::size_t pending_length;
+};
+
+} // namespace Terra::CharUtil
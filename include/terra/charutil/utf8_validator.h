@@ -0,0 +1,46 @@
+/*
+ *  utf8_validator.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file defines an object that will verify that a stream of octets
+ *      is valid UTF-8 as successive chunks of the stream become available.
+ *      A multi-octet character may be split across chunks.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+namespace Terra::CharUtil
+{
+
+class UTF8Validator
+{
+    public:
+        UTF8Validator();
+        ~UTF8Validator() = default;
+
+        bool Feed(std::span<const std::uint8_t> octets);
+        bool Finish();
+        void Reset();
+
+    protected:
+        bool valid;
+        std::array<std::uint8_t, 4> pending;
+        std::size_t pending_length;
+};
+
+} // namespace Terra::CharUtil
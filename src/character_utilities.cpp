@@ -9,8 +9,9 @@
  *      Paul E. Jones <paulej@packetizer.com>
  *
  *  Description:
- *      Utility functions to assist in converting between UTF-8 and UTF-16
- *      (either little endian or big endian).
+ *      Utility functions to assist in converting between UTF-8, UTF-16, and
+ *      UTF-32 (either little endian or big endian), and between those and
+ *      Latin-1 (ISO-8859-1).
  *
  *  Portability Issues:
  *      None.
@@ -18,7 +19,10 @@
 
 #include <limits>
 #include <algorithm>
+#include <bit>
 #include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
+#include "utf8_dfa.h"
 
 namespace Terra::CharUtil
 {
@@ -32,6 +36,9 @@ constexpr std::uint32_t Maximum_Character_Value = 0x10'ffff;
 // Maximum unicode character in the BMP
 constexpr std::uint32_t Maximum_BMP_Value = 0xffff;
 
+// Character substituted for ill-formed input by the lossy conversions
+constexpr std::uint16_t Replacement_Character = 0xfffd;
+
 // Surrogates are within the following range
 // (See: https://en.wikipedia.org/wiki/UTF-16#U+D800_to_U+DFFF_(surrogates))
 constexpr std::uint32_t Surrogate_High_Min = 0xd800;
@@ -52,6 +59,10 @@ constexpr std::uint32_t Surrogate_Offset = 0xfca0'2400;
 namespace
 {
 
+// Octets validated and measured at a time by MeasureUTF8(), which should be
+// small enough to remain in the processor's L1 data cache
+constexpr std::size_t Measurement_Block = 16 * 1024;
+
 /*
  *  InsertUTF16LE()
  *
@@ -156,364 +167,2169 @@ constexpr std::uint16_t ExtractUTF16BE(std::span<const std::uint8_t, 2> buffer)
            (static_cast<std::uint16_t>(buffer[1])     );
 }
 
-} // namespace
+/*
+ *  InsertUTF32LE()
+ *
+ *  Description:
+ *      This will take a UTF-32 charater and insert it into the specified buffer
+ *      in little endian order.
+ *
+ *  Parameters:
+ *      character [in]
+ *          The UTF-32 character to insert into the buffer.
+ *
+ *      buffer [out]
+ *          The buffer into which to write the character on little endian order.
+ *
+ *  Returns:
+ *      Nothing, though the buffer will be populated with the value of the
+ *      character in little endian order.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr void InsertUTF32LE(const std::uint32_t character,
+                             std::span<std::uint8_t, 4> buffer)
+{
+    buffer[0] = static_cast<uint8_t>(character & 0xff);
+    buffer[1] = static_cast<uint8_t>((character >> 8) & 0xff);
+    buffer[2] = static_cast<uint8_t>((character >> 16) & 0xff);
+    buffer[3] = static_cast<uint8_t>((character >> 24) & 0xff);
+}
 
 /*
- *  ConvertUTF8ToUTF16()
+ *  InsertUTF32BE()
  *
  *  Description:
- *      This function will take a span of octets in UTF-8 format and convert
- *      them to UTF-16 format.  This function will not insert byte-order-mark
- *      (BOM) octets.  The endianness is specified via the third parameter.
+ *      This will take a UTF-32 charater and insert it into the specified buffer
+ *      in big endian order.
  *
  *  Parameters:
- *      in [in]
- *          Original string in UTF-8 format.
+ *      character [in]
+ *          The UTF-32 character to insert into the buffer.
  *
- *      out [out]
- *          The UTF-16 string derived from the given UTF-8 string.  This span
- *          MUST be at least 2x larger than the input span, though the encoding
- *          length might be smaller.
+ *      buffer [out]
+ *          The buffer into which to write the character on big endian order.
  *
- *      little_endian [in]
- *          Store the UTF-16 characters in little endian order?
+ *  Returns:
+ *      Nothing, though the buffer will be populated with the value of the
+ *      character in big endian order.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr void InsertUTF32BE(const std::uint32_t character,
+                             std::span<std::uint8_t, 4> buffer)
+{
+    buffer[0] = static_cast<uint8_t>((character >> 24) & 0xff);
+    buffer[1] = static_cast<uint8_t>((character >> 16) & 0xff);
+    buffer[2] = static_cast<uint8_t>((character >> 8) & 0xff);
+    buffer[3] = static_cast<uint8_t>(character & 0xff);
+}
+
+/*
+ *  ExtractUTF32LE()
+ *
+ *  Description:
+ *      This will take extract a UTF-32 charater from the specified buffer
+ *      stored in little endian order.
+ *
+ *  Parameters:
+ *      buffer [in]
+ *          The buffer into which to read the character.
  *
  *  Returns:
- *      A boolean and length pair, where the boolean indicates success or
- *      failure to convert the UTF-8 string.  Only if the return result is true
- *      does the length value have meaning.  On success, the length value
- *      indicates the number of octets (not characters!) in the resulting
- *      UTF-16 output span.
+ *      The UTF-32 character extracted from the buffer.  The character is stored
+ *      is host order.
  *
  *  Comments:
  *      None.
  */
-std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
-                                            std::span<const std::uint8_t> in,
-                                            std::span<std::uint8_t> out,
-                                            bool little_endian)
+constexpr std::uint32_t ExtractUTF32LE(std::span<const std::uint8_t, 4> buffer)
 {
-    std::size_t expected_utf8_remaining{};      // Number of UTF-8 octets left
-    std::uint32_t wide_character{};             // UTF-32 character
+    return (static_cast<std::uint32_t>(buffer[3]) << 24) |
+           (static_cast<std::uint32_t>(buffer[2]) << 16) |
+           (static_cast<std::uint32_t>(buffer[1]) <<  8) |
+           (static_cast<std::uint32_t>(buffer[0])      );
+}
 
-    // If the input is zero length, so is the output
-    if (in.empty()) return {true, 0};
+/*
+ *  ExtractUTF32BE()
+ *
+ *  Description:
+ *      This will take extract a UTF-32 charater from the specified buffer
+ *      stored in big endian order.
+ *
+ *  Parameters:
+ *      buffer [in]
+ *          The buffer into which to read the character.
+ *
+ *  Returns:
+ *      The UTF-32 character extracted from the buffer.  The character is stored
+ *      is host order.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint32_t ExtractUTF32BE(std::span<const std::uint8_t, 4> buffer)
+{
+    return (static_cast<std::uint32_t>(buffer[0]) << 24) |
+           (static_cast<std::uint32_t>(buffer[1]) << 16) |
+           (static_cast<std::uint32_t>(buffer[2]) <<  8) |
+           (static_cast<std::uint32_t>(buffer[3])      );
+}
 
-    // If the output span is an insufficient size, return an error
-    if (out.size() < in.size() * 2) return {false, 0};
+/*
+ *  IsScalarValue()
+ *
+ *  Description:
+ *      Determine whether the given value is a Unicode scalar value, which is
+ *      any code point other than a surrogate.
+ *
+ *  Parameters:
+ *      character [in]
+ *          The value to check.
+ *
+ *  Returns:
+ *      True if the value may be encoded in any Unicode encoding form, false
+ *      otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr bool IsScalarValue(std::uint32_t character)
+{
+    return (character <= Unicode::Maximum_Character_Value) &&
+           ((character < Unicode::Surrogate_High_Min) ||
+            (character > Unicode::Surrogate_Low_Max));
+}
 
-    // Assign the output pointer
-    std::uint8_t *p = out.data();
+/*
+ *  ClassifyUTF8Error()
+ *
+ *  Description:
+ *      Determine why the UTF-8 sequence at the start of the given octets is
+ *      ill-formed.  This is called only once an error has been detected, so
+ *      the checks here do not affect the speed of processing valid input.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets beginning with the ill-formed sequence.  This must not
+ *          be empty.
+ *
+ *  Returns:
+ *      The reason the sequence is ill-formed.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr UnicodeError ClassifyUTF8Error(std::span<const std::uint8_t> octets)
+{
+    std::uint8_t lead = octets[0];
 
-    // Iterate over the UTF-8 string
-    for (std::uint8_t octet : in)
+    // Continuation octets and octets never used in UTF-8
+    if (((lead & 0xc0) == 0x80) || (lead >= 0xf8))
     {
-        // Handle subsequent UTF-8 octets
-        if (expected_utf8_remaining > 0)
+        return UnicodeError::InvalidLeadOctet;
+    }
+
+    // Lead octets that can only begin an overlong or out of range sequence
+    if (lead <= 0xc1) return UnicodeError::Overlong;
+    if (lead >= 0xf5) return UnicodeError::OutOfRange;
+
+    // Second octets that are continuation octets, but not valid ones
+    if (octets.size() >= 2)
+    {
+        std::uint8_t second = octets[1];
+
+        if ((lead == 0xe0) && (second >= 0x80) && (second <= 0x9f))
+        {
+            return UnicodeError::Overlong;
+        }
+        if ((lead == 0xf0) && (second >= 0x80) && (second <= 0x8f))
+        {
+            return UnicodeError::Overlong;
+        }
+        if ((lead == 0xed) && (second >= 0xa0) && (second <= 0xbf))
+        {
+            return UnicodeError::Surrogate;
+        }
+        if ((lead == 0xf4) && (second >= 0x90) && (second <= 0xbf))
         {
-            // Expecting a 10xxxxxx octet
-            if ((octet & 0xc0) != 0x80) return {false, 0};
+            return UnicodeError::OutOfRange;
+        }
+    }
+
+    // Otherwise, the sequence ended before it was complete
+    return UnicodeError::TruncatedSequence;
+}
 
-            // Append additional bits to the wide character
-            wide_character = (wide_character << 6) | (octet & 0x3f);
+/*
+ *  ValidateUTF8Scalar()
+ *
+ *  Description:
+ *      This function will process the sequence of octets one at a time and
+ *      verify that it is a valid UTF-8 sequence.  This is the scalar
+ *      implementation used to process any octets not handled by the SIMD
+ *      kernels.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      The result of the validation, with the position of any invalid
+ *      sequence given relative to the start of the octets span.
+ *
+ *  Comments:
+ *      None.
+ */
+ValidationResult ValidateUTF8Scalar(std::span<const std::uint8_t> octets)
+{
+    constexpr std::size_t Block_Size = 16;      // Octets between checks
+    std::uint8_t state = UTF8DFA::Accept;       // DFA state
+    std::size_t i{};
 
-            // Decrement the number of expected octets remaining
-            expected_utf8_remaining--;
+    // Advance the DFA over a block of octets at a time; since the reject
+    // state is never left, it need only be checked at the end of a block
+    while (i < octets.size())
+    {
+        std::uint8_t block_state = state;
+        std::size_t block_start = i;
+        std::size_t block_end = std::min(i + Block_Size, octets.size());
 
-            // If this is the final UTF-8 character, produce the output
-            if (expected_utf8_remaining == 0)
-            {
-                // Verify the character is <= 0x10'ffff per RFC 3629
-                if (wide_character > Unicode::Maximum_Character_Value)
-                {
-                    return {false, 0};
-                }
-
-                // Ensure the character code is not within the surrogate range
-                if ((wide_character >= Unicode::Surrogate_High_Min) &&
-                    (wide_character <= Unicode::Surrogate_Low_Max))
-                {
-                    return {false, 0};
-                }
-
-                // Encode the Unicode character using surrogate code points
-                // if it is between 0x10'0000 and 0x10'ffff.
-                if (wide_character > Unicode::Maximum_BMP_Value)
-                {
-                    // Convert the code point values using two 16-bit values
-                    // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
-                    std::uint16_t high_surrogate =
-                        static_cast<std::uint16_t>(Unicode::Lead_Offset +
-                                                   (wide_character >> 10));
-                    std::uint16_t low_surrogate =
-                        static_cast<std::uint16_t>(Unicode::Surrogate_Low_Min +
-                                                   (wide_character & 0x3ff));
-
-                    if (little_endian)
-                    {
-                        InsertUTF16LE(high_surrogate,
-                                      std::span<std::uint8_t, 2>{p, 2});
-                        InsertUTF16LE(low_surrogate,
-                                      std::span<std::uint8_t, 2>{p + 2, 2});
-                    }
-                    else
-                    {
-                        InsertUTF16BE(high_surrogate,
-                                      std::span<std::uint8_t, 2>{p, 2});
-                        InsertUTF16BE(low_surrogate,
-                                      std::span<std::uint8_t, 2>{p + 2, 2});
-                    }
-
-                    // Adjust the pointer p
-                    p += 4;
-                }
-                else
-                {
-                    if (little_endian)
-                    {
-                        InsertUTF16LE(
-                            static_cast<std::uint16_t>(wide_character),
-                            std::span<std::uint8_t, 2>{p, 2});
-                    }
-                    else
-                    {
-                        InsertUTF16BE(
-                            static_cast<std::uint16_t>(wide_character),
-                            std::span<std::uint8_t, 2>{p, 2});
-                    }
-
-                    // Adjust the pointer p
-                    p += 2;
-                }
-            }
+        for (; i < block_end; i++) state = UTF8DFA::Advance(state, octets[i]);
 
-            continue;
-        }
+        if (state != UTF8DFA::Reject) continue;
 
-        // Single ASCII character?
-        if (octet <= 0x7f)
+        // Locate the start of the character in progress at the start of
+        // the block (the octets before it have been accepted, so it begins
+        // at the last octet that is not a continuation octet)
+        std::size_t sequence_start = block_start;
+        if (block_state != UTF8DFA::Accept)
         {
-            if (little_endian)
-            {
-                InsertUTF16LE(octet, std::span<std::uint8_t, 2>{p, 2});
-            }
-            else
+            while ((octets[sequence_start - 1] & 0xc0) == 0x80)
             {
-                InsertUTF16BE(octet, std::span<std::uint8_t, 2>{p, 2});
+                sequence_start--;
             }
-            p += 2;
-            continue;
+            sequence_start--;
         }
 
-        // Two octet UTF-8 sequence (110xxxxx)
-        if ((octet & 0xe0) == 0xc0)
+        // Advance the DFA again to find the character that is ill-formed
+        state = block_state;
+        for (i = block_start; i < block_end; i++)
         {
-            wide_character = octet & 0x3f;
-            expected_utf8_remaining = 1;
-            continue;
+            if (state == UTF8DFA::Accept) sequence_start = i;
+            state = UTF8DFA::Advance(state, octets[i]);
+            if (state == UTF8DFA::Reject) break;
         }
 
-        // Three octet UTF-8 sequence (1110xxxx)
-        if ((octet & 0xf0) == 0xe0)
-        {
-            wide_character = octet & 0x0f;
-            expected_utf8_remaining = 2;
-            continue;
-        }
+        return {ClassifyUTF8Error(octets.subspan(sequence_start)),
+                sequence_start};
+    }
 
-        // Four octet UTF-8 sequence (11110xxx)
-        if ((octet & 0xf8) == 0xf0)
-        {
-            wide_character = octet & 0x07;
-            expected_utf8_remaining = 3;
-            continue;
-        }
+    // If the DFA is not in the accepting state, the input is truncated
+    if (state != UTF8DFA::Accept)
+    {
+        std::size_t sequence_start = octets.size();
+        while ((octets[sequence_start - 1] & 0xc0) == 0x80) sequence_start--;
 
-        // Any other value would be an invalid UTF-8 value
-        return {false, 0};
+        return {UnicodeError::TruncatedSequence, sequence_start - 1};
     }
 
-    // If there are other octets expected, return an error
-    if (expected_utf8_remaining > 0) return {false, 0};
+    return {UnicodeError::None, octets.size()};
+}
 
-    return {true, static_cast<std::size_t>(p - out.data())};
+/*
+ *  MaximalSubpartLength()
+ *
+ *  Description:
+ *      Determine the length of the ill-formed UTF-8 subsequence beginning at
+ *      the start of the given octets.  This is the length of the longest
+ *      prefix of a well-formed sequence (per Table 3-7 of the Unicode
+ *      Standard), or one if the first octet cannot begin a sequence.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets beginning with the ill-formed subsequence.  This must
+ *          not be empty.
+ *
+ *  Returns:
+ *      The number of octets to be replaced by a single U+FFFD.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::size_t MaximalSubpartLength(
+                                        std::span<const std::uint8_t> octets)
+{
+    std::uint8_t state = UTF8DFA::Accept;
+    std::size_t length{};
+
+    // Count the octets the DFA accepts as part of the sequence
+    while (length < octets.size())
+    {
+        state = UTF8DFA::Advance(state, octets[length]);
+        if ((state == UTF8DFA::Reject) || (state == UTF8DFA::Accept)) break;
+        length++;
+    }
+
+    return std::max(length, std::size_t{1});
 }
 
 /*
- *  ConvertUTF16ToUTF8()
+ *  AllocateUTF16()
  *
  *  Description:
- *      This function will take a span of octets in UTF-16 format and convert
- *      them to UTF-8 format.  The UTF-16 octets must NOT have a
- *      byte-order-mark (BOM) at the start.  The endianness is indicated
- *      via the third argument.
+ *      Convert the given UTF-8 string to UTF-16, storing the result in the
+ *      given container after resizing it to exactly the required length.
  *
  *  Parameters:
  *      in [in]
- *          The user-provided UTF-16 string.  This parameters must be less
- *          than (2^n - 1) / 1.5, where n is the bit-length of the type
- *          std::size_t. The reason is that the output buffer must be 1.5x
- *          larger than the input buffer.  The length will be checked to
- *          ensure the length is not greater thant Max_UTF16_String.
+ *          Original string in UTF-8 format.
  *
- *      out [out]
- *          The UTF-8 string derived from the given UTF-16 string.  This span
- *          MUST be 50% larger than the length of the input string since
- *          characters in the range of 0x0800 to 0xFFFF consumes two octets as
- *          UTF-16 and three octets when encoded as UTF-8.  While UTF-8 can
- *          encode supplementary beyond the Basic Multilingual Plane (BMP)
- *          require four octets to encode, those are represented as surrogate
- *          pairs in UTF-16 that are already four octets in length, thus
- *          they do not expand the length of the output string.
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *      out [in]
+ *          An empty container (which holds the allocator to use) into which
+ *          the UTF-16 string is written.
+ *
+ *  Returns:
+ *      The container holding the UTF-16 string, or an empty optional if the
+ *      input is not valid UTF-8.
+ *
+ *  Comments:
+ *      The exact length is computed first, so the container is allocated
+ *      once and never copied or shrunk.  If the input is invalid, the length
+ *      is not meaningful, but the conversion will then fail or stop short of
+ *      consuming all of the input.
+ */
+template<typename Container>
+std::optional<Container> AllocateUTF16(std::span<const std::uint8_t> in,
+                                       bool little_endian,
+                                       Container out)
+{
+    std::size_t length = UTF16LengthFromUTF8(in);
+
+    out.resize(length / sizeof(typename Container::value_type));
+
+    ConversionResult result = ConvertUTF8ToUTF16Partial(
+        in,
+        std::span<std::uint8_t>(reinterpret_cast<std::uint8_t *>(out.data()),
+                                length),
+        little_endian);
+    if (!result.success || (result.consumed != in.size())) return {};
+
+    return out;
+}
+
+/*
+ *  AllocateUTF8()
+ *
+ *  Description:
+ *      Convert the given UTF-16 string to UTF-8, storing the result in the
+ *      given container after resizing it to exactly the required length.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string.
  *
  *      little_endian [in]
  *          Are the UTF-16 characters in little endian order?
  *
+ *      out [in]
+ *          An empty container (which holds the allocator to use) into which
+ *          the UTF-8 string is written.
+ *
  *  Returns:
- *      A boolean and length pair, where the boolean indicates success or
- *      failure to convert the UTF-16 string.  Only if the return result is
- *      true does the length value have meaning.  On success, the length value
- *      indicates the number of octets (not characters!) in the resulting
- *      UTF-8 output span.
+ *      The container holding the UTF-8 string, or an empty optional if the
+ *      input is not valid UTF-16.
  *
  *  Comments:
- *      None.
+ *      The exact length is computed first, so the container is allocated
+ *      once and never copied or shrunk.  If the input is invalid, the length
+ *      is not meaningful, but the conversion will then fail or stop short of
+ *      consuming all of the input.
  */
-std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
-                                            std::span<const std::uint8_t> in,
-                                            std::span<std::uint8_t> out,
-                                            bool little_endian)
+template<typename Container>
+std::optional<Container> AllocateUTF8(std::span<const std::uint8_t> in,
+                                      bool little_endian,
+                                      Container out)
 {
-    // Get the length of the UTF-16-encoded string
-    std::size_t pw_length = in.size();
+    std::size_t length = UTF8LengthFromUTF16(in, little_endian);
 
-    // If the input is zero length, so is the output
-    if (pw_length == 0) return {true, 0};
+    out.resize(length);
 
-    // UTF-16 always has an even number of octets, so verify that is the case
-    if ((pw_length & 1) != 0) return {false, 0};
+    ConversionResult result = ConvertUTF16ToUTF8Partial(
+        in,
+        std::span<std::uint8_t>(reinterpret_cast<std::uint8_t *>(out.data()),
+                                length),
+        little_endian);
+    if (!result.success || (result.consumed != in.size())) return {};
 
-    // Reject UTF-16 strings that are to long
-    if (pw_length > Max_UTF16_String) return {false, 0};
+    return out;
+}
 
-    // If the output span is an insufficient size, return an error (1.5x size)
-    if (out.size() < (pw_length + (pw_length >> 1))) return {false, 0};
+} // namespace
 
-    // Assign the input and output pointers
-    const std::uint8_t *p = in.data();
-    const std::uint8_t *q = in.data() + pw_length;
-    std::uint8_t *r = out.data();
+/*
+ *  ConvertUTF8ToUTF16<Endian>()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format.  This function will not insert byte-order-mark
+ *      (BOM) octets.  The endianness is specified via the template parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+template<std::endian Endian>
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    static_assert((Endian == std::endian::little) ||
+                  (Endian == std::endian::big));
 
-    // Iterate over the input span
-    while (p < q)
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 2) return {false, 0};
+
+    // Since the output span is sufficiently large, all of the input will be
+    // consumed unless there is an error
+    ConversionResult result = ConvertUTF8ToUTF16Partial<Endian>(in, out);
+    if (!result.success) return {false, 0};
+
+    return {true, result.produced};
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format.  This function will not insert byte-order-mark
+ *      (BOM) octets.  The endianness is specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      This calls ConvertUTF8ToUTF16<Endian>() for the given byte order, so
+ *      the byte order is tested only once rather than for each character.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    return little_endian ? ConvertUTF8ToUTF16<std::endian::little>(in, out) :
+                           ConvertUTF8ToUTF16<std::endian::big>(in, out);
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and convert it to a string of
+ *      UTF-16 code units in the host's byte order, as held by a
+ *      std::u16string.  This function will not insert a byte-order-mark
+ *      (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format (e.g., a std::u8string_view).
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST have at least as many code units as the input has octets,
+ *          though the encoding length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of code units (not octets!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      The code units are stored as octets in the host's byte order, which
+ *      is exactly the representation of char16_t.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16(std::span<const char8_t> in,
+                                                std::span<char16_t> out)
+{
+    auto [result, length] = ConvertUTF8ToUTF16(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size()),
+        std::span<std::uint8_t>(reinterpret_cast<std::uint8_t *>(out.data()),
+                                out.size() * sizeof(char16_t)),
+        std::endian::native == std::endian::little);
+
+    return {result, length / sizeof(char16_t)};
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and return
+ *      a newly allocated vector holding the UTF-16 octets.  This function
+ *      will not insert byte-order-mark (BOM) octets.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The UTF-16 octets, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::vector<std::uint8_t>> ConvertUTF8ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            bool little_endian)
+{
+    return AllocateUTF16(in, little_endian, std::vector<std::uint8_t>{});
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and return a newly allocated
+ *      UTF-16 string in the host's byte order.  This function will not insert
+ *      a byte-order-mark (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *  Returns:
+ *      The UTF-16 string, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::u16string> ConvertUTF8ToUTF16(std::string_view in)
+{
+    return AllocateUTF16(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size()),
+        std::endian::native == std::endian::little,
+        std::u16string{});
+}
+
+/*
+ *  ConvertUTF8ToUTF16()
+ *
+ *  Description:
+ *      This function will take a UTF-8 string and return a UTF-16 string in
+ *      the host's byte order, allocated from the given memory resource.  This
+ *      function will not insert a byte-order-mark (BOM).
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      resource [in]
+ *          The memory resource from which to allocate the UTF-16 string.
+ *
+ *  Returns:
+ *      The UTF-16 string, or an empty optional if the input is not valid
+ *      UTF-8.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::pmr::u16string> ConvertUTF8ToUTF16(
+                                        std::string_view in,
+                                        std::pmr::memory_resource *resource)
+{
+    return AllocateUTF16(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size()),
+        std::endian::native == std::endian::little,
+        std::pmr::u16string{resource});
+}
+
+/*
+ *  ConvertUTF8ToUTF16Partial<Endian>()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  This function
+ *      will not insert byte-order-mark (BOM) octets.  The endianness is
+ *      specified via the template parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The span into which the UTF-16 string is written.  This may be
+ *          of any size.
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid sequence begins.  In either case, the number of
+ *      octets produced is the length of the valid UTF-16 output written.
+ *
+ *  Comments:
+ *      A character is never split, so the input consumed always ends on a
+ *      character boundary.  An incomplete sequence at the end of the input
+ *      is an error.
+ */
+template<std::endian Endian>
+ConversionResult ConvertUTF8ToUTF16Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out)
+{
+    static_assert((Endian == std::endian::little) ||
+                  (Endian == std::endian::big));
+    constexpr bool little_endian = Endian == std::endian::little;
+
+    std::uint8_t state = UTF8DFA::Accept;       // DFA state
+    std::uint32_t wide_character{};             // UTF-32 character
+    std::size_t sequence_start{};               // Start of current character
+
+    // Convert as much of the input as possible using the SIMD kernel, which
+    // requires the output to be at least twice the length of the input
+    auto [consumed, produced] = SIMD::GetKernels().utf8_to_utf16(
+                                        in.data(),
+                                        std::min(in.size(), out.size() / 2),
+                                        out.data(),
+                                        little_endian);
+
+    // Assign the output pointers
+    std::uint8_t *p = out.data() + produced;
+    std::uint8_t *p_end = out.data() + out.size();
+
+    // Function to produce the result given the input octets consumed
+    auto result = [&](UnicodeError error, std::size_t octets_consumed)
     {
-        std::uint32_t character{};
+        return ConversionResult{error == UnicodeError::None,
+                                octets_consumed,
+                                static_cast<std::size_t>(p - out.data()),
+                                error};
+    };
+
+    // Iterate over the remainder of the UTF-8 string
+    for (std::size_t i = consumed; i < in.size(); i++)
+    {
+        std::uint8_t octet = in[i];
 
-        // Extract the character from the input span (uint32_t is used since
-        // since UTF-16 can encode characters in the range of 0..1ffff using)
-        // surrogate code point values
-        if (little_endian)
+        if (state == UTF8DFA::Accept)
         {
-            character = ExtractUTF16LE(std::span<const uint8_t, 2>(p, 2));
+            // Note the start of this character
+            sequence_start = i;
+
+            // Convert the run of ASCII characters beginning with this octet
+            if (octet <= 0x7f)
+            {
+                std::size_t ascii_length = SIMD::GetKernels().ascii_to_utf16(
+                                    in.data() + i,
+                                    std::min(in.size() - i,
+                                             static_cast<std::size_t>(p_end -
+                                                                      p) / 2),
+                                    p,
+                                    little_endian);
+
+                // Stop if the output span is full
+                if (ascii_length == 0) return result(UnicodeError::None, i);
+
+                p += ascii_length * 2;
+                i += ascii_length - 1;
+                continue;
+            }
         }
-        else
+
+        // Append the bits of this octet to the wide character and advance
+        // the DFA, which rejects any ill-formed sequence
+        wide_character = (state == UTF8DFA::Accept) ?
+                             (octet & UTF8DFA::Lead_Masks[octet]) :
+                             ((wide_character << 6) | (octet & 0x3f));
+        state = UTF8DFA::Advance(state, octet);
+
+        if (state == UTF8DFA::Reject)
         {
-            character = ExtractUTF16BE(std::span<const uint8_t, 2>(p, 2));
+            return result(ClassifyUTF8Error(in.subspan(sequence_start)),
+                          sequence_start);
         }
 
-        // Advance the pointer to the next character (or surrogate)
-        p += 2;
+        // Continue until the final octet of the character is seen
+        if (state != UTF8DFA::Accept) continue;
 
-        // Is this character code in the surrogate range?
-        if ((character >= Unicode::Surrogate_High_Min) &&
-            (character <= Unicode::Surrogate_Low_Max))
+        // Encode the Unicode character using surrogate code points if it is
+        // between 0x10'0000 and 0x10'ffff.
+        if (wide_character > Unicode::Maximum_BMP_Value)
         {
-            std::uint16_t low_surrogate{};
-
-            // Ensure the character value is not in the low surrogate range
-            if ((character >= Unicode::Surrogate_Low_Min) &&
-                (character <= Unicode::Surrogate_Low_Max))
+            // Stop if the surrogate pair will not fit
+            if ((p_end - p) < 4)
             {
-                return {false, 0};
+                return result(UnicodeError::None, sequence_start);
             }
 
-            // Ensure we do not run off the end of the buffer as we read the
-            // low surrogate value
-            if (p >= q) return {false, 0};
+            // Convert the code point values using two 16-bit values
+            // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
+            std::uint16_t high_surrogate =
+                static_cast<std::uint16_t>(Unicode::Lead_Offset +
+                                           (wide_character >> 10));
+            std::uint16_t low_surrogate =
+                static_cast<std::uint16_t>(Unicode::Surrogate_Low_Min +
+                                           (wide_character & 0x3ff));
 
-            // Extract the low surrogate code point
-            if (little_endian)
+            if constexpr (little_endian)
             {
-                low_surrogate =
-                    ExtractUTF16LE(std::span<const uint8_t, 2>(p, 2));
+                InsertUTF16LE(high_surrogate, std::span<std::uint8_t, 2>{p, 2});
+                InsertUTF16LE(low_surrogate,
+                              std::span<std::uint8_t, 2>{p + 2, 2});
             }
             else
             {
-                low_surrogate =
-                    ExtractUTF16BE(std::span<const uint8_t, 2>(p, 2));
+                InsertUTF16BE(high_surrogate, std::span<std::uint8_t, 2>{p, 2});
+                InsertUTF16BE(low_surrogate,
+                              std::span<std::uint8_t, 2>{p + 2, 2});
             }
 
-            // Advance the pointer to the next character (for next iteration)
-            p += 2;
+            // Adjust the pointer p
+            p += 4;
+        }
+        else
+        {
+            // Stop if the character will not fit
+            if ((p_end - p) < 2)
+            {
+                return result(UnicodeError::None, sequence_start);
+            }
 
-            // Ensure the low surrogate value is within the expected range
-            if ((low_surrogate < Unicode::Surrogate_Low_Min) ||
-                (low_surrogate > Unicode::Surrogate_Low_Max))
+            if constexpr (little_endian)
+            {
+                InsertUTF16LE(static_cast<std::uint16_t>(wide_character),
+                              std::span<std::uint8_t, 2>{p, 2});
+            }
+            else
             {
-                return {false, 0};
+                InsertUTF16BE(static_cast<std::uint16_t>(wide_character),
+                              std::span<std::uint8_t, 2>{p, 2});
             }
 
-            // Convert the high / low code point values to a UTF-32 value
-            // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3).
-            // NOTE: An alternative is this, but this takes more steps:
-            //           character = ((character - 0xd800) << 10) +
-            //                       (low_surrogate - 0xdc00) + 0x1'0000;
-            character =
-                (character << 10) + low_surrogate + Unicode::Surrogate_Offset;
+            // Adjust the pointer p
+            p += 2;
+        }
+    }
+
+    // If the DFA is not in the accepting state, the input is truncated
+    if (state != UTF8DFA::Accept)
+    {
+        return result(UnicodeError::TruncatedSequence, sequence_start);
+    }
+
+    return result(UnicodeError::None, in.size());
+}
+
+/*
+ *  ConvertUTF8ToUTF16Partial()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  This function
+ *      will not insert byte-order-mark (BOM) octets.  The endianness is
+ *      specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The span into which the UTF-16 string is written.  This may be
+ *          of any size.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid sequence begins.  In either case, the number of
+ *      octets produced is the length of the valid UTF-16 output written.
+ *
+ *  Comments:
+ *      This calls ConvertUTF8ToUTF16Partial<Endian>() for the given byte order,
+ *      so the byte order is tested only once rather than for each character.
+ */
+ConversionResult ConvertUTF8ToUTF16Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out,
+                                           bool little_endian)
+{
+    return little_endian ?
+               ConvertUTF8ToUTF16Partial<std::endian::little>(in, out) :
+               ConvertUTF8ToUTF16Partial<std::endian::big>(in, out);
+}
+
+/*
+ *  ConvertUTF8ToUTF16Lossy()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format, replacing each ill-formed subsequence with the
+ *      replacement character U+FFFD rather than failing.  This function will
+ *      not insert byte-order-mark (BOM) octets.  The endianness is specified
+ *      via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format, which need not be valid.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets (not characters!) in the resulting UTF-16 output
+ *      span.
+ *
+ *  Comments:
+ *      Each valid stretch of the input is converted by
+ *      ConvertUTF8ToUTF16Partial(), so valid input is converted at the same
+ *      speed as by ConvertUTF8ToUTF16().  Since every replaced subsequence
+ *      is at least one octet long and yields two octets, the output cannot
+ *      exceed 2x the input length.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16Lossy(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    std::size_t consumed{};
+    std::size_t produced{};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 2) return {false, 0};
+
+    // Convert each valid stretch of the input, then replace the ill-formed
+    // subsequence that follows it
+    while (consumed < in.size())
+    {
+        ConversionResult result = ConvertUTF8ToUTF16Partial(
+                                                    in.subspan(consumed),
+                                                    out.subspan(produced),
+                                                    little_endian);
+        consumed += result.consumed;
+        produced += result.produced;
+
+        if (result.success) continue;
+
+        if (little_endian)
+        {
+            InsertUTF16LE(Unicode::Replacement_Character,
+                          std::span<std::uint8_t, 2>{out.data() + produced, 2});
+        }
+        else
+        {
+            InsertUTF16BE(Unicode::Replacement_Character,
+                          std::span<std::uint8_t, 2>{out.data() + produced, 2});
+        }
+        produced += 2;
+        consumed += MaximalSubpartLength(in.subspan(consumed));
+    }
+
+    return {true, produced};
+}
+
+/*
+ *  ConvertUTF16ToUTF8<Endian>()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format.  The UTF-16 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness is indicated
+ *      via the template parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.  This parameters must be less
+ *          than (2^n - 1) / 1.5, where n is the bit-length of the type
+ *          std::size_t. The reason is that the output buffer must be 1.5x
+ *          larger than the input buffer.  The length will be checked to
+ *          ensure the length is not greater thant Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string since
+ *          characters in the range of 0x0800 to 0xFFFF consumes two octets as
+ *          UTF-16 and three octets when encoded as UTF-8.  While UTF-8 can
+ *          encode supplementary beyond the Basic Multilingual Plane (BMP)
+ *          require four octets to encode, those are represented as surrogate
+ *          pairs in UTF-16 that are already four octets in length, thus
+ *          they do not expand the length of the output string.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+template<std::endian Endian>
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    static_assert((Endian == std::endian::little) ||
+                  (Endian == std::endian::big));
+
+    // Get the length of the UTF-16-encoded string
+    std::size_t pw_length = in.size();
+
+    // If the input is zero length, so is the output
+    if (pw_length == 0) return {true, 0};
+
+    // UTF-16 always has an even number of octets, so verify that is the case
+    if ((pw_length & 1) != 0) return {false, 0};
+
+    // Reject UTF-16 strings that are to long
+    if (pw_length > Max_UTF16_String) return {false, 0};
+
+    // If the output span is an insufficient size, return an error (1.5x size)
+    if (out.size() < (pw_length + (pw_length >> 1))) return {false, 0};
+
+    // Since the output span is sufficiently large, all of the input will be
+    // consumed unless there is an error
+    ConversionResult result = ConvertUTF16ToUTF8Partial<Endian>(in, out);
+    if (!result.success) return {false, 0};
+
+    return {true, result.produced};
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format.  The UTF-16 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness is indicated
+ *      via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.  This parameters must be less
+ *          than (2^n - 1) / 1.5, where n is the bit-length of the type
+ *          std::size_t. The reason is that the output buffer must be 1.5x
+ *          larger than the input buffer.  The length will be checked to
+ *          ensure the length is not greater thant Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string since
+ *          characters in the range of 0x0800 to 0xFFFF consumes two octets as
+ *          UTF-16 and three octets when encoded as UTF-8.  While UTF-8 can
+ *          encode supplementary beyond the Basic Multilingual Plane (BMP)
+ *          require four octets to encode, those are represented as surrogate
+ *          pairs in UTF-16 that are already four octets in length, thus
+ *          they do not expand the length of the output string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      This calls ConvertUTF16ToUTF8<Endian>() for the given byte order, so
+ *      the byte order is tested only once rather than for each character.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    return little_endian ? ConvertUTF16ToUTF8<std::endian::little>(in, out) :
+                           ConvertUTF16ToUTF8<std::endian::big>(in, out);
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a string of UTF-16 code units in the host's
+ *      byte order, as held by a std::u16string, and convert it to UTF-8.
+ *      The UTF-16 string must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string (e.g., a std::u16string_view).
+ *          The number of code units must not be greater than half of
+ *          Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST have at least three octets for each input code unit, though
+ *          the encoding length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      The code units are read as octets in the host's byte order, which is
+ *      exactly the representation of char16_t.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8(std::span<const char16_t> in,
+                                                std::span<char8_t> out)
+{
+    return ConvertUTF16ToUTF8(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size() * sizeof(char16_t)),
+        std::span<std::uint8_t>(reinterpret_cast<std::uint8_t *>(out.data()),
+                                out.size()),
+        std::endian::native == std::endian::little);
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and return
+ *      a newly allocated vector holding the UTF-8 octets.  The UTF-16 octets
+ *      must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The UTF-8 octets, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::vector<std::uint8_t>> ConvertUTF16ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            bool little_endian)
+{
+    return AllocateUTF8(in, little_endian, std::vector<std::uint8_t>{});
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a UTF-16 string in the host's byte order and
+ *      return a newly allocated UTF-8 string.  The UTF-16 string must NOT
+ *      have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *  Returns:
+ *      The UTF-8 string, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::string> ConvertUTF16ToUTF8(std::u16string_view in)
+{
+    return AllocateUTF8(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size() * sizeof(char16_t)),
+        std::endian::native == std::endian::little,
+        std::string{});
+}
+
+/*
+ *  ConvertUTF16ToUTF8()
+ *
+ *  Description:
+ *      This function will take a UTF-16 string in the host's byte order and
+ *      return a UTF-8 string allocated from the given memory resource.  The
+ *      UTF-16 string must NOT have a byte-order-mark (BOM) at the start.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      resource [in]
+ *          The memory resource from which to allocate the UTF-8 string.
+ *
+ *  Returns:
+ *      The UTF-8 string, or an empty optional if the input is not valid
+ *      UTF-16.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::pmr::string> ConvertUTF16ToUTF8(
+                                        std::u16string_view in,
+                                        std::pmr::memory_resource *resource)
+{
+    return AllocateUTF8(
+        std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(in.data()),
+            in.size() * sizeof(char16_t)),
+        std::endian::native == std::endian::little,
+        std::pmr::string{resource});
+}
+
+/*
+ *  ConvertUTF16ToUTF8Partial<Endian>()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  The UTF-16
+ *      octets must NOT have a byte-order-mark (BOM) at the start.  The
+ *      endianness is indicated via the template parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The span into which the UTF-8 string is written.  This may be of
+ *          any size.
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid character begins.  In either case, the number of
+ *      octets produced is the length of the valid UTF-8 output written.
+ *
+ *  Comments:
+ *      A surrogate pair is never split, so the input consumed always ends on
+ *      a character boundary.  An unpaired surrogate or an odd octet at the
+ *      end of the input is an error.
+ */
+template<std::endian Endian>
+ConversionResult ConvertUTF16ToUTF8Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out)
+{
+    static_assert((Endian == std::endian::little) ||
+                  (Endian == std::endian::big));
+    constexpr bool little_endian = Endian == std::endian::little;
+
+    // Get the length of the UTF-16-encoded string, ignoring any odd octet
+    std::size_t pw_length = in.size() & ~std::size_t{1};
+
+    // Convert as much of the input as possible using the SIMD kernel, which
+    // requires the output to be at least 1.5x the length of the input
+    auto [consumed, produced] = SIMD::GetKernels().utf16_to_utf8(
+                                        in.data(),
+                                        std::min(pw_length,
+                                                 (out.size() / 3) * 2),
+                                        out.data(),
+                                        little_endian);
+
+    // Assign the input and output pointers
+    const std::uint8_t *p = in.data() + consumed;
+    const std::uint8_t *q = in.data() + pw_length;
+    std::uint8_t *r = out.data() + produced;
+    std::uint8_t *r_end = out.data() + out.size();
+
+    // Function to produce the result given the input position reached
+    auto result = [&](UnicodeError error, const std::uint8_t *position)
+    {
+        return ConversionResult{
+            error == UnicodeError::None,
+            static_cast<std::size_t>(position - in.data()),
+            static_cast<std::size_t>(r - out.data()),
+            error};
+    };
+
+    // Iterate over the input span
+    while (p < q)
+    {
+        const std::uint8_t *character_start = p;
+        std::uint32_t character{};
+
+        // Extract the character from the input span (uint32_t is used since
+        // since UTF-16 can encode characters in the range of 0..1ffff using)
+        // surrogate code point values
+        if constexpr (little_endian)
+        {
+            character = ExtractUTF16LE(std::span<const uint8_t, 2>(p, 2));
+        }
+        else
+        {
+            character = ExtractUTF16BE(std::span<const uint8_t, 2>(p, 2));
+        }
+
+        // Advance the pointer to the next character (or surrogate)
+        p += 2;
+
+        // Is this character code in the surrogate range?
+        if ((character >= Unicode::Surrogate_High_Min) &&
+            (character <= Unicode::Surrogate_Low_Max))
+        {
+            std::uint16_t low_surrogate{};
+
+            // Ensure the character value is not in the low surrogate range
+            if ((character >= Unicode::Surrogate_Low_Min) &&
+                (character <= Unicode::Surrogate_Low_Max))
+            {
+                return result(UnicodeError::UnpairedSurrogate,
+                              character_start);
+            }
+
+            // Ensure we do not run off the end of the buffer as we read the
+            // low surrogate value
+            if (p >= q)
+            {
+                return result(UnicodeError::UnpairedSurrogate,
+                              character_start);
+            }
+
+            // Extract the low surrogate code point
+            if constexpr (little_endian)
+            {
+                low_surrogate =
+                    ExtractUTF16LE(std::span<const uint8_t, 2>(p, 2));
+            }
+            else
+            {
+                low_surrogate =
+                    ExtractUTF16BE(std::span<const uint8_t, 2>(p, 2));
+            }
+
+            // Advance the pointer to the next character (for next iteration)
+            p += 2;
+
+            // Ensure the low surrogate value is within the expected range
+            if ((low_surrogate < Unicode::Surrogate_Low_Min) ||
+                (low_surrogate > Unicode::Surrogate_Low_Max))
+            {
+                return result(UnicodeError::UnpairedSurrogate,
+                              character_start);
+            }
+
+            // Convert the high / low code point values to a UTF-32 value
+            // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3).
+            // NOTE: An alternative is this, but this takes more steps:
+            //           character = ((character - 0xd800) << 10) +
+            //                       (low_surrogate - 0xdc00) + 0x1'0000;
+            character =
+                (character << 10) + low_surrogate + Unicode::Surrogate_Offset;
+        }
+
+        // The following will produce the UTF-8 code point(s)
+        // (See: https://www.rfc-editor.org/rfc/rfc3629#section-3)
+
+        if (character <= 0x7f)
+        {
+            // 0nnnnnnn (converting the entire run of ASCII characters)
+            std::size_t ascii_length = SIMD::GetKernels().ascii_from_utf16(
+                        character_start,
+                        std::min(static_cast<std::size_t>(q - character_start),
+                                 static_cast<std::size_t>(r_end - r) * 2),
+                        r,
+                        little_endian);
+
+            // Stop if the output span is full
+            if (ascii_length == 0)
+            {
+                return result(UnicodeError::None, character_start);
+            }
+
+            p = character_start + ascii_length;
+            r += ascii_length / 2;
+            continue;
+        }
+
+        if (character <= 0x7ff)
+        {
+            // Stop if the character will not fit
+            if ((r_end - r) < 2)
+            {
+                return result(UnicodeError::None, character_start);
+            }
+
+            // 110nnnnn 10nnnnnn
+            *r++ = static_cast<std::uint8_t>(0xc0 | ((character >> 6) & 0x1f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character     ) & 0x3f));
+            continue;
+        }
+
+        if (character <= 0xffff)
+        {
+            // Stop if the character will not fit
+            if ((r_end - r) < 3)
+            {
+                return result(UnicodeError::None, character_start);
+            }
+
+            // 1110nnnn 10nnnnnn 10nnnnnn
+            *r++ = static_cast<std::uint8_t>(0xe0 | ((character >> 12) & 0x0f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
+            continue;
+        }
+
+        if (character <= 0x10'ffff)
+        {
+            // Stop if the character will not fit
+            if ((r_end - r) < 4)
+            {
+                return result(UnicodeError::None, character_start);
+            }
+
+            // 11110nnn 10nnnnnn 10nnnnnn 10nnnnnn
+            *r++ = static_cast<std::uint8_t>(0xf0 | ((character >> 18) & 0x07));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character >> 12) & 0x3f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
+            continue;
+        }
+
+        // We should never get to this point, as this would indicate an error
+        return result(UnicodeError::OutOfRange, character_start);
+    }
+
+    // UTF-16 always has an even number of octets, so an odd octet is an error
+    if (pw_length != in.size())
+    {
+        return result(UnicodeError::TruncatedSequence, q);
+    }
+
+    return result(UnicodeError::None, q);
+}
+
+/*
+ *  ConvertUTF16ToUTF8Partial()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format, stopping when the input is exhausted or when
+ *      the next character will not fit in the output span.  The UTF-16
+ *      octets must NOT have a byte-order-mark (BOM) at the start.  The
+ *      endianness is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The span into which the UTF-8 string is written.  This may be of
+ *          any size.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the input length only if the output span
+ *      was filled.  On failure, the number of octets consumed indicates
+ *      where the invalid character begins.  In either case, the number of
+ *      octets produced is the length of the valid UTF-8 output written.
+ *
+ *  Comments:
+ *      This calls ConvertUTF16ToUTF8Partial<Endian>() for the given byte order,
+ *      so the byte order is tested only once rather than for each character.
+ */
+ConversionResult ConvertUTF16ToUTF8Partial(std::span<const std::uint8_t> in,
+                                           std::span<std::uint8_t> out,
+                                           bool little_endian)
+{
+    return little_endian ?
+               ConvertUTF16ToUTF8Partial<std::endian::little>(in, out) :
+               ConvertUTF16ToUTF8Partial<std::endian::big>(in, out);
+}
+
+/*
+ *  ConvertUTF16ToUTF8Lossy()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format, replacing each unpaired surrogate (and an odd
+ *      final octet) with the replacement character U+FFFD rather than
+ *      failing.  The UTF-16 octets must NOT have a byte-order-mark (BOM) at
+ *      the start.  The endianness is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string, which need not be valid.  The
+ *          length must not be greater than Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string, plus
+ *          three octets if the input length is odd.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      input is too long or the output span is too small.  On success, the
+ *      length value indicates the number of octets (not characters!) in the
+ *      resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      Each valid stretch of the input is converted by
+ *      ConvertUTF16ToUTF8Partial(), so valid input is converted at the same
+ *      speed as by ConvertUTF16ToUTF8().  An unpaired surrogate occupies two
+ *      octets and yields three, so only an odd final octet can cause the
+ *      output to exceed 1.5x the input length.  A high surrogate followed
+ *      only by an odd final octet is replaced by a single U+FFFD.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8Lossy(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    std::size_t pw_length = in.size() & ~std::size_t{1};
+    std::size_t consumed{};
+    std::size_t produced{};
+
+    // Reject UTF-16 strings that are to long
+    if (in.size() > Max_UTF16_String) return {false, 0};
+
+    // If the output span is an insufficient size, return an error (1.5x size
+    // plus room to replace an odd final octet)
+    if (out.size() < (pw_length + (pw_length >> 1) +
+                      ((pw_length != in.size()) ? 3 : 0)))
+    {
+        return {false, 0};
+    }
+
+    // Convert each valid stretch of the input, then replace the unpaired
+    // surrogate or odd octet that follows it
+    while (consumed < in.size())
+    {
+        ConversionResult result = ConvertUTF16ToUTF8Partial(
+                                                    in.subspan(consumed),
+                                                    out.subspan(produced),
+                                                    little_endian);
+        consumed += result.consumed;
+        produced += result.produced;
+
+        if (result.success) continue;
+
+        out[produced++] = 0xef;
+        out[produced++] = 0xbf;
+        out[produced++] = 0xbd;
+
+        // A high surrogate followed only by an odd octet is a single
+        // truncated surrogate pair, so it is replaced as a whole
+        std::size_t remaining = in.size() - consumed;
+        if ((remaining == 3) &&
+            ((in[consumed + (little_endian ? 1 : 0)] & 0xfc) == 0xd8))
+        {
+            consumed += 3;
+        }
+        else
+        {
+            consumed += std::min(std::size_t{2}, remaining);
+        }
+    }
+
+    return {true, produced};
+}
+
+/*
+ *  ConvertUTF8ToUTF32()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-32 format.  This function will not insert byte-order-mark
+ *      (BOM) octets.  The endianness is specified via the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-32 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 4x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-32 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF32(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    std::uint8_t state = UTF8DFA::Accept;       // DFA state
+    std::uint32_t wide_character{};             // UTF-32 character
+
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 4) return {false, 0};
+
+    // Assign the output pointer
+    std::uint8_t *p = out.data();
+
+    // Iterate over the UTF-8 string
+    for (std::size_t i = 0; i < in.size(); i++)
+    {
+        std::uint8_t octet = in[i];
+
+        // Convert the run of ASCII characters beginning with this octet
+        if ((state == UTF8DFA::Accept) && (octet <= 0x7f))
+        {
+            std::size_t ascii_length = SIMD::GetKernels().ascii_to_utf32(
+                                                            in.data() + i,
+                                                            in.size() - i,
+                                                            p,
+                                                            little_endian);
+            p += ascii_length * 4;
+            i += ascii_length - 1;
+            continue;
+        }
+
+        // Append the bits of this octet to the wide character and advance
+        // the DFA, which rejects any ill-formed sequence
+        wide_character = (state == UTF8DFA::Accept) ?
+                             (octet & UTF8DFA::Lead_Masks[octet]) :
+                             ((wide_character << 6) | (octet & 0x3f));
+        state = UTF8DFA::Advance(state, octet);
+
+        if (state == UTF8DFA::Reject) return {false, 0};
+
+        // Continue until the final octet of the character is seen
+        if (state != UTF8DFA::Accept) continue;
+
+        if (little_endian)
+        {
+            InsertUTF32LE(wide_character, std::span<std::uint8_t, 4>{p, 4});
+        }
+        else
+        {
+            InsertUTF32BE(wide_character, std::span<std::uint8_t, 4>{p, 4});
+        }
+
+        // Adjust the pointer p
+        p += 4;
+    }
+
+    // If the DFA is not in the accepting state, the input is truncated
+    if (state != UTF8DFA::Accept) return {false, 0};
+
+    return {true, static_cast<std::size_t>(p - out.data())};
+}
+
+/*
+ *  ConvertUTF32ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-32 format and convert
+ *      them to UTF-8 format.  The UTF-32 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness is indicated
+ *      via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-32 string.  The length must be a multiple
+ *          of four octets.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-32 string.  This span
+ *          MUST be at least as large as the input span, since no character
+ *          requires more than four octets when encoded as UTF-8.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-32 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      Surrogates and values above 0x10ffff are rejected.
+ */
+std::pair<bool, std::size_t> ConvertUTF32ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // UTF-32 always has a multiple of four octets, so verify that is the case
+    if ((in.size() & 3) != 0) return {false, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size()) return {false, 0};
+
+    // Assign the input and output pointers
+    const std::uint8_t *p = in.data();
+    const std::uint8_t *q = in.data() + in.size();
+    std::uint8_t *r = out.data();
+
+    // Iterate over the input span
+    while (p < q)
+    {
+        std::uint32_t character =
+            little_endian ? ExtractUTF32LE(std::span<const uint8_t, 4>(p, 4)) :
+                            ExtractUTF32BE(std::span<const uint8_t, 4>(p, 4));
+
+        // The following will produce the UTF-8 code point(s)
+        // (See: https://www.rfc-editor.org/rfc/rfc3629#section-3)
+
+        if (character <= 0x7f)
+        {
+            // 0nnnnnnn (converting the entire run of ASCII characters)
+            std::size_t ascii_length = SIMD::GetKernels().ascii_from_utf32(
+                                        p,
+                                        static_cast<std::size_t>(q - p),
+                                        r,
+                                        little_endian);
+            p += ascii_length;
+            r += ascii_length / 4;
+            continue;
+        }
+
+        // Surrogates and values beyond the Unicode range are invalid
+        if (!IsScalarValue(character)) return {false, 0};
+
+        // Advance the pointer to the next character
+        p += 4;
+
+        if (character <= 0x7ff)
+        {
+            // 110nnnnn 10nnnnnn
+            *r++ = static_cast<std::uint8_t>(0xc0 | ((character >> 6) & 0x1f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character     ) & 0x3f));
+            continue;
+        }
+
+        if (character <= 0xffff)
+        {
+            // 1110nnnn 10nnnnnn 10nnnnnn
+            *r++ = static_cast<std::uint8_t>(0xe0 | ((character >> 12) & 0x0f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
+            *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
+            continue;
+        }
+
+        // 11110nnn 10nnnnnn 10nnnnnn 10nnnnnn
+        *r++ = static_cast<std::uint8_t>(0xf0 | ((character >> 18) & 0x07));
+        *r++ = static_cast<std::uint8_t>(0x80 | ((character >> 12) & 0x3f));
+        *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
+        *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
+    }
+
+    return {true, static_cast<std::size_t>(r - out.data())};
+}
+
+/*
+ *  ConvertUTF16ToUTF32()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-32 format.  The UTF-16 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness of both the input
+ *      and the output is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The UTF-32 string derived from the given UTF-16 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 and UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-32 output span.
+ *
+ *  Comments:
+ *      The SIMD kernel converts each run of characters that are not
+ *      surrogates, leaving only the surrogate pairs to the scalar code.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF32(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // UTF-16 always has an even number of octets, so verify that is the case
+    if ((in.size() & 1) != 0) return {false, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 2) return {false, 0};
+
+    // Assign the input and output pointers
+    const std::uint8_t *p = in.data();
+    const std::uint8_t *q = in.data() + in.size();
+    std::uint8_t *r = out.data();
+
+    while (true)
+    {
+        // Convert the run of characters that are not surrogates
+        std::size_t run_length = SIMD::GetKernels().utf16_to_utf32(
+                                        p,
+                                        static_cast<std::size_t>(q - p),
+                                        r,
+                                        little_endian);
+        p += run_length;
+        r += run_length * 2;
+
+        if (p >= q) break;
+
+        // The run ended with a surrogate, which must be a high surrogate
+        // followed by a low surrogate
+        if ((q - p) < 4) return {false, 0};
+        std::uint32_t high_surrogate =
+            little_endian ? ExtractUTF16LE(std::span<const uint8_t, 2>(p, 2)) :
+                            ExtractUTF16BE(std::span<const uint8_t, 2>(p, 2));
+        std::uint32_t low_surrogate =
+            little_endian ?
+                ExtractUTF16LE(std::span<const uint8_t, 2>(p + 2, 2)) :
+                ExtractUTF16BE(std::span<const uint8_t, 2>(p + 2, 2));
+        if ((high_surrogate >= Unicode::Surrogate_Low_Min) ||
+            (low_surrogate < Unicode::Surrogate_Low_Min) ||
+            (low_surrogate > Unicode::Surrogate_Low_Max))
+        {
+            return {false, 0};
+        }
+
+        // Convert the high / low code point values to a UTF-32 value
+        // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
+        std::uint32_t character = (high_surrogate << 10) + low_surrogate +
+                                  Unicode::Surrogate_Offset;
+
+        if (little_endian)
+        {
+            InsertUTF32LE(character, std::span<std::uint8_t, 4>{r, 4});
+        }
+        else
+        {
+            InsertUTF32BE(character, std::span<std::uint8_t, 4>{r, 4});
+        }
+
+        p += 4;
+        r += 4;
+    }
+
+    return {true, static_cast<std::size_t>(r - out.data())};
+}
+
+/*
+ *  ConvertUTF32ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-32 format and convert
+ *      them to UTF-16 format.  The UTF-32 octets must NOT have a
+ *      byte-order-mark (BOM) at the start.  The endianness of both the input
+ *      and the output is indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-32 string.  The length must be a multiple
+ *          of four octets.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-32 string.  This span
+ *          MUST be at least as large as the input span, since characters
+ *          outside of the Basic Multilingual Plane (BMP) are encoded as
+ *          surrogate pairs of the same length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 and UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-32 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      The SIMD kernel converts each run of characters in the BMP, leaving
+ *      only the characters that require surrogate pairs (and any invalid
+ *      values) to the scalar code.
+ */
+std::pair<bool, std::size_t> ConvertUTF32ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // UTF-32 always has a multiple of four octets, so verify that is the case
+    if ((in.size() & 3) != 0) return {false, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size()) return {false, 0};
+
+    // Assign the input and output pointers
+    const std::uint8_t *p = in.data();
+    const std::uint8_t *q = in.data() + in.size();
+    std::uint8_t *r = out.data();
+
+    while (true)
+    {
+        // Convert the run of characters in the BMP
+        std::size_t run_length = SIMD::GetKernels().utf32_to_utf16(
+                                        p,
+                                        static_cast<std::size_t>(q - p),
+                                        r,
+                                        little_endian);
+        p += run_length;
+        r += run_length / 2;
+
+        if (p >= q) break;
+
+        // The run ended with a character outside of the BMP, which is
+        // encoded as a surrogate pair, or an invalid value
+        std::uint32_t character =
+            little_endian ? ExtractUTF32LE(std::span<const uint8_t, 4>(p, 4)) :
+                            ExtractUTF32BE(std::span<const uint8_t, 4>(p, 4));
+        if (!IsScalarValue(character) ||
+            (character <= Unicode::Maximum_BMP_Value))
+        {
+            return {false, 0};
+        }
+
+        // Convert the code point values using two 16-bit values
+        // (See: https://www.Unicode.org/faq/utf_bom.html#utf16-3)
+        std::uint16_t high_surrogate =
+            static_cast<std::uint16_t>(Unicode::Lead_Offset +
+                                       (character >> 10));
+        std::uint16_t low_surrogate =
+            static_cast<std::uint16_t>(Unicode::Surrogate_Low_Min +
+                                       (character & 0x3ff));
+
+        if (little_endian)
+        {
+            InsertUTF16LE(high_surrogate, std::span<std::uint8_t, 2>{r, 2});
+            InsertUTF16LE(low_surrogate, std::span<std::uint8_t, 2>{r + 2, 2});
+        }
+        else
+        {
+            InsertUTF16BE(high_surrogate, std::span<std::uint8_t, 2>{r, 2});
+            InsertUTF16BE(low_surrogate, std::span<std::uint8_t, 2>{r + 2, 2});
         }
 
-        // The following will produce the UTF-8 code point(s)
-        // (See: https://www.rfc-editor.org/rfc/rfc3629#section-3)
+        p += 4;
+        r += 4;
+    }
 
-        if (character <= 0x7f)
-        {
-            // 0nnnnnn
-            *r++ = static_cast<std::uint8_t>(character & 0x7f);
-            continue;
-        }
+    return {true, static_cast<std::size_t>(r - out.data())};
+}
 
-        if (character <= 0x7ff)
+/*
+ *  ConvertLatin1ToUTF8()
+ *
+ *  Description:
+ *      This function will take a span of octets in Latin-1 (ISO-8859-1)
+ *      format and convert them to UTF-8 format.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in Latin-1 format.  Every octet value is valid.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given Latin-1 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets in the resulting UTF-8 output span.
+ *
+ *  Comments:
+ *      Runs of ASCII characters are copied by the SIMD kernel, while each
+ *      character from 0x80 to 0xff is encoded as two octets.
+ */
+std::pair<bool, std::size_t> ConvertLatin1ToUTF8(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 2) return {false, 0};
+
+    // Assign the output pointer
+    std::uint8_t *p = out.data();
+
+    // Iterate over the Latin-1 string
+    for (std::size_t i = 0; i < in.size(); i++)
+    {
+        std::uint8_t octet = in[i];
+
+        // Copy the run of ASCII characters beginning with this octet
+        if (octet <= 0x7f)
         {
-            // 110nnnnn 10nnnnnn
-            *r++ = static_cast<std::uint8_t>(0xc0 | ((character >> 6) & 0x1f));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character     ) & 0x3f));
+            std::size_t ascii_length = SIMD::GetKernels().copy_ascii(
+                                                            in.data() + i,
+                                                            in.size() - i,
+                                                            p);
+            p += ascii_length;
+            i += ascii_length - 1;
             continue;
         }
 
-        if (character <= 0xffff)
+        // 110000nn 10nnnnnn
+        *p++ = static_cast<std::uint8_t>(0xc0 | (octet >> 6));
+        *p++ = static_cast<std::uint8_t>(0x80 | (octet & 0x3f));
+    }
+
+    return {true, static_cast<std::size_t>(p - out.data())};
+}
+
+/*
+ *  ConvertUTF8ToLatin1()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to Latin-1 (ISO-8859-1) format.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The Latin-1 string derived from the given UTF-8 string.  This span
+ *          MUST be at least as large as the input span, though the encoding
+ *          length might be smaller.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting Latin-1 output span.
+ *
+ *  Comments:
+ *      The only well-formed UTF-8 sequences for characters from 0x80 to 0xff
+ *      are c2 or c3 followed by a continuation octet, so any other octet
+ *      that is not ASCII indicates either invalid input or a character that
+ *      cannot be represented in Latin-1.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToLatin1(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size()) return {false, 0};
+
+    // Assign the output pointer
+    std::uint8_t *p = out.data();
+
+    // Iterate over the UTF-8 string
+    for (std::size_t i = 0; i < in.size(); i++)
+    {
+        std::uint8_t octet = in[i];
+
+        // Copy the run of ASCII characters beginning with this octet
+        if (octet <= 0x7f)
         {
-            // 1110nnnn 10nnnnnn 10nnnnnn
-            *r++ = static_cast<std::uint8_t>(0xe0 | ((character >> 12) & 0x0f));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
+            std::size_t ascii_length = SIMD::GetKernels().copy_ascii(
+                                                            in.data() + i,
+                                                            in.size() - i,
+                                                            p);
+            p += ascii_length;
+            i += ascii_length - 1;
             continue;
         }
 
-        if (character <= 0x10'ffff)
+        // Ensure the character is in the range 0x80 to 0xff
+        if (((octet & 0xfe) != 0xc2) || ((i + 1) >= in.size()) ||
+            ((in[i + 1] & 0xc0) != 0x80))
         {
-            // 11110nnn 10nnnnnn 10nnnnnn 10nnnnnn
-            *r++ = static_cast<std::uint8_t>(0xf0 | ((character >> 18) & 0x07));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character >> 12) & 0x3f));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character >>  6) & 0x3f));
-            *r++ = static_cast<std::uint8_t>(0x80 | ((character      ) & 0x3f));
-            continue;
+            return {false, 0};
         }
 
-        // We should never get to this point, as this would indicate an error
-        return {false, 0};
+        *p++ = static_cast<std::uint8_t>((octet << 6) | (in[++i] & 0x3f));
     }
 
-    return {true, static_cast<std::size_t>(r - out.data())};
+    return {true, static_cast<std::size_t>(p - out.data())};
+}
+
+/*
+ *  ConvertLatin1ToUTF16()
+ *
+ *  Description:
+ *      This function will take a span of octets in Latin-1 (ISO-8859-1)
+ *      format and convert them to UTF-16 format.  This function will not
+ *      insert byte-order-mark (BOM) octets.  The endianness is specified via
+ *      the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in Latin-1 format.  Every octet value is valid.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given Latin-1 string.  This span
+ *          MUST be at least 2x larger than the input span.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean is false only if the
+ *      output span is too small.  On success, the length value indicates the
+ *      number of octets (not characters!) in the resulting UTF-16 output
+ *      span, which is always twice the input length.
+ *
+ *  Comments:
+ *      Each Latin-1 octet is the value of the corresponding Unicode
+ *      character, so the conversion is performed entirely by the SIMD kernel.
+ */
+std::pair<bool, std::size_t> ConvertLatin1ToUTF16(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    // If the output span is an insufficient size, return an error
+    if (out.size() < in.size() * 2) return {false, 0};
+
+    SIMD::GetKernels().latin1_to_utf16(in.data(),
+                                       in.size(),
+                                       out.data(),
+                                       little_endian);
+
+    return {true, in.size() * 2};
+}
+
+/*
+ *  ConvertUTF16ToLatin1()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to Latin-1 (ISO-8859-1) format.  The UTF-16 octets must NOT have
+ *      a byte-order-mark (BOM) at the start.  The endianness is indicated via
+ *      the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.
+ *
+ *      out [out]
+ *          The Latin-1 string derived from the given UTF-16 string.  This span
+ *          MUST be at least half the length of the input span.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets in the resulting Latin-1 output span,
+ *      which is always half the input length.
+ *
+ *  Comments:
+ *      The SIMD kernel stops at the first character above 0xff, so the
+ *      conversion succeeded only if it consumed the entire input.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToLatin1(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian)
+{
+    // UTF-16 always has an even number of octets, so verify that is the case
+    if ((in.size() & 1) != 0) return {false, 0};
+
+    // If the output span is an insufficient size, return an error
+    if (out.size() < (in.size() / 2)) return {false, 0};
+
+    std::size_t consumed = SIMD::GetKernels().latin1_from_utf16(in.data(),
+                                                                in.size(),
+                                                                out.data(),
+                                                                little_endian);
+    if (consumed != in.size()) return {false, 0};
+
+    return {true, in.size() / 2};
 }
 
 /*
@@ -541,81 +2357,264 @@ std::pair<bool, std::size_t> ConvertUTF16ToUTF8(
  */
 bool IsUTF8Valid(std::span<const std::uint8_t> octets)
 {
-    std::size_t expected_utf8_remaining{};      // Number of UTF-8 octets left
-    std::uint32_t wide_character{};             // UTF-32 character
-
-    // If the input is zero length, so is the output
+    // If the input is zero length, it is valid
     if (octets.empty()) return true;
 
-    // Iterate over the span of octets
-    for (std::uint8_t octet : octets)
-    {
-        // Handle subsequent UTF-8 octets
-        if (expected_utf8_remaining > 0)
-        {
-            // Expecting a 10xxxxxx octet
-            if ((octet & 0xc0) != 0x80) return false;
+    // Validate as much of the input as possible using the SIMD kernel
+    std::size_t validated = SIMD::GetKernels().validate_utf8(octets.data(),
+                                                             octets.size());
 
-            // Append additional bits to the wide character
-            wide_character = (wide_character << 6) | (octet & 0x3f);
+    // Validate the remaining octets one at a time
+    return ValidateUTF8Scalar(octets.subspan(validated)).error ==
+           UnicodeError::None;
+}
+
+/*
+ *  ValidateUTF8()
+ *
+ *  Description:
+ *      This function will process the sequence of octets and verify that it
+ *      is a valid UTF-8 sequence as IsUTF8Valid() does, additionally
+ *      reporting where and why the sequence is invalid.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      The result of the validation.  If the sequence is valid, the error is
+ *      UnicodeError::None and the position is the length of the sequence.
+ *      Otherwise, the position is the offset of the first octet of the
+ *      invalid sequence.
+ *
+ *  Comments:
+ *      The SIMD kernels stop at a character boundary before any invalid
+ *      sequence, so the scalar code locates the error from that point
+ *      without rescanning the validated prefix.
+ */
+ValidationResult ValidateUTF8(std::span<const std::uint8_t> octets)
+{
+    // If the input is zero length, it is valid
+    if (octets.empty()) return {UnicodeError::None, 0};
 
-            // Decrement the number of expected octets remaining
-            expected_utf8_remaining--;
+    // Validate as much of the input as possible using the SIMD kernel
+    std::size_t validated = SIMD::GetKernels().validate_utf8(octets.data(),
+                                                             octets.size());
 
-            // If this is the final UTF-8 character, produce the output
-            if (expected_utf8_remaining == 0)
-            {
-                // Verify the character is <= 0x10'ffff per RFC 3629
-                if (wide_character > Unicode::Maximum_Character_Value)
-                {
-                    return false;
-                }
-
-                // Ensure the character code is not within the surrogate range
-                if ((wide_character >= Unicode::Surrogate_High_Min) &&
-                    (wide_character <= Unicode::Surrogate_Low_Max))
-                {
-                    return false;
-                }
-            }
+    // Validate the remaining octets one at a time
+    ValidationResult result = ValidateUTF8Scalar(octets.subspan(validated));
+    result.position += validated;
 
-            // Multi-octet sequence is valid, so continue
-            continue;
-        }
+    return result;
+}
 
-        // Single ASCII character?
-        if (octet <= 0x7f) continue;
+/*
+ *  UTF16LengthFromUTF8()
+ *
+ *  Description:
+ *      This function will compute the number of octets required to encode
+ *      the given UTF-8 string as UTF-16.  This allows the caller to allocate
+ *      an output buffer of exactly the required size.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string to measure.
+ *
+ *  Returns:
+ *      The length in octets (not characters!) of the UTF-16 encoding of the
+ *      given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-8 (see IsUTF8Valid()).  Note that the output span
+ *      given to ConvertUTF8ToUTF16() must still be at least 2x the length
+ *      of the input span.
+ */
+std::size_t UTF16LengthFromUTF8(std::span<const std::uint8_t> in)
+{
+    return SIMD::GetKernels().utf16_length_from_utf8(in.data(), in.size());
+}
 
-        // Two octet UTF-8 sequence (110xxxxx)
-        if ((octet & 0xe0) == 0xc0)
-        {
-            wide_character = octet & 0x3f;
-            expected_utf8_remaining = 1;
-            continue;
-        }
+/*
+ *  UTF8LengthFromUTF16()
+ *
+ *  Description:
+ *      This function will compute the number of octets required to encode
+ *      the given UTF-16 string as UTF-8.  This allows the caller to allocate
+ *      an output buffer of exactly the required size.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string to measure.  An odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length in octets (not characters!) of the UTF-8 encoding of the
+ *      given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-16 (i.e., all surrogates are properly paired).
+ *      Note that the output span given to ConvertUTF16ToUTF8() must still be
+ *      at least 1.5x the length of the input span.
+ */
+std::size_t UTF8LengthFromUTF16(std::span<const std::uint8_t> in,
+                                bool little_endian)
+{
+    return SIMD::GetKernels().utf8_length_from_utf16(in.data(),
+                                                     in.size(),
+                                                     little_endian);
+}
+
+/*
+ *  CountUTF8CodePoints()
+ *
+ *  Description:
+ *      This function will count the number of code points (characters) in
+ *      the given UTF-8 string without producing any output.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string to count.
+ *
+ *  Returns:
+ *      The number of code points in the given string.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-8 (see IsUTF8Valid()).  Every octet other than a
+ *      continuation octet is counted.
+ */
+std::size_t CountUTF8CodePoints(std::span<const std::uint8_t> in)
+{
+    return SIMD::GetKernels().count_utf8_code_points(in.data(), in.size());
+}
+
+/*
+ *  CountUTF16CodePoints()
+ *
+ *  Description:
+ *      This function will count the number of code points (characters) in
+ *      the given UTF-16 string without producing any output.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string to count.  An odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points in the given string, where a surrogate
+ *      pair is counted as a single code point.
+ *
+ *  Comments:
+ *      The input is not validated and the result is only meaningful if the
+ *      input is valid UTF-16 (i.e., all surrogates are properly paired).
+ *      Every code unit other than a low surrogate is counted.
+ */
+std::size_t CountUTF16CodePoints(std::span<const std::uint8_t> in,
+                                 bool little_endian)
+{
+    return SIMD::GetKernels().count_utf16_code_points(in.data(),
+                                                      in.size(),
+                                                      little_endian);
+}
+
+/*
+ *  MeasureUTF8()
+ *
+ *  Description:
+ *      This function will verify that the given sequence of octets is a
+ *      valid UTF-8 sequence as IsUTF8Valid() does and, in the same pass over
+ *      the input, count the code points, compute the number of octets
+ *      required to encode the string as UTF-16, and determine whether the
+ *      string contains only ASCII characters.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The sequence of octets to process.
+ *
+ *  Returns:
+ *      The measurement of the string.  If the string is not valid UTF-8,
+ *      valid is false, error indicates the reason, and the remaining values
+ *      are zero.
+ *
+ *  Comments:
+ *      This produces the same results as calling IsUTF8Valid(),
+ *      CountUTF8CodePoints(), and UTF16LengthFromUTF8() in turn, but the
+ *      input is processed in blocks small enough to remain in the processor
+ *      cache, so the input is read from memory only once.
+ */
+UTF8Measurement MeasureUTF8(std::span<const std::uint8_t> octets)
+{
+    const SIMD::Kernels &kernels = SIMD::GetKernels();
+    UTF8Measurement measurement{true, true, 0, 0};
+    std::size_t position = 0;
 
-        // Three octet UTF-8 sequence (1110xxxx)
-        if ((octet & 0xf0) == 0xe0)
+    while (position < octets.size())
+    {
+        // Select the next block, ending it at a character boundary so that
+        // each block of a valid string is itself valid
+        std::size_t length = octets.size() - position;
+        if (length > Measurement_Block)
         {
-            wide_character = octet & 0x0f;
-            expected_utf8_remaining = 2;
-            continue;
+            length = SIMD::CharacterBoundary(octets.data() + position,
+                                             Measurement_Block);
         }
+        std::span<const std::uint8_t> block = octets.subspan(position, length);
 
-        // Four octet UTF-8 sequence (11110xxx)
-        if ((octet & 0xf8) == 0xf0)
+        // Validate the block, then measure it while it remains in the cache
+        ValidationResult result = ValidateUTF8(block);
+        if (result.error != UnicodeError::None)
         {
-            wide_character = octet & 0x07;
-            expected_utf8_remaining = 3;
-            continue;
+            return {false, false, 0, 0, result.error};
         }
+        measurement.code_points +=
+            kernels.count_utf8_code_points(block.data(), block.size());
+        measurement.utf16_length +=
+            kernels.utf16_length_from_utf8(block.data(), block.size());
 
-        // Any other value would be an invalid UTF-8 value
-        return false;
+        position += length;
     }
 
-    // If there are other octets expected, conversion was successful
-    return expected_utf8_remaining == 0;
+    // The string is ASCII only if every octet is a code point
+    measurement.ascii = (measurement.code_points == octets.size());
+
+    return measurement;
 }
 
+
+// Instantiate the conversion functions for each byte order
+template std::pair<bool, std::size_t>
+    ConvertUTF8ToUTF16<std::endian::little>(std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+template std::pair<bool, std::size_t>
+    ConvertUTF8ToUTF16<std::endian::big>(std::span<const std::uint8_t>,
+                                         std::span<std::uint8_t>);
+template ConversionResult
+    ConvertUTF8ToUTF16Partial<std::endian::little>(
+                                            std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+template ConversionResult
+    ConvertUTF8ToUTF16Partial<std::endian::big>(
+                                            std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+template std::pair<bool, std::size_t>
+    ConvertUTF16ToUTF8<std::endian::little>(std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+template std::pair<bool, std::size_t>
+    ConvertUTF16ToUTF8<std::endian::big>(std::span<const std::uint8_t>,
+                                         std::span<std::uint8_t>);
+template ConversionResult
+    ConvertUTF16ToUTF8Partial<std::endian::little>(
+                                            std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+template ConversionResult
+    ConvertUTF16ToUTF8Partial<std::endian::big>(
+                                            std::span<const std::uint8_t>,
+                                            std::span<std::uint8_t>);
+
 } // namespace Terra::CharUtil
@@ -0,0 +1,522 @@
+/*
+ *  parallel_utilities.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements functions that convert very large strings
+ *      between UTF-8 and UTF-16 using multiple threads.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <terra/charutil/parallel_utilities.h>
+#include <terra/charutil/character_utilities.h>
+
+namespace Terra::CharUtil
+{
+
+namespace
+{
+
+// The number of octets each thread validates before checking whether another
+// thread has found the input to be invalid
+constexpr std::size_t Validation_Block = 64 * 1024;
+
+/*
+ *  ChunkCount()
+ *
+ *  Description:
+ *      Determine the number of chunks into which the input will be split.
+ *
+ *  Parameters:
+ *      length [in]
+ *          The length of the input in octets.
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, or zero to use the number of
+ *          hardware threads.
+ *
+ *  Returns:
+ *      The number of chunks, which is one if the input should be processed
+ *      on the calling thread.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ChunkCount(std::size_t length, std::size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(std::size_t{std::thread::hardware_concurrency()},
+                           std::size_t{1});
+    }
+
+    return std::clamp(length / Min_Parallel_Chunk, std::size_t{1}, threads);
+}
+
+/*
+ *  RunParallel()
+ *
+ *  Description:
+ *      Call the given function once for each chunk, each on its own thread.
+ *
+ *  Parameters:
+ *      chunks [in]
+ *          The number of chunks.
+ *
+ *      function [in]
+ *          The function to call, which is given the index of the chunk.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The first chunk is processed on the calling thread, which returns once
+ *      all threads have completed.  If a thread cannot be started (e.g., the
+ *      system has exhausted its threads), the chunks not yet given to a
+ *      thread are processed on the calling thread instead.  The threads are
+ *      joined on every path out of this function, including if the function
+ *      throws an exception on the calling thread.
+ */
+template<typename Function>
+void RunParallel(std::size_t chunks, const Function &function)
+{
+    std::vector<std::jthread> workers;
+    std::size_t started = 1;
+
+    workers.reserve(chunks - 1);
+    try
+    {
+        for (; started < chunks; started++)
+        {
+            workers.emplace_back(function, started);
+        }
+    }
+    catch (const std::system_error &)
+    {
+        // Chunks from the one that failed to start onward are handled below
+    }
+
+    function(std::size_t{0});
+    for (std::size_t i = started; i < chunks; i++) function(i);
+
+    for (auto &worker : workers) worker.join();
+}
+
+/*
+ *  AlignUTF8()
+ *
+ *  Description:
+ *      Move the given position in a UTF-8 string back to the start of the
+ *      character it falls within.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string.
+ *
+ *      position [in]
+ *          The position to align, which must be at least three and less than
+ *          the length of the string.
+ *
+ *  Returns:
+ *      The position of the lead octet of the character.
+ *
+ *  Comments:
+ *      If there is no lead octet within three octets, the input is invalid
+ *      and the position is returned unchanged, as the span starting with a
+ *      continuation octet will then be found to be invalid.
+ */
+std::size_t AlignUTF8(std::span<const std::uint8_t> in, std::size_t position)
+{
+    for (std::size_t i = 0; i <= 3; i++)
+    {
+        if ((in[position - i] & 0xc0) != 0x80) return position - i;
+    }
+
+    return position;
+}
+
+/*
+ *  SplitUTF8()
+ *
+ *  Description:
+ *      Determine where to split the given UTF-8 string into chunks of
+ *      roughly equal length such that no character is split.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 string to split.
+ *
+ *      chunks [in]
+ *          The number of chunks.
+ *
+ *  Returns:
+ *      The offset of the start of each chunk, followed by the input length.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<std::size_t> SplitUTF8(std::span<const std::uint8_t> in,
+                                   std::size_t chunks)
+{
+    std::vector<std::size_t> boundaries(chunks + 1);
+
+    for (std::size_t i = 1; i < chunks; i++)
+    {
+        boundaries[i] = AlignUTF8(in, in.size() / chunks * i);
+    }
+    boundaries[chunks] = in.size();
+
+    return boundaries;
+}
+
+/*
+ *  SplitUTF16()
+ *
+ *  Description:
+ *      Determine where to split the given UTF-16 string into chunks of
+ *      roughly equal length such that no surrogate pair is split.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 string to split, which has an even length.
+ *
+ *      chunks [in]
+ *          The number of chunks.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The offset of the start of each chunk, followed by the input length.
+ *
+ *  Comments:
+ *      A split that falls on a low surrogate is moved back by one code unit
+ *      so that the chunk starts with the high surrogate.  If there is no high
+ *      surrogate there, the low surrogate is unpaired and the chunk will fail
+ *      to convert as it should.
+ */
+std::vector<std::size_t> SplitUTF16(std::span<const std::uint8_t> in,
+                                    std::size_t chunks,
+                                    bool little_endian)
+{
+    std::vector<std::size_t> boundaries(chunks + 1);
+
+    for (std::size_t i = 1; i < chunks; i++)
+    {
+        std::size_t boundary = (in.size() / 2) / chunks * i * 2;
+        std::uint8_t high_octet = in[boundary + (little_endian ? 1 : 0)];
+
+        if ((high_octet & 0xfc) == 0xdc) boundary -= 2;
+
+        boundaries[i] = boundary;
+    }
+    boundaries[chunks] = in.size();
+
+    return boundaries;
+}
+
+/*
+ *  ConvertChunks()
+ *
+ *  Description:
+ *      Convert each chunk of the input concurrently, writing the output of
+ *      each chunk directly to its position in the output span.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The string to convert.
+ *
+ *      out [out]
+ *          The span into which the converted string is written.
+ *
+ *      boundaries [in]
+ *          The offset of the start of each chunk, followed by the input
+ *          length.
+ *
+ *      length [in]
+ *          A function returning the converted length of a chunk.
+ *
+ *      convert [in]
+ *          A function converting a chunk into the given output span.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the string and the length is the number of octets
+ *      in the converted string.
+ *
+ *  Comments:
+ *      The converted length of each chunk is computed first so that the
+ *      position of each chunk in the output is known.  The lengths are only
+ *      meaningful for valid input, but invalid input will then either fail to
+ *      convert or produce a length different from the one computed.
+ *
+ *      The threads are started twice, once for each pass, rather than once
+ *      with a barrier between the passes.  Starting a thread costs far less
+ *      than processing a chunk of at least Min_Parallel_Chunk octets, and a
+ *      barrier would require every chunk to have its own thread, which is
+ *      not assured when a thread cannot be started (see RunParallel()).
+ */
+template<typename Length, typename Convert>
+std::pair<bool, std::size_t> ConvertChunks(
+                                    std::span<const std::uint8_t> in,
+                                    std::span<std::uint8_t> out,
+                                    const std::vector<std::size_t> &boundaries,
+                                    const Length &length,
+                                    const Convert &convert)
+{
+    std::size_t chunks = boundaries.size() - 1;
+    std::vector<std::size_t> offsets(chunks + 1);
+    std::vector<std::uint8_t> succeeded(chunks);
+
+    // Compute the converted length of each chunk
+    RunParallel(chunks,
+                [&](std::size_t i)
+                {
+                    offsets[i + 1] = length(
+                        in.subspan(boundaries[i],
+                                   boundaries[i + 1] - boundaries[i]));
+                });
+
+    // Compute the position of each chunk in the output
+    for (std::size_t i = 0; i < chunks; i++) offsets[i + 1] += offsets[i];
+    if (offsets[chunks] > out.size()) return {false, 0};
+
+    // Convert each chunk into its position in the output
+    RunParallel(chunks,
+                [&](std::size_t i)
+                {
+                    std::span<const std::uint8_t> chunk =
+                        in.subspan(boundaries[i],
+                                   boundaries[i + 1] - boundaries[i]);
+                    ConversionResult result = convert(
+                        chunk,
+                        out.subspan(offsets[i], offsets[i + 1] - offsets[i]));
+                    succeeded[i] = result.success &&
+                                   (result.consumed == chunk.size()) &&
+                                   (result.produced ==
+                                    (offsets[i + 1] - offsets[i]));
+                });
+
+    if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end())
+    {
+        return {false, 0};
+    }
+
+    return {true, offsets[chunks]};
+}
+
+} // namespace
+
+/*
+ *  ConvertUTF8ToUTF16Parallel()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-8 format and convert
+ *      them to UTF-16 format using multiple threads.  This function will not
+ *      insert byte-order-mark (BOM) octets.  The endianness is specified via
+ *      the third parameter.
+ *
+ *  Parameters:
+ *      in [in]
+ *          Original string in UTF-8 format.
+ *
+ *      out [out]
+ *          The UTF-16 string derived from the given UTF-8 string.  This span
+ *          MUST be at least 2x larger than the input span, though the encoding
+ *          length might be smaller.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-8 string.  Only if the return result is true
+ *      does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-16 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertUTF8ToUTF16Parallel(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian,
+                                            std::size_t threads)
+{
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // Ensure the output span is sufficiently large
+    if (out.size() < (in.size() * 2)) return {false, 0};
+
+    // Short inputs are converted on the calling thread
+    std::size_t chunks = ChunkCount(in.size(), threads);
+    if (chunks == 1) return ConvertUTF8ToUTF16(in, out, little_endian);
+
+    return ConvertChunks(
+        in,
+        out,
+        SplitUTF8(in, chunks),
+        [](std::span<const std::uint8_t> chunk)
+        {
+            return UTF16LengthFromUTF8(chunk);
+        },
+        [little_endian](std::span<const std::uint8_t> chunk,
+                        std::span<std::uint8_t> chunk_out)
+        {
+            return ConvertUTF8ToUTF16Partial(chunk, chunk_out, little_endian);
+        });
+}
+
+/*
+ *  ConvertUTF16ToUTF8Parallel()
+ *
+ *  Description:
+ *      This function will take a span of octets in UTF-16 format and convert
+ *      them to UTF-8 format using multiple threads.  The UTF-16 octets must
+ *      NOT have a byte-order-mark (BOM) at the start.  The endianness is
+ *      indicated via the third argument.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The user-provided UTF-16 string.  The length must not be greater
+ *          than Max_UTF16_String.
+ *
+ *      out [out]
+ *          The UTF-8 string derived from the given UTF-16 string.  This span
+ *          MUST be 50% larger than the length of the input string.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      A boolean and length pair, where the boolean indicates success or
+ *      failure to convert the UTF-16 string.  Only if the return result is
+ *      true does the length value have meaning.  On success, the length value
+ *      indicates the number of octets (not characters!) in the resulting
+ *      UTF-8 output span.
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<bool, std::size_t> ConvertUTF16ToUTF8Parallel(
+                                            std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out,
+                                            bool little_endian,
+                                            std::size_t threads)
+{
+    // If the input is zero length, so is the output
+    if (in.empty()) return {true, 0};
+
+    // UTF-16 always has an even number of octets, so verify that is the case
+    if ((in.size() & 1) != 0) return {false, 0};
+
+    // Reject UTF-16 strings that are to long
+    if (in.size() > Max_UTF16_String) return {false, 0};
+
+    // If the output span is an insufficient size, return an error (1.5x size)
+    if (out.size() < (in.size() + (in.size() >> 1))) return {false, 0};
+
+    // Short inputs are converted on the calling thread
+    std::size_t chunks = ChunkCount(in.size(), threads);
+    if (chunks == 1) return ConvertUTF16ToUTF8(in, out, little_endian);
+
+    return ConvertChunks(
+        in,
+        out,
+        SplitUTF16(in, chunks, little_endian),
+        [little_endian](std::span<const std::uint8_t> chunk)
+        {
+            return UTF8LengthFromUTF16(chunk, little_endian);
+        },
+        [little_endian](std::span<const std::uint8_t> chunk,
+                        std::span<std::uint8_t> chunk_out)
+        {
+            return ConvertUTF16ToUTF8Partial(chunk, chunk_out, little_endian);
+        });
+}
+
+/*
+ *  IsUTF8ValidParallel()
+ *
+ *  Description:
+ *      This function will check to see if the given span of octets is a
+ *      valid UTF-8 string using multiple threads.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The span of octets to check.
+ *
+ *      threads [in]
+ *          The maximum number of threads to use, including the calling
+ *          thread.  If zero, the number of hardware threads is used.
+ *
+ *  Returns:
+ *      True if the string is valid UTF-8, false if not.
+ *
+ *  Comments:
+ *      Each thread validates its chunk in blocks that end on a character
+ *      boundary, and stops as soon as any thread finds an invalid sequence.
+ */
+bool IsUTF8ValidParallel(std::span<const std::uint8_t> octets,
+                         std::size_t threads)
+{
+    // Short inputs are validated on the calling thread
+    std::size_t chunks = ChunkCount(octets.size(), threads);
+    if (chunks == 1) return IsUTF8Valid(octets);
+
+    std::vector<std::size_t> boundaries = SplitUTF8(octets, chunks);
+    std::atomic<bool> invalid{false};
+
+    RunParallel(chunks,
+                [&](std::size_t i)
+                {
+                    std::size_t position = boundaries[i];
+
+                    while ((position < boundaries[i + 1]) &&
+                           !invalid.load(std::memory_order_relaxed))
+                    {
+                        // Validate up to the next character boundary
+                        std::size_t next = boundaries[i + 1];
+                        if ((next - position) > Validation_Block)
+                        {
+                            next = AlignUTF8(octets,
+                                             position + Validation_Block);
+                        }
+
+                        if (!IsUTF8Valid(
+                                octets.subspan(position, next - position)))
+                        {
+                            invalid.store(true, std::memory_order_relaxed);
+                        }
+
+                        position = next;
+                    }
+                });
+
+    return !invalid.load();
+}
+
+} // namespace Terra::CharUtil
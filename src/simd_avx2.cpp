@@ -0,0 +1,1160 @@
+/*
+ *  simd_avx2.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      SIMD kernels for processors supporting AVX2.  These process 64 octets
+ *      per iteration as two 256-bit vectors.
+ *
+ *  Portability Issues:
+ *      This code is only compiled for x86-64 processors.  The functions are
+ *      compiled for the AVX2 instruction set and must only be called when
+ *      the processor supports that instruction set.
+ */
+
+#include "simd_dispatch.h"
+
+#ifdef CHARUTIL_X86_64
+
+#include <algorithm>
+#include <bit>
+#include <immintrin.h>
+#include "simd_utf8_tables.h"
+
+#define CHARUTIL_AVX2 CHARUTIL_TARGET("avx2,bmi,bmi2")
+
+namespace Terra::CharUtil::SIMD
+{
+
+namespace
+{
+
+/*
+ *  Prev()
+ *
+ *  Description:
+ *      Return a vector containing the input shifted forward by N octets,
+ *      with the first N octets taken from the end of the previous input.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The current input vector.
+ *
+ *      prev_input [in]
+ *          The previous input vector.
+ *
+ *  Returns:
+ *      The shifted vector.
+ *
+ *  Comments:
+ *      None.
+ */
+template<int N>
+CHARUTIL_AVX2 inline __m256i Prev(__m256i input, __m256i prev_input)
+{
+    return _mm256_alignr_epi8(
+        input,
+        _mm256_permute2x128_si256(prev_input, input, 0x21),
+        16 - N);
+}
+
+/*
+ *  LoadTable()
+ *
+ *  Description:
+ *      Load a 16-entry lookup table into both 128-bit lanes of a vector.
+ *
+ *  Parameters:
+ *      table [in]
+ *          The lookup table.
+ *
+ *  Returns:
+ *      The vector containing the table.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX2 inline __m256i LoadTable(const std::uint8_t (&table)[16])
+{
+    return _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(table)));
+}
+
+/*
+ *  CheckUTF8Octets()
+ *
+ *  Description:
+ *      Check the given vector of octets for UTF-8 encoding errors, taking
+ *      into account the octets in the previous vector.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector of octets to check.
+ *
+ *      prev_input [in]
+ *          The vector of octets that precedes the input.
+ *
+ *  Returns:
+ *      A vector that is non-zero if any encoding error was found.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX2 __m256i CheckUTF8Octets(__m256i input, __m256i prev_input)
+{
+    const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+
+    // Check for errors involving pairs of adjacent octets
+    __m256i prev1 = Prev<1>(input, prev_input);
+    __m256i byte_1_high = _mm256_shuffle_epi8(
+        LoadTable(UTF8Tables::Byte_1_High),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask));
+    __m256i byte_1_low = _mm256_shuffle_epi8(
+        LoadTable(UTF8Tables::Byte_1_Low),
+        _mm256_and_si256(prev1, low_nibble_mask));
+    __m256i byte_2_high = _mm256_shuffle_epi8(
+        LoadTable(UTF8Tables::Byte_2_High),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble_mask));
+    __m256i special_cases = _mm256_and_si256(
+        _mm256_and_si256(byte_1_high, byte_1_low),
+        byte_2_high);
+
+    // Identify the octets that must be the third or fourth octet of a
+    // sequence (only values >= 0xe0 / 0xf0 will be >= 0x80 after subtraction)
+    __m256i prev2 = Prev<2>(input, prev_input);
+    __m256i prev3 = Prev<3>(input, prev_input);
+    __m256i is_third_octet = _mm256_subs_epu8(
+        prev2,
+        _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    __m256i is_fourth_octet = _mm256_subs_epu8(
+        prev3,
+        _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    __m256i must_be_continuation = _mm256_and_si256(
+        _mm256_or_si256(is_third_octet, is_fourth_octet),
+        _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    // Continuation octets must appear exactly where expected
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+/*
+ *  IsIncomplete()
+ *
+ *  Description:
+ *      Determine whether the given vector ends with an incomplete multi-octet
+ *      sequence.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector of octets to check.
+ *
+ *  Returns:
+ *      A vector that is non-zero if the input ends with an incomplete
+ *      sequence.
+ *
+ *  Comments:
+ *      Only the upper 128-bit lane of the maximum values is significant, so
+ *      the lower lane is filled with 0xff.
+ */
+CHARUTIL_AVX2 inline __m256i IsIncomplete(__m256i input)
+{
+    const __m256i maximum = _mm256_inserti128_si256(
+        _mm256_set1_epi8(static_cast<char>(0xff)),
+        _mm_load_si128(reinterpret_cast<const __m128i *>(
+            UTF8Tables::Incomplete_Maximum)),
+        1);
+
+    return _mm256_subs_epu8(input, maximum);
+}
+
+} // namespace
+
+/*
+ *  ValidateUTF8_AVX2()
+ *
+ *  Description:
+ *      Validate the given UTF-8 octets using AVX2 instructions, returning
+ *      the length of the prefix that is known to be valid.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to validate.
+ *
+ *      length [in]
+ *          The number of octets to validate.
+ *
+ *  Returns:
+ *      The length of the valid prefix, which always ends on a character
+ *      boundary.  This will be less than the length if an error was found
+ *      or if there are fewer than 64 octets remaining to be processed.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX2 std::size_t ValidateUTF8_AVX2(const std::uint8_t *octets,
+                                            std::size_t length)
+{
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m256i *p = reinterpret_cast<const __m256i *>(octets + i);
+        __m256i input_0 = _mm256_loadu_si256(p);
+        __m256i input_1 = _mm256_loadu_si256(p + 1);
+
+        // If all octets are ASCII, the only possible error is an incomplete
+        // sequence at the end of the previous block
+        if (_mm256_movemask_epi8(_mm256_or_si256(input_0, input_1)) == 0)
+        {
+            if (!_mm256_testz_si256(prev_incomplete, prev_incomplete)) break;
+            prev_input = _mm256_setzero_si256();
+            continue;
+        }
+
+        // Check each vector against the one preceding it
+        __m256i error = _mm256_or_si256(CheckUTF8Octets(input_0, prev_input),
+                                        CheckUTF8Octets(input_1, input_0));
+        if (!_mm256_testz_si256(error, error)) break;
+
+        prev_incomplete = IsIncomplete(input_1);
+        prev_input = input_1;
+    }
+
+    return CharacterBoundary(octets, i);
+}
+
+/*
+ *  ConvertASCIIToUTF16_AVX2()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-16 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is widened
+ *      and written, but only the leading ASCII octets are reported as
+ *      converted.  The remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_AVX2 std::size_t ConvertASCIIToUTF16_AVX2(const std::uint8_t *in,
+                                                   std::size_t length,
+                                                   std::uint8_t *out,
+                                                   bool little_endian)
+{
+    const unsigned shift = little_endian ? 0 : 8;
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        __m256i input =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        unsigned non_ascii =
+            static_cast<unsigned>(_mm256_movemask_epi8(input));
+
+        // Zero-extend each octet and shift into place for big endian output
+        __m256i low = _mm256_sll_epi16(
+            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)),
+            _mm_cvtsi32_si128(static_cast<int>(shift)));
+        __m256i high = _mm256_sll_epi16(
+            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)),
+            _mm_cvtsi32_si128(static_cast<int>(shift)));
+        __m256i *p = reinterpret_cast<__m256i *>(out + (i * 2));
+        _mm256_storeu_si256(p, low);
+        _mm256_storeu_si256(p + 1, high);
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(non_ascii));
+        }
+    }
+
+    // Process the remaining octets
+    return i + ConvertASCIIToUTF16_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 2),
+                                        little_endian);
+}
+
+/*
+ *  ConvertASCIIFromUTF16_AVX2()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-16
+ *      input to UTF-8 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII character, the remaining characters
+ *      are handled by ConvertASCIIFromUTF16_SWAR().
+ */
+CHARUTIL_AVX2 std::size_t ConvertASCIIFromUTF16_AVX2(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    // Bits that must be zero for a character to be ASCII, as each character
+    // appears when loaded into a 16-bit lane
+    const __m256i non_ascii =
+        _mm256_set1_epi16(static_cast<short>(little_endian ? 0xff80 : 0x80ff));
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m256i *p = reinterpret_cast<const __m256i *>(in + i);
+        __m256i input_0 = _mm256_loadu_si256(p);
+        __m256i input_1 = _mm256_loadu_si256(p + 1);
+
+        if (!_mm256_testz_si256(_mm256_or_si256(input_0, input_1), non_ascii))
+        {
+            break;
+        }
+
+        // Move each character into the low octet of its lane and pack,
+        // restoring the order of the 64-bit quarters afterward since the
+        // packing operates within each 128-bit lane
+        if (!little_endian)
+        {
+            input_0 = _mm256_srli_epi16(input_0, 8);
+            input_1 = _mm256_srli_epi16(input_1, 8);
+        }
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(out + (i / 2)),
+            _mm256_permute4x64_epi64(_mm256_packus_epi16(input_0, input_1),
+                                     0xd8));
+    }
+
+    // Process the remaining characters
+    return i + ConvertASCIIFromUTF16_SWAR(in + i,
+                                          length - i,
+                                          out + (i / 2),
+                                          little_endian);
+}
+
+/*
+ *  UTF16LengthFromUTF8_AVX2()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-8
+ *      input as UTF-16 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.
+ *
+ *  Returns:
+ *      The length of the UTF-16 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.  Counts
+ *      are accumulated in 8-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_AVX2 std::size_t UTF16LengthFromUTF8_AVX2(const std::uint8_t *octets,
+                                                   std::size_t length)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i continuation_max = _mm256_set1_epi8(static_cast<char>(0xbf));
+    const __m256i four_octet_min = _mm256_set1_epi8(static_cast<char>(0xf0));
+    __m256i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 32)
+    {
+        // Each iteration adds at most two to each counter
+        std::size_t iterations = std::min<std::size_t>((length - i) / 32, 127);
+        __m256i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 32)
+        {
+            __m256i input = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(octets + i));
+
+            // Count octets that are not continuation octets (10xxxxxx) and
+            // those needing a surrogate pair (11110xxx)
+            __m256i non_continuation =
+                _mm256_cmpgt_epi8(input, continuation_max);
+            __m256i four_octet = _mm256_cmpeq_epi8(
+                _mm256_max_epu8(input, four_octet_min),
+                input);
+            counts = _mm256_sub_epi8(counts, non_continuation);
+            counts = _mm256_sub_epi8(counts, four_octet);
+        }
+
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counts, zero));
+    }
+
+    // Sum the totals and process the remaining octets
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+    std::size_t characters = 0;
+    for (std::uint64_t lane : lanes) characters += lane;
+
+    return (characters * 2) + UTF16LengthFromUTF8_SWAR(octets + i, length - i);
+}
+
+/*
+ *  UTF8LengthFromUTF16_AVX2()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-16
+ *      input as UTF-8 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length of the UTF-8 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.  Counts
+ *      are accumulated in 16-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_AVX2 std::size_t UTF8LengthFromUTF16_AVX2(const std::uint8_t *in,
+                                                   std::size_t length,
+                                                   bool little_endian)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i two_octet_min = _mm256_set1_epi16(0x80);
+    const __m256i three_octet_min = _mm256_set1_epi16(0x800);
+    const __m256i surrogate_mask =
+        _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i surrogate_min = _mm256_set1_epi16(static_cast<short>(0xd800));
+    __m256i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 32)
+    {
+        // Each iteration adds at most two to each counter
+        std::size_t iterations =
+            std::min<std::size_t>((length - i) / 32, 16383);
+        __m256i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 32)
+        {
+            __m256i input =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            if (!little_endian)
+            {
+                input = _mm256_or_si256(_mm256_slli_epi16(input, 8),
+                                     _mm256_srli_epi16(input, 8));
+            }
+
+            // Each character requires one octet, plus one more if >= 0x80
+            // and one more if >= 0x800; each half of a surrogate pair is
+            // counted as three octets, so one is subtracted from each
+            __m256i two_octet = _mm256_cmpeq_epi16(
+                _mm256_max_epu16(input, two_octet_min),
+                input);
+            __m256i three_octet = _mm256_cmpeq_epi16(
+                _mm256_max_epu16(input, three_octet_min),
+                input);
+            __m256i surrogate = _mm256_cmpeq_epi16(
+                _mm256_and_si256(input, surrogate_mask),
+                surrogate_min);
+            counts = _mm256_sub_epi16(counts, two_octet);
+            counts = _mm256_sub_epi16(counts, three_octet);
+            counts = _mm256_add_epi16(counts, surrogate);
+        }
+
+        // Widen the counters to 64 bits and add them to the totals
+        __m256i pairs = _mm256_madd_epi16(counts, _mm256_set1_epi16(1));
+        totals = _mm256_add_epi64(totals, _mm256_unpacklo_epi32(pairs, zero));
+        totals = _mm256_add_epi64(totals, _mm256_unpackhi_epi32(pairs, zero));
+    }
+
+    // Sum the totals and process the remaining characters
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+    std::size_t utf8_length = i / 2;
+    for (std::uint64_t lane : lanes) utf8_length += lane;
+
+    return utf8_length +
+           UTF8LengthFromUTF16_SWAR(in + i, length - i, little_endian);
+}
+
+/*
+ *  CountUTF8CodePoints_AVX2()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-8 input using
+ *      AVX2 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.  Counts
+ *      are accumulated in 8-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_AVX2 std::size_t CountUTF8CodePoints_AVX2(const std::uint8_t *octets,
+                                                   std::size_t length)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i continuation_max = _mm256_set1_epi8(static_cast<char>(0xbf));
+    __m256i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 32)
+    {
+        // Each iteration adds at most one to each counter
+        std::size_t iterations = std::min<std::size_t>((length - i) / 32, 255);
+        __m256i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 32)
+        {
+            __m256i input = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(octets + i));
+
+            // Count octets that are not continuation octets (10xxxxxx)
+            counts = _mm256_sub_epi8(counts,
+                                  _mm256_cmpgt_epi8(input, continuation_max));
+        }
+
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counts, zero));
+    }
+
+    // Sum the totals and process the remaining octets
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+    std::size_t code_points = 0;
+    for (std::uint64_t lane : lanes) code_points += lane;
+
+    return code_points + CountUTF8CodePoints_SWAR(octets + i, length - i);
+}
+
+/*
+ *  CountUTF16CodePoints_AVX2()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-16 input using
+ *      AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.  Counts
+ *      are accumulated in 16-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_AVX2 std::size_t CountUTF16CodePoints_AVX2(const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    bool little_endian)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i low_surrogate_mask =
+        _mm256_set1_epi16(static_cast<short>(0xfc00));
+    const __m256i low_surrogate_min =
+        _mm256_set1_epi16(static_cast<short>(0xdc00));
+    __m256i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 32)
+    {
+        // Each iteration adds at most one to each counter
+        std::size_t iterations =
+            std::min<std::size_t>((length - i) / 32, 32767);
+        __m256i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 32)
+        {
+            __m256i input =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            if (!little_endian)
+            {
+                input = _mm256_or_si256(_mm256_slli_epi16(input, 8),
+                                        _mm256_srli_epi16(input, 8));
+            }
+
+            // Every code unit is a code point except for low surrogates,
+            // which complete the code point started by a high surrogate
+            counts = _mm256_sub_epi16(
+                counts,
+                _mm256_cmpeq_epi16(_mm256_and_si256(input, low_surrogate_mask),
+                                   low_surrogate_min));
+        }
+
+        // Widen the counters to 64 bits and add them to the totals
+        __m256i pairs = _mm256_madd_epi16(counts, _mm256_set1_epi16(1));
+        totals = _mm256_add_epi64(totals, _mm256_unpacklo_epi32(pairs, zero));
+        totals = _mm256_add_epi64(totals, _mm256_unpackhi_epi32(pairs, zero));
+    }
+
+    // Sum the totals and process the remaining characters
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+    std::size_t low_surrogates = 0;
+    for (std::uint64_t lane : lanes) low_surrogates += lane;
+
+    return (i / 2) - low_surrogates +
+           CountUTF16CodePoints_SWAR(in + i, length - i, little_endian);
+}
+
+/*
+ *  ConvertASCIIToUTF32_AVX2()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-32 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least four times the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is widened
+ *      and written, but only the leading ASCII octets are reported as
+ *      converted.  The remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_AVX2 std::size_t ConvertASCIIToUTF32_AVX2(const std::uint8_t *in,
+                                                   std::size_t length,
+                                                   std::uint8_t *out,
+                                                   bool little_endian)
+{
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 24);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        __m256i input =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        unsigned non_ascii =
+            static_cast<unsigned>(_mm256_movemask_epi8(input));
+        __m128i low = _mm256_castsi256_si128(input);
+        __m128i high = _mm256_extracti128_si256(input, 1);
+
+        // Zero-extend each octet and shift into place for big endian output
+        __m256i *p = reinterpret_cast<__m256i *>(out + (i * 4));
+        _mm256_storeu_si256(p,
+                            _mm256_sll_epi32(_mm256_cvtepu8_epi32(low),
+                                             shift));
+        _mm256_storeu_si256(p + 1,
+                            _mm256_sll_epi32(
+                                _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)),
+                                shift));
+        _mm256_storeu_si256(p + 2,
+                            _mm256_sll_epi32(_mm256_cvtepu8_epi32(high),
+                                             shift));
+        _mm256_storeu_si256(p + 3,
+                            _mm256_sll_epi32(
+                                _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)),
+                                shift));
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(non_ascii));
+        }
+    }
+
+    // Process the remaining octets
+    return i + ConvertASCIIToUTF32_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 4),
+                                        little_endian);
+}
+
+/*
+ *  ConvertASCIIFromUTF32_AVX2()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-32
+ *      input to UTF-8 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least one quarter the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII character, the remaining characters
+ *      are handled by ConvertASCIIFromUTF32_SWAR().
+ */
+CHARUTIL_AVX2 std::size_t ConvertASCIIFromUTF32_AVX2(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    // Bits that must be zero for a character to be ASCII, as each character
+    // appears when loaded into a 32-bit lane
+    const __m256i non_ascii = _mm256_set1_epi32(
+        static_cast<int>(little_endian ? 0xffff'ff80 : 0x80ff'ffff));
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 24);
+
+    // Order in which to gather the 32-bit groups of octets after packing,
+    // since the packing operates within each 128-bit lane
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 128; i += 128)
+    {
+        const __m256i *p = reinterpret_cast<const __m256i *>(in + i);
+        __m256i input_0 = _mm256_loadu_si256(p);
+        __m256i input_1 = _mm256_loadu_si256(p + 1);
+        __m256i input_2 = _mm256_loadu_si256(p + 2);
+        __m256i input_3 = _mm256_loadu_si256(p + 3);
+
+        if (!_mm256_testz_si256(
+                _mm256_or_si256(_mm256_or_si256(input_0, input_1),
+                                _mm256_or_si256(input_2, input_3)),
+                non_ascii))
+        {
+            break;
+        }
+
+        // Move each character into the low octet of its lane and pack
+        input_0 = _mm256_srl_epi32(input_0, shift);
+        input_1 = _mm256_srl_epi32(input_1, shift);
+        input_2 = _mm256_srl_epi32(input_2, shift);
+        input_3 = _mm256_srl_epi32(input_3, shift);
+        __m256i packed =
+            _mm256_packus_epi16(_mm256_packus_epi32(input_0, input_1),
+                                _mm256_packus_epi32(input_2, input_3));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i / 4)),
+                            _mm256_permutevar8x32_epi32(packed, order));
+    }
+
+    // Process the remaining characters
+    return i + ConvertASCIIFromUTF32_SWAR(in + i,
+                                          length - i,
+                                          out + (i / 4),
+                                          little_endian);
+}
+
+/*
+ *  ConvertUTF16ToUTF32_AVX2()
+ *
+ *  Description:
+ *      Convert the run of characters that are not surrogates at the start of
+ *      the given UTF-16 input to UTF-32 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 and UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      When a block contains a surrogate, the remaining characters are
+ *      handled by ConvertUTF16ToUTF32_SWAR().
+ */
+CHARUTIL_AVX2 std::size_t ConvertUTF16ToUTF32_AVX2(const std::uint8_t *in,
+                                                   std::size_t length,
+                                                   std::uint8_t *out,
+                                                   bool little_endian)
+{
+    // Bits that identify a surrogate, as each character appears when loaded
+    // into a 16-bit lane
+    const __m256i surrogate_mask =
+        _mm256_set1_epi16(static_cast<short>(little_endian ? 0xf800 : 0x00f8));
+    const __m256i surrogate_min =
+        _mm256_set1_epi16(static_cast<short>(little_endian ? 0xd800 : 0x00d8));
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 16);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        __m256i input =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        __m256i surrogate = _mm256_cmpeq_epi16(
+            _mm256_and_si256(input, surrogate_mask),
+            surrogate_min);
+        if (!_mm256_testz_si256(surrogate, surrogate)) break;
+
+        // Zero-extend each character; a big endian character is shifted
+        // into the upper half of its lane
+        __m256i *p = reinterpret_cast<__m256i *>(out + (i * 2));
+        _mm256_storeu_si256(
+            p,
+            _mm256_sll_epi32(
+                _mm256_cvtepu16_epi32(_mm256_castsi256_si128(input)),
+                shift));
+        _mm256_storeu_si256(
+            p + 1,
+            _mm256_sll_epi32(
+                _mm256_cvtepu16_epi32(_mm256_extracti128_si256(input, 1)),
+                shift));
+    }
+
+    // Process the remaining characters
+    return i + ConvertUTF16ToUTF32_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 2),
+                                        little_endian);
+}
+
+/*
+ *  ConvertUTF32ToUTF16_AVX2()
+ *
+ *  Description:
+ *      Convert the run of characters in the Basic Multilingual Plane (other
+ *      than surrogates) at the start of the given UTF-32 input to UTF-16
+ *      using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 and UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of characters converted.
+ *
+ *  Comments:
+ *      When a block contains any other character, the remaining characters
+ *      are handled by ConvertUTF32ToUTF16_SWAR().
+ */
+CHARUTIL_AVX2 std::size_t ConvertUTF32ToUTF16_AVX2(const std::uint8_t *in,
+                                                   std::size_t length,
+                                                   std::uint8_t *out,
+                                                   bool little_endian)
+{
+    // Bits that must be zero for a character to be in the BMP and the bits
+    // that identify a surrogate, as each character appears when loaded into
+    // a 32-bit lane
+    const __m256i non_bmp = _mm256_set1_epi32(
+        static_cast<int>(little_endian ? 0xffff'0000 : 0x0000'ffff));
+    const __m256i surrogate_mask =
+        _mm256_set1_epi32(little_endian ? 0xf800 : 0xf8'0000);
+    const __m256i surrogate_min =
+        _mm256_set1_epi32(little_endian ? 0xd800 : 0xd8'0000);
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 16);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m256i *p = reinterpret_cast<const __m256i *>(in + i);
+        __m256i input_0 = _mm256_loadu_si256(p);
+        __m256i input_1 = _mm256_loadu_si256(p + 1);
+
+        __m256i surrogate = _mm256_or_si256(
+            _mm256_cmpeq_epi32(_mm256_and_si256(input_0, surrogate_mask),
+                               surrogate_min),
+            _mm256_cmpeq_epi32(_mm256_and_si256(input_1, surrogate_mask),
+                               surrogate_min));
+        if (!_mm256_testz_si256(_mm256_or_si256(input_0, input_1), non_bmp) ||
+            !_mm256_testz_si256(surrogate, surrogate))
+        {
+            break;
+        }
+
+        // Move each character into the low half of its lane and pack,
+        // restoring the order of the 64-bit quarters afterward since the
+        // packing operates within each 128-bit lane
+        input_0 = _mm256_srl_epi32(input_0, shift);
+        input_1 = _mm256_srl_epi32(input_1, shift);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(out + (i / 2)),
+            _mm256_permute4x64_epi64(_mm256_packus_epi32(input_0, input_1),
+                                     0xd8));
+    }
+
+    // Process the remaining characters
+    return i + ConvertUTF32ToUTF16_SWAR(in + i,
+                                        length - i,
+                                        out + (i / 2),
+                                        little_endian);
+}
+
+/*
+ *  CopyASCII_AVX2()
+ *
+ *  Description:
+ *      Copy the run of ASCII characters at the start of the given input
+ *      using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The octets to copy.
+ *
+ *      length [in]
+ *          The number of octets available to copy.
+ *
+ *      out [out]
+ *          The buffer into which to copy the octets.  This must be at least
+ *          the input length.
+ *
+ *  Returns:
+ *      The number of ASCII characters copied.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is copied,
+ *      but only the leading ASCII octets are reported as copied.  The
+ *      remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_AVX2 std::size_t CopyASCII_AVX2(const std::uint8_t *in,
+                                         std::size_t length,
+                                         std::uint8_t *out)
+{
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        __m256i input =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        unsigned non_ascii =
+            static_cast<unsigned>(_mm256_movemask_epi8(input));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), input);
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(non_ascii));
+        }
+    }
+
+    // Process the remaining octets
+    return i + CopyASCII_SWAR(in + i, length - i, out + i);
+}
+
+/*
+ *  ConvertLatin1ToUTF16_AVX2()
+ *
+ *  Description:
+ *      Convert the given Latin-1 input to UTF-16 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The Latin-1 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX2 void ConvertLatin1ToUTF16_AVX2(const std::uint8_t *in,
+                                             std::size_t length,
+                                             std::uint8_t *out,
+                                             bool little_endian)
+{
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 8);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        __m256i input =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+
+        // Zero-extend each octet and shift into place for big endian output
+        __m256i low = _mm256_sll_epi16(
+            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)),
+            shift);
+        __m256i high = _mm256_sll_epi16(
+            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)),
+            shift);
+        __m256i *p = reinterpret_cast<__m256i *>(out + (i * 2));
+        _mm256_storeu_si256(p, low);
+        _mm256_storeu_si256(p + 1, high);
+    }
+
+    // Process the remaining octets
+    ConvertLatin1ToUTF16_SWAR(in + i, length - i, out + (i * 2), little_endian);
+}
+
+/*
+ *  ConvertLatin1FromUTF16_AVX2()
+ *
+ *  Description:
+ *      Convert the run of characters no greater than 0xff at the start of the
+ *      given UTF-16 input to Latin-1 using AVX2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the Latin-1 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      When a block contains a character above 0xff, the remaining characters
+ *      are handled by ConvertLatin1FromUTF16_SWAR().
+ */
+CHARUTIL_AVX2 std::size_t ConvertLatin1FromUTF16_AVX2(const std::uint8_t *in,
+                                                      std::size_t length,
+                                                      std::uint8_t *out,
+                                                      bool little_endian)
+{
+    // Bits that must be zero for a character to be Latin-1, as each
+    // character appears when loaded into a 16-bit lane
+    const __m256i non_latin1 =
+        _mm256_set1_epi16(static_cast<short>(little_endian ? 0xff00 : 0x00ff));
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m256i *p = reinterpret_cast<const __m256i *>(in + i);
+        __m256i input_0 = _mm256_loadu_si256(p);
+        __m256i input_1 = _mm256_loadu_si256(p + 1);
+
+        if (!_mm256_testz_si256(_mm256_or_si256(input_0, input_1),
+                                non_latin1))
+        {
+            break;
+        }
+
+        // Move each character into the low octet of its lane and pack,
+        // restoring the order of the 64-bit quarters afterward since the
+        // packing operates within each 128-bit lane
+        if (!little_endian)
+        {
+            input_0 = _mm256_srli_epi16(input_0, 8);
+            input_1 = _mm256_srli_epi16(input_1, 8);
+        }
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(out + (i / 2)),
+            _mm256_permute4x64_epi64(_mm256_packus_epi16(input_0, input_1),
+                                     0xd8));
+    }
+
+    // Process the remaining characters
+    return i + ConvertLatin1FromUTF16_SWAR(in + i,
+                                           length - i,
+                                           out + (i / 2),
+                                           little_endian);
+}
+
+} // namespace Terra::CharUtil::SIMD
+
+#endif // CHARUTIL_X86_64
@@ -0,0 +1,1024 @@
+/*
+ *  simd_avx512.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      SIMD kernels for processors supporting AVX-512 (including the BW, VL,
+ *      VBMI, and VBMI2 extensions).  These process 64 octets per iteration
+ *      as a single 512-bit vector and use masked loads and stores to process
+ *      the final partial block, so no scalar processing of the end of the
+ *      input is required unless an encoding error is encountered.
+ *
+ *  Portability Issues:
+ *      This code is only compiled for x86-64 processors.  The functions are
+ *      compiled for the AVX-512 instruction set and must only be called when
+ *      the processor supports that instruction set.
+ */
+
+#include "simd_dispatch.h"
+
+#ifdef CHARUTIL_X86_64
+
+#include <array>
+#include <bit>
+#include <immintrin.h>
+#include "simd_utf8_tables.h"
+
+// GCC 12 reports false positives within its own AVX-512 intrinsic headers
+// (see GCC bug 105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#define CHARUTIL_AVX512 \
+    CHARUTIL_TARGET("avx512f,avx512bw,avx512vl,avx512vbmi,avx512vbmi2,bmi,bmi2")
+
+namespace Terra::CharUtil::SIMD
+{
+
+namespace
+{
+
+/*
+ *  MakePrevIndex()
+ *
+ *  Description:
+ *      Produce the permutation index used to shift a vector forward by N
+ *      octets, taking the first N octets from the previous vector.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The permutation index for use with _mm512_permutex2var_epi8().
+ *
+ *  Comments:
+ *      Index values 64 and higher select from the second (current) vector.
+ */
+template<std::size_t N>
+constexpr std::array<std::uint8_t, 64> MakePrevIndex()
+{
+    std::array<std::uint8_t, 64> index{};
+
+    for (std::size_t i = 0; i < 64; i++)
+    {
+        index[i] = static_cast<std::uint8_t>(64 - N + i);
+    }
+
+    return index;
+}
+
+/*
+ *  MakeGatherIndex()
+ *
+ *  Description:
+ *      Produce the permutation index used to place the four octets starting
+ *      at each of 16 consecutive positions into 16 32-bit lanes.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The permutation index for use with _mm512_permutexvar_epi8().
+ *
+ *  Comments:
+ *      Positions beyond the end of the vector are clamped to the last octet;
+ *      such octets are never part of a complete character.
+ */
+template<std::size_t Offset>
+constexpr std::array<std::uint8_t, 64> MakeGatherIndex()
+{
+    std::array<std::uint8_t, 64> index{};
+
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        for (std::size_t j = 0; j < 4; j++)
+        {
+            std::size_t position = Offset + i + j;
+            index[i * 4 + j] =
+                static_cast<std::uint8_t>(position > 63 ? 63 : position);
+        }
+    }
+
+    return index;
+}
+
+/*
+ *  MakeIncompleteMaximum()
+ *
+ *  Description:
+ *      Produce the maximum values that the octets at the end of a block
+ *      may hold without starting an incomplete sequence.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The array of maximum values.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::array<std::uint8_t, 64> MakeIncompleteMaximum()
+{
+    std::array<std::uint8_t, 64> maximum{};
+
+    for (std::size_t i = 0; i < 64; i++) maximum[i] = 0xff;
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        maximum[61 + i] = UTF8Tables::Incomplete_Maximum[13 + i];
+    }
+
+    return maximum;
+}
+
+/*
+ *  Replicate()
+ *
+ *  Description:
+ *      Replicate a 16-entry lookup table into each 128-bit lane of a 512-bit
+ *      vector.
+ *
+ *  Parameters:
+ *      table [in]
+ *          The lookup table.
+ *
+ *  Returns:
+ *      The replicated table.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::array<std::uint8_t, 64> Replicate(
+                                            const std::uint8_t (&table)[16])
+{
+    std::array<std::uint8_t, 64> replicated{};
+
+    for (std::size_t i = 0; i < 64; i++) replicated[i] = table[i % 16];
+
+    return replicated;
+}
+
+// Permutation indices and constants
+alignas(64) constexpr std::array<std::uint8_t, 64> Prev_1 = MakePrevIndex<1>();
+alignas(64) constexpr std::array<std::uint8_t, 64> Prev_2 = MakePrevIndex<2>();
+alignas(64) constexpr std::array<std::uint8_t, 64> Prev_3 = MakePrevIndex<3>();
+alignas(64) constexpr std::array<std::array<std::uint8_t, 64>, 4> Gather_Index =
+{
+    MakeGatherIndex<0>(),
+    MakeGatherIndex<16>(),
+    MakeGatherIndex<32>(),
+    MakeGatherIndex<48>()
+};
+alignas(64) constexpr std::array<std::uint8_t, 64> Incomplete_Maximum =
+    MakeIncompleteMaximum();
+
+// Lookup tables used for validation
+alignas(64) constexpr std::array<std::uint8_t, 64> Byte_1_High =
+    Replicate(UTF8Tables::Byte_1_High);
+alignas(64) constexpr std::array<std::uint8_t, 64> Byte_1_Low =
+    Replicate(UTF8Tables::Byte_1_Low);
+alignas(64) constexpr std::array<std::uint8_t, 64> Byte_2_High =
+    Replicate(UTF8Tables::Byte_2_High);
+
+/*
+ *  Load()
+ *
+ *  Description:
+ *      Load a 64-octet constant into a vector.
+ *
+ *  Parameters:
+ *      values [in]
+ *          The constant values to load.
+ *
+ *  Returns:
+ *      The vector containing the values.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 inline __m512i Load(const std::array<std::uint8_t, 64> &values)
+{
+    return _mm512_load_si512(values.data());
+}
+
+/*
+ *  SwapOctets()
+ *
+ *  Description:
+ *      Swap the two octets in each 16-bit lane of the vector.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector whose octets are to be swapped.
+ *
+ *  Returns:
+ *      The vector with swapped octets.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 inline __m512i SwapOctets(__m512i input)
+{
+    return _mm512_or_si512(_mm512_slli_epi16(input, 8),
+                           _mm512_srli_epi16(input, 8));
+}
+
+/*
+ *  CheckUTF8Octets()
+ *
+ *  Description:
+ *      Check the given vector of octets for UTF-8 encoding errors, taking
+ *      into account the octets in the previous vector.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector of octets to check.
+ *
+ *      prev_input [in]
+ *          The vector of octets that precedes the input.
+ *
+ *  Returns:
+ *      A vector that is non-zero if any encoding error was found.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 __m512i CheckUTF8Octets(__m512i input, __m512i prev_input)
+{
+    const __m512i low_nibble_mask = _mm512_set1_epi8(0x0f);
+
+    // Check for errors involving pairs of adjacent octets
+    __m512i prev1 = _mm512_permutex2var_epi8(prev_input, Load(Prev_1), input);
+    __m512i byte_1_high = _mm512_shuffle_epi8(
+        Load(Byte_1_High),
+        _mm512_and_si512(_mm512_srli_epi16(prev1, 4), low_nibble_mask));
+    __m512i byte_1_low = _mm512_shuffle_epi8(
+        Load(Byte_1_Low),
+        _mm512_and_si512(prev1, low_nibble_mask));
+    __m512i byte_2_high = _mm512_shuffle_epi8(
+        Load(Byte_2_High),
+        _mm512_and_si512(_mm512_srli_epi16(input, 4), low_nibble_mask));
+    __m512i special_cases = _mm512_ternarylogic_epi32(byte_1_high,
+                                                      byte_1_low,
+                                                      byte_2_high,
+                                                      0x80);
+
+    // Identify the octets that must be the third or fourth octet of a
+    // sequence (only values >= 0xe0 / 0xf0 will be >= 0x80 after subtraction)
+    __m512i prev2 = _mm512_permutex2var_epi8(prev_input, Load(Prev_2), input);
+    __m512i prev3 = _mm512_permutex2var_epi8(prev_input, Load(Prev_3), input);
+    __m512i is_third_octet = _mm512_subs_epu8(
+        prev2,
+        _mm512_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    __m512i is_fourth_octet = _mm512_subs_epu8(
+        prev3,
+        _mm512_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    __m512i must_be_continuation = _mm512_and_si512(
+        _mm512_or_si512(is_third_octet, is_fourth_octet),
+        _mm512_set1_epi8(static_cast<char>(0x80)));
+
+    // Continuation octets must appear exactly where expected
+    return _mm512_xor_si512(must_be_continuation, special_cases);
+}
+
+/*
+ *  LoadMask64()
+ *
+ *  Description:
+ *      Return a mask selecting the first n (up to 64) elements.
+ *
+ *  Parameters:
+ *      n [in]
+ *          The number of elements to select.
+ *
+ *  Returns:
+ *      The mask.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 inline __mmask64 LoadMask64(std::size_t n)
+{
+    return (n >= 64) ? ~__mmask64{} : _bzhi_u64(~std::uint64_t{}, n);
+}
+
+/*
+ *  LoadMask32()
+ *
+ *  Description:
+ *      Return a mask selecting the first n (up to 32) elements.
+ *
+ *  Parameters:
+ *      n [in]
+ *          The number of elements to select.
+ *
+ *  Returns:
+ *      The mask.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 inline __mmask32 LoadMask32(std::size_t n)
+{
+    return (n >= 32) ? ~__mmask32{} :
+                       _bzhi_u32(~std::uint32_t{}, static_cast<unsigned>(n));
+}
+
+/*
+ *  EncodeUTF8()
+ *
+ *  Description:
+ *      Encode 16 UTF-16 code units as UTF-8, placing the octets for each
+ *      code unit into the corresponding 32-bit lane, then compress the
+ *      octets into contiguous output.
+ *
+ *  Parameters:
+ *      units [in]
+ *          Sixteen UTF-16 code units in host order, one per 32-bit lane.
+ *
+ *      next_units [in]
+ *          The code units that follow each of the units, used to decode
+ *          surrogate pairs.
+ *
+ *      active [in]
+ *          Mask indicating which lanes should produce output.
+ *
+ *      high [in]
+ *          Mask indicating which lanes hold a high surrogate (always followed
+ *          by a low surrogate in the next lane).
+ *
+ *      low [in]
+ *          Mask indicating which lanes hold a low surrogate.
+ *
+ *      out [out]
+ *          Where the UTF-8 octets are written.
+ *
+ *  Returns:
+ *      The number of octets written.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 std::size_t EncodeUTF8(__m512i units,
+                                       __m512i next_units,
+                                       __mmask16 active,
+                                       __mmask16 high,
+                                       __mmask16 low,
+                                       std::uint8_t *out)
+{
+    const __m512i mask_3f = _mm512_set1_epi32(0x3f);
+    const __m512i continuation = _mm512_set1_epi32(0x80);
+
+    // Six-bit groups of the code unit
+    __m512i bits_0 = _mm512_and_si512(units, mask_3f);
+    __m512i bits_6 = _mm512_and_si512(_mm512_srli_epi32(units, 6), mask_3f);
+    __m512i bits_12 = _mm512_srli_epi32(units, 12);
+
+    // 0nnnnnnn
+    __m512i encoded = units;
+
+    // 110nnnnn 10nnnnnn
+    __mmask16 two_or_more =
+        _mm512_cmpge_epu32_mask(units, _mm512_set1_epi32(0x80));
+    __m512i two = _mm512_or_si512(
+        _mm512_or_si512(_mm512_srli_epi32(units, 6), _mm512_set1_epi32(0xc0)),
+        _mm512_slli_epi32(_mm512_or_si512(bits_0, continuation), 8));
+    encoded = _mm512_mask_mov_epi32(encoded, two_or_more, two);
+
+    // 1110nnnn 10nnnnnn 10nnnnnn
+    __mmask16 three_or_more =
+        _mm512_cmpge_epu32_mask(units, _mm512_set1_epi32(0x800));
+    __m512i three = _mm512_or_si512(
+        _mm512_or_si512(bits_12, _mm512_set1_epi32(0xe0)),
+        _mm512_or_si512(
+            _mm512_slli_epi32(_mm512_or_si512(bits_6, continuation), 8),
+            _mm512_slli_epi32(_mm512_or_si512(bits_0, continuation), 16)));
+    encoded = _mm512_mask_mov_epi32(encoded, three_or_more, three);
+
+    // 11110nnn 10nnnnnn 10nnnnnn 10nnnnnn (from a surrogate pair)
+    __m512i character = _mm512_add_epi32(
+        _mm512_add_epi32(_mm512_slli_epi32(units, 10), next_units),
+        _mm512_set1_epi32(static_cast<int>(0xfca0'2400)));
+    __m512i four = _mm512_or_si512(
+        _mm512_or_si512(
+            _mm512_or_si512(_mm512_srli_epi32(character, 18),
+                            _mm512_set1_epi32(0xf0)),
+            _mm512_slli_epi32(
+                _mm512_or_si512(
+                    _mm512_and_si512(_mm512_srli_epi32(character, 12),
+                                     mask_3f),
+                    continuation),
+                8)),
+        _mm512_or_si512(
+            _mm512_slli_epi32(
+                _mm512_or_si512(
+                    _mm512_and_si512(_mm512_srli_epi32(character, 6),
+                                     mask_3f),
+                    continuation),
+                16),
+            _mm512_slli_epi32(
+                _mm512_or_si512(_mm512_and_si512(character, mask_3f),
+                                continuation),
+                24)));
+    encoded = _mm512_mask_mov_epi32(encoded, high, four);
+
+    // Determine the number of octets produced by each lane
+    __m512i length = _mm512_set1_epi32(1);
+    length = _mm512_mask_add_epi32(length,
+                                   two_or_more,
+                                   length,
+                                   _mm512_set1_epi32(1));
+    length = _mm512_mask_add_epi32(length,
+                                   three_or_more,
+                                   length,
+                                   _mm512_set1_epi32(1));
+    length = _mm512_mask_mov_epi32(length, high, _mm512_set1_epi32(4));
+    length = _mm512_maskz_mov_epi32(
+        static_cast<__mmask16>(active & ~low),
+        length);
+
+    // Select the leading octets of each lane that hold output and compress
+    __mmask64 keep = _mm512_cmplt_epu8_mask(
+        _mm512_set1_epi32(0x0302'0100),
+        _mm512_mullo_epi32(length, _mm512_set1_epi32(0x0101'0101)));
+    __m512i compressed = _mm512_maskz_compress_epi8(keep, encoded);
+    std::size_t count = static_cast<std::size_t>(_mm_popcnt_u64(keep));
+    _mm512_mask_storeu_epi8(out, LoadMask64(count), compressed);
+
+    return count;
+}
+
+} // namespace
+
+/*
+ *  ValidateUTF8_AVX512()
+ *
+ *  Description:
+ *      Validate the given UTF-8 octets using AVX-512 instructions, returning
+ *      the length of the prefix that is known to be valid.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to validate.
+ *
+ *      length [in]
+ *          The number of octets to validate.
+ *
+ *  Returns:
+ *      The length of the valid prefix, which always ends on a character
+ *      boundary.  This will be less than the length only if an error was
+ *      found.
+ *
+ *  Comments:
+ *      The final partial block is read using a masked load.  The masked-off
+ *      octets are zero, so an incomplete sequence at the end of the input is
+ *      detected as an error.
+ */
+CHARUTIL_AVX512 std::size_t ValidateUTF8_AVX512(const std::uint8_t *octets,
+                                                std::size_t length)
+{
+    __m512i prev_input = _mm512_setzero_si512();
+    __m512i prev_incomplete = _mm512_setzero_si512();
+    std::size_t i = 0;
+
+    for (; i < length; i += 64)
+    {
+        __m512i input =
+            _mm512_maskz_loadu_epi8(LoadMask64(length - i), octets + i);
+
+        // If all octets are ASCII, the only possible error is an incomplete
+        // sequence at the end of the previous block
+        if (_mm512_movepi8_mask(input) == 0)
+        {
+            if (_mm512_test_epi8_mask(prev_incomplete, prev_incomplete) != 0)
+            {
+                break;
+            }
+            prev_input = _mm512_setzero_si512();
+            continue;
+        }
+
+        // Check the vector against the one preceding it
+        __m512i error = CheckUTF8Octets(input, prev_input);
+        if (_mm512_test_epi8_mask(error, error) != 0) break;
+
+        prev_incomplete = _mm512_subs_epu8(input, Load(Incomplete_Maximum));
+        prev_input = input;
+    }
+
+    return CharacterBoundary(octets, (i < length) ? i : length);
+}
+
+/*
+ *  ConvertUTF8ToUTF16_AVX512()
+ *
+ *  Description:
+ *      Convert the given UTF-8 octets to UTF-16 using AVX-512 instructions.
+ *      Conversion stops at the first encoding error, leaving the remainder
+ *      of the input to be processed by the scalar code.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A pair indicating the number of input octets consumed and the number
+ *      of output octets produced.  The number of input octets consumed always
+ *      ends on a character boundary.
+ *
+ *  Comments:
+ *      Since each block starts on a character boundary, each block is
+ *      validated without reference to the previous block.
+ */
+CHARUTIL_AVX512 std::pair<std::size_t, std::size_t> ConvertUTF8ToUTF16_AVX512(
+                                                        const std::uint8_t *in,
+                                                        std::size_t length,
+                                                        std::uint8_t *out,
+                                                        bool little_endian)
+{
+    const std::uint8_t *p = in;
+    std::uint8_t *r = out;
+    std::size_t remaining = length;
+
+    while (remaining > 0)
+    {
+        std::size_t block_length = (remaining < 64) ? remaining : 64;
+        __m512i input = _mm512_maskz_loadu_epi8(LoadMask64(block_length), p);
+
+        // If all octets are ASCII, just widen them to 16 bits
+        if (_mm512_movepi8_mask(input) == 0)
+        {
+            __m512i low = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(input));
+            __m512i high =
+                _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(input, 1));
+            if (!little_endian)
+            {
+                low = SwapOctets(low);
+                high = SwapOctets(high);
+            }
+            _mm512_mask_storeu_epi16(r, LoadMask32(block_length), low);
+            if (block_length > 32)
+            {
+                _mm512_mask_storeu_epi16(r + 64,
+                                         LoadMask32(block_length - 32),
+                                         high);
+            }
+            p += block_length;
+            r += block_length * 2;
+            remaining -= block_length;
+            continue;
+        }
+
+        // Validate the block (the previous input ended on a character
+        // boundary, so it is treated as zero)
+        __m512i error = CheckUTF8Octets(input, _mm512_setzero_si512());
+        if (_mm512_test_epi8_mask(error, error) != 0) break;
+
+        // Only complete characters within the block are converted
+        if (block_length == 64) block_length = CharacterBoundary(p, 64);
+
+        // Identify the positions of lead octets and four octet sequences
+        __mmask64 lead = _mm512_cmpge_epi8_mask(
+                            input,
+                            _mm512_set1_epi8(static_cast<char>(0xc0))) &
+                         LoadMask64(block_length);
+        __mmask64 four =
+            _mm512_cmpge_epu8_mask(input,
+                                   _mm512_set1_epi8(static_cast<char>(0xf0)));
+
+        // Process 16 positions at a time
+        for (std::size_t i = 0; i < block_length; i += 16)
+        {
+            auto lead_16 = static_cast<std::uint32_t>((lead >> i) & 0xffff);
+            if (lead_16 == 0) continue;
+            auto four_16 = static_cast<std::uint32_t>((four >> i) & 0xffff) &
+                           lead_16;
+
+            // Gather the four octets starting at each position
+            __m512i octets = _mm512_permutexvar_epi8(
+                _mm512_load_si512(Gather_Index[i / 16].data()),
+                input);
+
+            // Decode the character starting at each position
+            const __m512i mask_3f = _mm512_set1_epi32(0x3f);
+            __m512i octet_0 = _mm512_and_si512(octets,
+                                               _mm512_set1_epi32(0xff));
+            __m512i octet_1 =
+                _mm512_and_si512(_mm512_srli_epi32(octets, 8), mask_3f);
+            __m512i octet_2 =
+                _mm512_and_si512(_mm512_srli_epi32(octets, 16), mask_3f);
+            __m512i octet_3 =
+                _mm512_and_si512(_mm512_srli_epi32(octets, 24), mask_3f);
+
+            __m512i character = octet_0;
+            __m512i two = _mm512_or_si512(
+                _mm512_slli_epi32(
+                    _mm512_and_si512(octet_0, _mm512_set1_epi32(0x1f)),
+                    6),
+                octet_1);
+            character = _mm512_mask_mov_epi32(
+                character,
+                _mm512_cmpge_epu32_mask(octet_0, _mm512_set1_epi32(0xc0)),
+                two);
+            __m512i three = _mm512_or_si512(
+                _mm512_slli_epi32(
+                    _mm512_and_si512(octet_0, _mm512_set1_epi32(0x0f)),
+                    12),
+                _mm512_or_si512(_mm512_slli_epi32(octet_1, 6), octet_2));
+            character = _mm512_mask_mov_epi32(
+                character,
+                _mm512_cmpge_epu32_mask(octet_0, _mm512_set1_epi32(0xe0)),
+                three);
+
+            // Four octet sequences produce a surrogate pair, with the high
+            // surrogate in the lower 16 bits of the lane
+            __m512i supplementary = _mm512_or_si512(
+                _mm512_slli_epi32(
+                    _mm512_and_si512(octet_0, _mm512_set1_epi32(0x07)),
+                    18),
+                _mm512_or_si512(
+                    _mm512_slli_epi32(octet_1, 12),
+                    _mm512_or_si512(_mm512_slli_epi32(octet_2, 6), octet_3)));
+            __m512i surrogates = _mm512_or_si512(
+                _mm512_add_epi32(_mm512_srli_epi32(supplementary, 10),
+                                 _mm512_set1_epi32(0xd800 - (0x1'0000 >> 10))),
+                _mm512_slli_epi32(
+                    _mm512_or_si512(
+                        _mm512_and_si512(supplementary,
+                                         _mm512_set1_epi32(0x3ff)),
+                        _mm512_set1_epi32(0xdc00)),
+                    16));
+            character = _mm512_mask_mov_epi32(
+                character,
+                static_cast<__mmask16>(four_16),
+                surrogates);
+
+            // Keep the lower 16 bits of each lane that starts a character and
+            // the upper 16 bits of each lane holding a surrogate pair
+            std::uint32_t keep = _pdep_u32(lead_16, 0x5555'5555) |
+                                 _pdep_u32(four_16, 0xaaaa'aaaa);
+            __m512i compressed = _mm512_maskz_compress_epi16(keep, character);
+            if (!little_endian) compressed = SwapOctets(compressed);
+            std::size_t count = static_cast<std::size_t>(_mm_popcnt_u32(keep));
+            _mm512_mask_storeu_epi16(r, LoadMask32(count), compressed);
+            r += count * 2;
+        }
+
+        p += block_length;
+        remaining -= block_length;
+    }
+
+    return {static_cast<std::size_t>(p - in), static_cast<std::size_t>(r - out)};
+}
+
+/*
+ *  ConvertUTF16ToUTF8_AVX512()
+ *
+ *  Description:
+ *      Convert the given UTF-16 octets to UTF-8 using AVX-512 instructions.
+ *      Conversion stops at the first unpaired surrogate, leaving the
+ *      remainder of the input to be processed by the scalar code.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert, which must be even.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be at
+ *          least 1.5x the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A pair indicating the number of input octets consumed and the number
+ *      of output octets produced.  The input consumed never ends between the
+ *      two code units of a surrogate pair.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_AVX512 std::pair<std::size_t, std::size_t> ConvertUTF16ToUTF8_AVX512(
+                                                        const std::uint8_t *in,
+                                                        std::size_t length,
+                                                        std::uint8_t *out,
+                                                        bool little_endian)
+{
+    const std::uint8_t *p = in;
+    std::uint8_t *r = out;
+    std::size_t remaining = length / 2;
+
+    while (remaining > 0)
+    {
+        std::size_t block_length = (remaining < 32) ? remaining : 32;
+        __mmask32 block_mask = LoadMask32(block_length);
+        __m512i units = _mm512_maskz_loadu_epi16(block_mask, p);
+        if (!little_endian) units = SwapOctets(units);
+
+        // If all code units are ASCII, just narrow them to 8 bits
+        if (_mm512_cmpge_epu16_mask(units, _mm512_set1_epi16(0x80)) == 0)
+        {
+            _mm256_mask_storeu_epi8(r,
+                                    block_mask,
+                                    _mm512_cvtepi16_epi8(units));
+            p += block_length * 2;
+            r += block_length;
+            remaining -= block_length;
+            continue;
+        }
+
+        // Load the code units that follow each code unit
+        std::size_t next_length = (remaining - 1 < 32) ? remaining - 1 : 32;
+        __mmask32 next_mask = LoadMask32(next_length);
+        __m512i next_units = _mm512_maskz_loadu_epi16(next_mask, p + 2);
+        if (!little_endian) next_units = SwapOctets(next_units);
+
+        // Locate high and low surrogates
+        const __m512i surrogate_mask = _mm512_set1_epi16(
+                                            static_cast<short>(0xfc00));
+        __mmask32 high = _mm512_mask_cmpeq_epi16_mask(
+            block_mask,
+            _mm512_and_si512(units, surrogate_mask),
+            _mm512_set1_epi16(static_cast<short>(0xd800)));
+        __mmask32 low = _mm512_mask_cmpeq_epi16_mask(
+            block_mask,
+            _mm512_and_si512(units, surrogate_mask),
+            _mm512_set1_epi16(static_cast<short>(0xdc00)));
+        __mmask32 next_low = _mm512_mask_cmpeq_epi16_mask(
+            next_mask,
+            _mm512_and_si512(next_units, surrogate_mask),
+            _mm512_set1_epi16(static_cast<short>(0xdc00)));
+
+        // High surrogates must be followed by a low surrogate and low
+        // surrogates must be preceded by a high surrogate
+        std::uint32_t invalid = (high & ~next_low) | (low & ~(high << 1));
+        if (invalid != 0)
+        {
+            block_length = _tzcnt_u32(invalid);
+            if (block_length == 0) break;
+            block_mask = LoadMask32(block_length);
+        }
+
+        // Encode each half of the block
+        for (std::size_t i = 0; i < block_length; i += 16)
+        {
+            int half = static_cast<int>(i / 16);
+            __m512i units_32 = _mm512_cvtepu16_epi32(
+                half ? _mm512_extracti64x4_epi64(units, 1) :
+                       _mm512_castsi512_si256(units));
+            __m512i next_units_32 = _mm512_cvtepu16_epi32(
+                half ? _mm512_extracti64x4_epi64(next_units, 1) :
+                       _mm512_castsi512_si256(next_units));
+            r += EncodeUTF8(units_32,
+                            next_units_32,
+                            static_cast<__mmask16>(block_mask >> i),
+                            static_cast<__mmask16>(high >> i),
+                            static_cast<__mmask16>(low >> i),
+                            r);
+        }
+
+        // If the last code unit is a high surrogate, its low surrogate
+        // (which is beyond the block) was consumed as well
+        if ((high >> (block_length - 1)) & 1) block_length++;
+
+        p += block_length * 2;
+        remaining -= block_length;
+    }
+
+    return {static_cast<std::size_t>(p - in), static_cast<std::size_t>(r - out)};
+}
+
+/*
+ *  UTF16LengthFromUTF8_AVX512()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-8
+ *      input as UTF-16 using AVX-512 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.
+ *
+ *  Returns:
+ *      The length of the UTF-16 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.
+ */
+CHARUTIL_AVX512 std::size_t UTF16LengthFromUTF8_AVX512(
+                                                    const std::uint8_t *octets,
+                                                    std::size_t length)
+{
+    const __m512i continuation_limit =
+        _mm512_set1_epi8(static_cast<char>(0xc0));
+    const __m512i four_octet_min = _mm512_set1_epi8(static_cast<char>(0xf0));
+    std::size_t characters = 0;
+
+    for (std::size_t i = 0; i < length; i += 64)
+    {
+        __mmask64 valid = LoadMask64(length - i);
+        __m512i input = _mm512_maskz_loadu_epi8(valid, octets + i);
+
+        // Count octets that are not continuation octets (10xxxxxx, which
+        // are those less than 0xc0 when compared as signed values) and
+        // those needing a surrogate pair (11110xxx)
+        __mmask64 continuation =
+            _mm512_cmplt_epi8_mask(input, continuation_limit);
+        __mmask64 four_octet = _mm512_cmpge_epu8_mask(input, four_octet_min);
+
+        characters += static_cast<std::size_t>(
+            std::popcount(static_cast<std::uint64_t>(valid & ~continuation)));
+        characters += static_cast<std::size_t>(
+            std::popcount(static_cast<std::uint64_t>(four_octet)));
+    }
+
+    return characters * 2;
+}
+
+/*
+ *  UTF8LengthFromUTF16_AVX512()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-16
+ *      input as UTF-8 using AVX-512 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length of the UTF-8 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.
+ */
+CHARUTIL_AVX512 std::size_t UTF8LengthFromUTF16_AVX512(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    bool little_endian)
+{
+    const __m512i two_octet_min = _mm512_set1_epi16(0x80);
+    const __m512i three_octet_min = _mm512_set1_epi16(0x800);
+    const __m512i surrogate_mask =
+        _mm512_set1_epi16(static_cast<short>(0xf800));
+    const __m512i surrogate_min =
+        _mm512_set1_epi16(static_cast<short>(0xd800));
+    const std::size_t units = length / 2;
+
+    // Each character requires one octet, plus one more if >= 0x80 and one
+    // more if >= 0x800; each half of a surrogate pair is counted as three
+    // octets, so one is subtracted from each to produce four in total
+    std::size_t utf8_length = units;
+
+    for (std::size_t i = 0; i < units; i += 32)
+    {
+        __m512i input = _mm512_maskz_loadu_epi16(LoadMask32(units - i),
+                                                 in + (i * 2));
+        if (!little_endian) input = SwapOctets(input);
+
+        __mmask32 two_octet = _mm512_cmpge_epu16_mask(input, two_octet_min);
+        __mmask32 three_octet =
+            _mm512_cmpge_epu16_mask(input, three_octet_min);
+        __mmask32 surrogate = _mm512_cmpeq_epi16_mask(
+            _mm512_and_si512(input, surrogate_mask),
+            surrogate_min);
+
+        utf8_length += static_cast<std::size_t>(std::popcount(two_octet)) +
+                       static_cast<std::size_t>(std::popcount(three_octet)) -
+                       static_cast<std::size_t>(std::popcount(surrogate));
+    }
+
+    return utf8_length;
+}
+
+/*
+ *  CountUTF8CodePoints_AVX512()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-8 input using
+ *      AVX-512 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.
+ */
+CHARUTIL_AVX512 std::size_t CountUTF8CodePoints_AVX512(
+                                                    const std::uint8_t *octets,
+                                                    std::size_t length)
+{
+    const __m512i continuation_limit =
+        _mm512_set1_epi8(static_cast<char>(0xc0));
+    std::size_t code_points = 0;
+
+    for (std::size_t i = 0; i < length; i += 64)
+    {
+        __mmask64 valid = LoadMask64(length - i);
+        __m512i input = _mm512_maskz_loadu_epi8(valid, octets + i);
+
+        // Count octets that are not continuation octets (10xxxxxx, which
+        // are those less than 0xc0 when compared as signed values)
+        __mmask64 continuation =
+            _mm512_cmplt_epi8_mask(input, continuation_limit);
+
+        code_points += static_cast<std::size_t>(
+            std::popcount(static_cast<std::uint64_t>(valid & ~continuation)));
+    }
+
+    return code_points;
+}
+
+/*
+ *  CountUTF16CodePoints_AVX512()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-16 input using
+ *      AVX-512 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.
+ */
+CHARUTIL_AVX512 std::size_t CountUTF16CodePoints_AVX512(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    bool little_endian)
+{
+    const __m512i low_surrogate_mask =
+        _mm512_set1_epi16(static_cast<short>(0xfc00));
+    const __m512i low_surrogate_min =
+        _mm512_set1_epi16(static_cast<short>(0xdc00));
+    const std::size_t units = length / 2;
+
+    // Every code unit is a code point except for low surrogates, which
+    // complete the code point started by a high surrogate
+    std::size_t code_points = units;
+
+    for (std::size_t i = 0; i < units; i += 32)
+    {
+        __m512i input = _mm512_maskz_loadu_epi16(LoadMask32(units - i),
+                                                 in + (i * 2));
+        if (!little_endian) input = SwapOctets(input);
+
+        __mmask32 low_surrogate = _mm512_cmpeq_epi16_mask(
+            _mm512_and_si512(input, low_surrogate_mask),
+            low_surrogate_min);
+
+        code_points -= static_cast<std::size_t>(std::popcount(low_surrogate));
+    }
+
+    return code_points;
+}
+
+} // namespace Terra::CharUtil::SIMD
+
+#endif // CHARUTIL_X86_64
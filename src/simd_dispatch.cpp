@@ -0,0 +1,513 @@
+/*
+ *  simd_dispatch.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Functions to detect the capabilities of the processor and select the
+ *      appropriate SIMD kernels at runtime.
+ *
+ *  Portability Issues:
+ *      Processor capabilities are only detected on x86-64 processors.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <string_view>
+#include "simd_dispatch.h"
+
+#ifdef CHARUTIL_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Terra::CharUtil::SIMD
+{
+
+namespace
+{
+
+/*
+ *  ValidateUTF8_None()
+ *
+ *  Description:
+ *      Kernel used when no SIMD implementation is available.  It processes
+ *      nothing, leaving all of the input to the scalar code.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to validate.
+ *
+ *      length [in]
+ *          The number of octets to validate.
+ *
+ *  Returns:
+ *      Zero.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ValidateUTF8_None(const std::uint8_t *, std::size_t)
+{
+    return 0;
+}
+
+/*
+ *  ConvertNone()
+ *
+ *  Description:
+ *      Kernel used when no SIMD implementation of a conversion function is
+ *      available.  It processes nothing, leaving all of the input to the
+ *      scalar code.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the converted octets.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      A pair of zero values (no octets consumed or produced).
+ *
+ *  Comments:
+ *      None.
+ */
+std::pair<std::size_t, std::size_t> ConvertNone(const std::uint8_t *,
+                                                std::size_t,
+                                                std::uint8_t *,
+                                                bool)
+{
+    return {0, 0};
+}
+
+// Kernel tables for each tier
+constexpr Kernels Scalar_Kernels
+{
+    ValidateUTF8_None,
+    ConvertNone,
+    ConvertNone,
+    ConvertASCIIToUTF16_SWAR,
+    ConvertASCIIFromUTF16_SWAR,
+    UTF16LengthFromUTF8_SWAR,
+    UTF8LengthFromUTF16_SWAR,
+    ConvertASCIIToUTF32_SWAR,
+    ConvertASCIIFromUTF32_SWAR,
+    ConvertUTF16ToUTF32_SWAR,
+    ConvertUTF32ToUTF16_SWAR,
+    CopyASCII_SWAR,
+    ConvertLatin1ToUTF16_SWAR,
+    ConvertLatin1FromUTF16_SWAR,
+    CountUTF8CodePoints_SWAR,
+    CountUTF16CodePoints_SWAR
+};
+#ifdef CHARUTIL_X86_64
+constexpr Kernels SSE42_Kernels
+{
+    ValidateUTF8_SSE42,
+    ConvertNone,
+    ConvertNone,
+    ConvertASCIIToUTF16_SSE42,
+    ConvertASCIIFromUTF16_SSE42,
+    UTF16LengthFromUTF8_SSE42,
+    UTF8LengthFromUTF16_SSE42,
+    ConvertASCIIToUTF32_SSE42,
+    ConvertASCIIFromUTF32_SSE42,
+    ConvertUTF16ToUTF32_SSE42,
+    ConvertUTF32ToUTF16_SSE42,
+    CopyASCII_SSE42,
+    ConvertLatin1ToUTF16_SSE42,
+    ConvertLatin1FromUTF16_SSE42,
+    CountUTF8CodePoints_SSE42,
+    CountUTF16CodePoints_SSE42
+};
+constexpr Kernels AVX2_Kernels
+{
+    ValidateUTF8_AVX2,
+    ConvertNone,
+    ConvertNone,
+    ConvertASCIIToUTF16_AVX2,
+    ConvertASCIIFromUTF16_AVX2,
+    UTF16LengthFromUTF8_AVX2,
+    UTF8LengthFromUTF16_AVX2,
+    ConvertASCIIToUTF32_AVX2,
+    ConvertASCIIFromUTF32_AVX2,
+    ConvertUTF16ToUTF32_AVX2,
+    ConvertUTF32ToUTF16_AVX2,
+    CopyASCII_AVX2,
+    ConvertLatin1ToUTF16_AVX2,
+    ConvertLatin1FromUTF16_AVX2,
+    CountUTF8CodePoints_AVX2,
+    CountUTF16CodePoints_AVX2
+};
+constexpr Kernels AVX512_Kernels
+{
+    ValidateUTF8_AVX512,
+    ConvertUTF8ToUTF16_AVX512,
+    ConvertUTF16ToUTF8_AVX512,
+    ConvertASCIIToUTF16_AVX2,
+    ConvertASCIIFromUTF16_AVX2,
+    UTF16LengthFromUTF8_AVX512,
+    UTF8LengthFromUTF16_AVX512,
+    ConvertASCIIToUTF32_AVX2,
+    ConvertASCIIFromUTF32_AVX2,
+    ConvertUTF16ToUTF32_AVX2,
+    ConvertUTF32ToUTF16_AVX2,
+    CopyASCII_AVX2,
+    ConvertLatin1ToUTF16_AVX2,
+    ConvertLatin1FromUTF16_AVX2,
+    CountUTF8CodePoints_AVX512,
+    CountUTF16CodePoints_AVX512
+};
+#endif
+
+#ifdef CHARUTIL_X86_64
+
+/*
+ *  CPUID()
+ *
+ *  Description:
+ *      Execute the CPUID instruction for the given leaf and subleaf.
+ *
+ *  Parameters:
+ *      leaf [in]
+ *          The CPUID leaf to query.
+ *
+ *      subleaf [in]
+ *          The CPUID subleaf to query.
+ *
+ *      registers [out]
+ *          The resulting EAX, EBX, ECX, and EDX register values.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void CPUID(unsigned leaf, unsigned subleaf, unsigned (&registers)[4])
+{
+#ifdef _MSC_VER
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        registers[i] = static_cast<unsigned>(values[i]);
+    }
+#else
+    __cpuid_count(leaf,
+                  subleaf,
+                  registers[0],
+                  registers[1],
+                  registers[2],
+                  registers[3]);
+#endif
+}
+
+/*
+ *  XGETBV()
+ *
+ *  Description:
+ *      Read the extended control register XCR0, which indicates which
+ *      register states the operating system saves on a context switch.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The value of XCR0.
+ *
+ *  Comments:
+ *      This must only be called if CPUID indicates OSXSAVE support.
+ */
+std::uint64_t XGETBV()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    std::uint32_t eax{};
+    std::uint32_t edx{};
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+#endif
+
+/*
+ *  DetectTier()
+ *
+ *  Description:
+ *      Query the processor to determine the best supported SIMD tier.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The best supported tier.
+ *
+ *  Comments:
+ *      None.
+ */
+Tier DetectTier()
+{
+#ifdef CHARUTIL_X86_64
+    unsigned registers[4]{};
+
+    // Determine the highest supported leaf
+    CPUID(0, 0, registers);
+    unsigned max_leaf = registers[0];
+    if (max_leaf < 1) return Tier::Scalar;
+
+    // SSSE3 (ECX bit 9), SSE4.1 (ECX bit 19), and SSE4.2 (ECX bit 20)
+    CPUID(1, 0, registers);
+    constexpr unsigned SSE42_Bits = (1u << 9) | (1u << 19) | (1u << 20);
+    if ((registers[2] & SSE42_Bits) != SSE42_Bits) return Tier::Scalar;
+
+    // The OS must save the YMM registers (OSXSAVE is ECX bit 27 and AVX is
+    // ECX bit 28) in order to use AVX2
+    constexpr unsigned AVX_Bits = (1u << 27) | (1u << 28);
+    if (((registers[2] & AVX_Bits) != AVX_Bits) || (max_leaf < 7))
+    {
+        return Tier::SSE42;
+    }
+    if ((XGETBV() & 0x06) != 0x06) return Tier::SSE42;
+
+    // AVX2 (EBX bit 5) and BMI2 (EBX bit 8)
+    CPUID(7, 0, registers);
+    constexpr unsigned AVX2_Bits = (1u << 5) | (1u << 8);
+    if ((registers[1] & AVX2_Bits) != AVX2_Bits) return Tier::SSE42;
+
+    // AVX-512 F (EBX bit 16), BW (EBX bit 30), VL (EBX bit 31), VBMI (ECX
+    // bit 1), and VBMI2 (ECX bit 6), and the OS must save the opmask and
+    // ZMM registers
+    constexpr unsigned AVX512_EBX_Bits = (1u << 16) | (1u << 30) | (1u << 31);
+    constexpr unsigned AVX512_ECX_Bits = (1u << 1) | (1u << 6);
+    if (((registers[1] & AVX512_EBX_Bits) != AVX512_EBX_Bits) ||
+        ((registers[2] & AVX512_ECX_Bits) != AVX512_ECX_Bits) ||
+        ((XGETBV() & 0xe6) != 0xe6))
+    {
+        return Tier::AVX2;
+    }
+
+    return Tier::AVX512;
+#else
+    return Tier::Scalar;
+#endif
+}
+
+/*
+ *  KernelsForTier()
+ *
+ *  Description:
+ *      Return the kernel table for the given tier.
+ *
+ *  Parameters:
+ *      tier [in]
+ *          The tier for which the kernel table is requested.
+ *
+ *  Returns:
+ *      A pointer to the kernel table.
+ *
+ *  Comments:
+ *      None.
+ */
+const Kernels *KernelsForTier(Tier tier)
+{
+    switch (tier)
+    {
+#ifdef CHARUTIL_X86_64
+        case Tier::AVX512:
+            return &AVX512_Kernels;
+
+        case Tier::AVX2:
+            return &AVX2_Kernels;
+
+        case Tier::SSE42:
+            return &SSE42_Kernels;
+#endif
+
+        default:
+            return &Scalar_Kernels;
+    }
+}
+
+/*
+ *  InitialTier()
+ *
+ *  Description:
+ *      Determine the tier to use initially, which is the best supported tier
+ *      unless a lower tier is requested via the CHARUTIL_SIMD_TIER
+ *      environment variable.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The tier to use initially.
+ *
+ *  Comments:
+ *      Unrecognized values of CHARUTIL_SIMD_TIER are ignored.
+ */
+Tier InitialTier()
+{
+    Tier tier = GetSupportedTier();
+
+    // Determine whether a specific tier is requested
+    const char *requested = std::getenv("CHARUTIL_SIMD_TIER");
+    if (requested == nullptr) return tier;
+
+    Tier requested_tier = tier;
+    std::string_view name(requested);
+    if (name == "scalar") requested_tier = Tier::Scalar;
+    if (name == "sse42") requested_tier = Tier::SSE42;
+    if (name == "avx2") requested_tier = Tier::AVX2;
+    if (name == "avx512") requested_tier = Tier::AVX512;
+
+    return (requested_tier < tier) ? requested_tier : tier;
+}
+
+/*
+ *  ActiveKernels()
+ *
+ *  Description:
+ *      Return the atomic pointer to the kernel table in use, initializing it
+ *      on first use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the atomic kernel table pointer.
+ *
+ *  Comments:
+ *      None.
+ */
+std::atomic<const Kernels *> &ActiveKernels()
+{
+    static std::atomic<const Kernels *> active_kernels{
+        KernelsForTier(InitialTier())};
+
+    return active_kernels;
+}
+
+} // namespace
+
+/*
+ *  GetSupportedTier()
+ *
+ *  Description:
+ *      Return the best SIMD tier supported by the processor and operating
+ *      system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The best supported tier.
+ *
+ *  Comments:
+ *      The processor capabilities are queried only once.
+ */
+Tier GetSupportedTier()
+{
+    static const Tier supported_tier = DetectTier();
+
+    return supported_tier;
+}
+
+/*
+ *  GetTier()
+ *
+ *  Description:
+ *      Return the SIMD tier presently in use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The tier presently in use.
+ *
+ *  Comments:
+ *      Initially, this is the best supported tier.  However, if the
+ *      environment variable CHARUTIL_SIMD_TIER is set to "scalar", "sse42",
+ *      "avx2", or "avx512", the initial tier will be no higher than the named
+ *      tier.  This allows each implementation to be exercised without
+ *      modifying the calling program.
+ */
+Tier GetTier()
+{
+    const Kernels *kernels = ActiveKernels().load(std::memory_order_acquire);
+
+#ifdef CHARUTIL_X86_64
+    if (kernels == &AVX512_Kernels) return Tier::AVX512;
+    if (kernels == &AVX2_Kernels) return Tier::AVX2;
+    if (kernels == &SSE42_Kernels) return Tier::SSE42;
+#endif
+
+    return Tier::Scalar;
+}
+
+/*
+ *  SetTier()
+ *
+ *  Description:
+ *      Force the use of the given SIMD tier.  This is primarily intended
+ *      to allow tests to exercise each implementation.
+ *
+ *  Parameters:
+ *      tier [in]
+ *          The tier to use.
+ *
+ *  Returns:
+ *      True if the tier was selected, false if the processor does not
+ *      support the requested tier.
+ *
+ *  Comments:
+ *      This should not be called while other threads are calling functions
+ *      in this library, since those calls may be using either tier.
+ */
+bool SetTier(Tier tier)
+{
+    if (tier > GetSupportedTier()) return false;
+
+    ActiveKernels().store(KernelsForTier(tier), std::memory_order_release);
+
+    return true;
+}
+
+/*
+ *  GetKernels()
+ *
+ *  Description:
+ *      Return the table of kernel functions for the tier presently in use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the kernel table.
+ *
+ *  Comments:
+ *      None.
+ */
+const Kernels &GetKernels()
+{
+    return *ActiveKernels().load(std::memory_order_acquire);
+}
+
+} // namespace Terra::CharUtil::SIMD
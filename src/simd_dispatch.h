@@ -0,0 +1,472 @@
+/*
+ *  simd_dispatch.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Definitions used to select between the scalar implementation and the
+ *      vectorized (SIMD) kernels at runtime based on the capabilities of the
+ *      processor on which the library is executing.
+ *
+ *      The SIMD kernels operate on a prefix of the input and return the
+ *      length of the prefix they were able to process.  The scalar code
+ *      then continues from that point, so the scalar code remains the
+ *      authoritative source for error detection and for processing the
+ *      final few octets of the input.
+ *
+ *  Portability Issues:
+ *      The SIMD kernels are only available on x86-64 processors.  On other
+ *      platforms, only the scalar implementation is used.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Determine if the x86-64 SIMD kernels should be compiled
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHARUTIL_X86_64 1
+#endif
+
+// Specify the target instruction set for a function (GCC and Clang only;
+// MSVC allows the use of intrinsics without any special declaration)
+#if defined(__GNUC__) || defined(__clang__)
+#define CHARUTIL_TARGET(x) __attribute__((target(x)))
+#else
+#define CHARUTIL_TARGET(x)
+#endif
+
+namespace Terra::CharUtil::SIMD
+{
+
+// Instruction set tiers, in order of preference
+enum class Tier : unsigned
+{
+    Scalar,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+// Table of kernel functions for a given tier
+struct Kernels
+{
+    // Return the length of the prefix of the input known to be valid UTF-8;
+    // the prefix always ends on a character boundary
+    std::size_t (*validate_utf8)(const std::uint8_t *octets,
+                                 std::size_t length);
+
+    // Convert the longest valid prefix of the UTF-8 input to UTF-16,
+    // returning the number of octets consumed and produced; the output
+    // must be at least twice the length of the input
+    std::pair<std::size_t, std::size_t> (*utf8_to_utf16)(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    std::uint8_t *out,
+                                                    bool little_endian);
+
+    // Convert the longest valid prefix of the UTF-16 input to UTF-8,
+    // returning the number of octets consumed and produced; the output
+    // must be at least 1.5x the length of the input
+    std::pair<std::size_t, std::size_t> (*utf16_to_utf8)(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    std::uint8_t *out,
+                                                    bool little_endian);
+
+    // Convert the run of ASCII characters at the start of the UTF-8 input
+    // to UTF-16, returning the number of characters converted; the output
+    // must be at least twice the length of the input
+    std::size_t (*ascii_to_utf16)(const std::uint8_t *in,
+                                  std::size_t length,
+                                  std::uint8_t *out,
+                                  bool little_endian);
+
+    // Convert the run of ASCII characters at the start of the UTF-16 input
+    // to UTF-8, returning the number of octets consumed; the output must be
+    // at least half the length of the input
+    std::size_t (*ascii_from_utf16)(const std::uint8_t *in,
+                                    std::size_t length,
+                                    std::uint8_t *out,
+                                    bool little_endian);
+
+    // Return the number of octets required to encode the valid UTF-8 input
+    // as UTF-16
+    std::size_t (*utf16_length_from_utf8)(const std::uint8_t *octets,
+                                          std::size_t length);
+
+    // Return the number of octets required to encode the valid UTF-16 input
+    // as UTF-8
+    std::size_t (*utf8_length_from_utf16)(const std::uint8_t *in,
+                                          std::size_t length,
+                                          bool little_endian);
+
+    // Convert the run of ASCII characters at the start of the UTF-8 input
+    // to UTF-32, returning the number of characters converted; the output
+    // must be at least four times the length of the input
+    std::size_t (*ascii_to_utf32)(const std::uint8_t *in,
+                                  std::size_t length,
+                                  std::uint8_t *out,
+                                  bool little_endian);
+
+    // Convert the run of ASCII characters at the start of the UTF-32 input
+    // to UTF-8, returning the number of octets consumed; the output must be
+    // at least one quarter the length of the input
+    std::size_t (*ascii_from_utf32)(const std::uint8_t *in,
+                                    std::size_t length,
+                                    std::uint8_t *out,
+                                    bool little_endian);
+
+    // Convert the run of characters that are not surrogates at the start of
+    // the UTF-16 input to UTF-32, returning the number of octets consumed;
+    // the output must be at least twice the length of the input
+    std::size_t (*utf16_to_utf32)(const std::uint8_t *in,
+                                  std::size_t length,
+                                  std::uint8_t *out,
+                                  bool little_endian);
+
+    // Convert the run of characters in the BMP (other than surrogates) at
+    // the start of the UTF-32 input to UTF-16, returning the number of
+    // octets consumed; the output must be at least half the length of the
+    // input
+    std::size_t (*utf32_to_utf16)(const std::uint8_t *in,
+                                  std::size_t length,
+                                  std::uint8_t *out,
+                                  bool little_endian);
+
+    // Copy the run of ASCII characters at the start of the input, returning
+    // the number of characters copied
+    std::size_t (*copy_ascii)(const std::uint8_t *in,
+                              std::size_t length,
+                              std::uint8_t *out);
+
+    // Convert the entire Latin-1 input to UTF-16; the output must be twice
+    // the length of the input
+    void (*latin1_to_utf16)(const std::uint8_t *in,
+                            std::size_t length,
+                            std::uint8_t *out,
+                            bool little_endian);
+
+    // Convert the run of characters no greater than 0xff at the start of the
+    // UTF-16 input to Latin-1, returning the number of octets consumed; the
+    // output must be at least half the length of the input
+    std::size_t (*latin1_from_utf16)(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+
+    // Return the number of code points in the valid UTF-8 input
+    std::size_t (*count_utf8_code_points)(const std::uint8_t *octets,
+                                          std::size_t length);
+
+    // Return the number of code points in the valid UTF-16 input
+    std::size_t (*count_utf16_code_points)(const std::uint8_t *in,
+                                           std::size_t length,
+                                           bool little_endian);
+};
+
+/*
+ *  GetSupportedTier()
+ *
+ *  Description:
+ *      Return the best SIMD tier supported by the processor and operating
+ *      system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The best supported tier.
+ *
+ *  Comments:
+ *      The processor capabilities are queried only once.
+ */
+Tier GetSupportedTier();
+
+/*
+ *  GetTier()
+ *
+ *  Description:
+ *      Return the SIMD tier presently in use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The tier presently in use.
+ *
+ *  Comments:
+ *      Initially, this is the best supported tier.  However, if the
+ *      environment variable CHARUTIL_SIMD_TIER is set to "scalar", "sse42",
+ *      "avx2", or "avx512", the initial tier will be no higher than the named
+ *      tier.  This allows each implementation to be exercised without
+ *      modifying the calling program.
+ */
+Tier GetTier();
+
+/*
+ *  SetTier()
+ *
+ *  Description:
+ *      Force the use of the given SIMD tier.  This is primarily intended
+ *      to allow tests to exercise each implementation.
+ *
+ *  Parameters:
+ *      tier [in]
+ *          The tier to use.
+ *
+ *  Returns:
+ *      True if the tier was selected, false if the processor does not
+ *      support the requested tier.
+ *
+ *  Comments:
+ *      This should not be called while other threads are calling functions
+ *      in this library, since those calls may be using either tier.
+ */
+bool SetTier(Tier tier);
+
+/*
+ *  GetKernels()
+ *
+ *  Description:
+ *      Return the table of kernel functions for the tier presently in use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the kernel table.
+ *
+ *  Comments:
+ *      None.
+ */
+const Kernels &GetKernels();
+
+/*
+ *  CharacterBoundary()
+ *
+ *  Description:
+ *      Given a position within a UTF-8 octet sequence, back up over any
+ *      incomplete multi-octet sequence that starts within the three octets
+ *      preceding that position.  This is used by the kernels to ensure that
+ *      the prefix they report as processed ends on a character boundary.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octet sequence.
+ *
+ *      position [in]
+ *          The position within the sequence.
+ *
+ *  Returns:
+ *      The position of the start of the incomplete sequence, or the given
+ *      position if there is no incomplete sequence preceding it.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::size_t CharacterBoundary(const std::uint8_t *octets,
+                                        std::size_t position)
+{
+    for (std::size_t i = 1; (i <= 3) && (i <= position); i++)
+    {
+        std::uint8_t octet = octets[position - i];
+
+        // Skip over continuation octets
+        if ((octet & 0xc0) == 0x80) continue;
+
+        // An ASCII octet is complete unto itself
+        if (octet < 0x80) break;
+
+        // Determine the length of the sequence that starts with this octet
+        std::size_t sequence_length = (octet >= 0xf0) ? 4 :
+                                      (octet >= 0xe0) ? 3 : 2;
+
+        // If the sequence extends beyond the position, back up to it
+        if (sequence_length > i) return position - i;
+
+        break;
+    }
+
+    return position;
+}
+
+// SWAR kernels
+std::size_t ConvertASCIIToUTF16_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertASCIIFromUTF16_SWAR(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian);
+std::size_t UTF16LengthFromUTF8_SWAR(const std::uint8_t *octets,
+                                       std::size_t length);
+std::size_t UTF8LengthFromUTF16_SWAR(const std::uint8_t *in,
+                                       std::size_t length,
+                                       bool little_endian);
+std::size_t ConvertASCIIToUTF32_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertASCIIFromUTF32_SWAR(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian);
+std::size_t ConvertUTF16ToUTF32_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertUTF32ToUTF16_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t CopyASCII_SWAR(const std::uint8_t *in,
+                           std::size_t length,
+                           std::uint8_t *out);
+void ConvertLatin1ToUTF16_SWAR(const std::uint8_t *in,
+                               std::size_t length,
+                               std::uint8_t *out,
+                               bool little_endian);
+std::size_t ConvertLatin1FromUTF16_SWAR(const std::uint8_t *in,
+                                        std::size_t length,
+                                        std::uint8_t *out,
+                                        bool little_endian);
+std::size_t CountUTF8CodePoints_SWAR(const std::uint8_t *octets,
+                                     std::size_t length);
+std::size_t CountUTF16CodePoints_SWAR(const std::uint8_t *in,
+                                      std::size_t length,
+                                      bool little_endian);
+
+#ifdef CHARUTIL_X86_64
+
+// SSE4.2 kernels
+std::size_t ValidateUTF8_SSE42(const std::uint8_t *octets, std::size_t length);
+std::size_t ConvertASCIIToUTF16_SSE42(const std::uint8_t *in,
+                                      std::size_t length,
+                                      std::uint8_t *out,
+                                      bool little_endian);
+std::size_t ConvertASCIIFromUTF16_SSE42(const std::uint8_t *in,
+                                        std::size_t length,
+                                        std::uint8_t *out,
+                                        bool little_endian);
+std::size_t UTF16LengthFromUTF8_SSE42(const std::uint8_t *octets,
+                                        std::size_t length);
+std::size_t UTF8LengthFromUTF16_SSE42(const std::uint8_t *in,
+                                        std::size_t length,
+                                        bool little_endian);
+std::size_t ConvertASCIIToUTF32_SSE42(const std::uint8_t *in,
+                                      std::size_t length,
+                                      std::uint8_t *out,
+                                      bool little_endian);
+std::size_t ConvertASCIIFromUTF32_SSE42(const std::uint8_t *in,
+                                        std::size_t length,
+                                        std::uint8_t *out,
+                                        bool little_endian);
+std::size_t ConvertUTF16ToUTF32_SSE42(const std::uint8_t *in,
+                                      std::size_t length,
+                                      std::uint8_t *out,
+                                      bool little_endian);
+std::size_t ConvertUTF32ToUTF16_SSE42(const std::uint8_t *in,
+                                      std::size_t length,
+                                      std::uint8_t *out,
+                                      bool little_endian);
+std::size_t CopyASCII_SSE42(const std::uint8_t *in,
+                            std::size_t length,
+                            std::uint8_t *out);
+void ConvertLatin1ToUTF16_SSE42(const std::uint8_t *in,
+                                std::size_t length,
+                                std::uint8_t *out,
+                                bool little_endian);
+std::size_t ConvertLatin1FromUTF16_SSE42(const std::uint8_t *in,
+                                         std::size_t length,
+                                         std::uint8_t *out,
+                                         bool little_endian);
+std::size_t CountUTF8CodePoints_SSE42(const std::uint8_t *octets,
+                                      std::size_t length);
+std::size_t CountUTF16CodePoints_SSE42(const std::uint8_t *in,
+                                       std::size_t length,
+                                       bool little_endian);
+
+// AVX2 kernels
+std::size_t ValidateUTF8_AVX2(const std::uint8_t *octets, std::size_t length);
+std::size_t ConvertASCIIToUTF16_AVX2(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertASCIIFromUTF16_AVX2(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian);
+std::size_t UTF16LengthFromUTF8_AVX2(const std::uint8_t *octets,
+                                       std::size_t length);
+std::size_t UTF8LengthFromUTF16_AVX2(const std::uint8_t *in,
+                                       std::size_t length,
+                                       bool little_endian);
+std::size_t ConvertASCIIToUTF32_AVX2(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertASCIIFromUTF32_AVX2(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian);
+std::size_t ConvertUTF16ToUTF32_AVX2(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t ConvertUTF32ToUTF16_AVX2(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian);
+std::size_t CopyASCII_AVX2(const std::uint8_t *in,
+                           std::size_t length,
+                           std::uint8_t *out);
+void ConvertLatin1ToUTF16_AVX2(const std::uint8_t *in,
+                               std::size_t length,
+                               std::uint8_t *out,
+                               bool little_endian);
+std::size_t ConvertLatin1FromUTF16_AVX2(const std::uint8_t *in,
+                                        std::size_t length,
+                                        std::uint8_t *out,
+                                        bool little_endian);
+std::size_t CountUTF8CodePoints_AVX2(const std::uint8_t *octets,
+                                     std::size_t length);
+std::size_t CountUTF16CodePoints_AVX2(const std::uint8_t *in,
+                                      std::size_t length,
+                                      bool little_endian);
+
+// AVX-512 kernels
+std::size_t ValidateUTF8_AVX512(const std::uint8_t *octets,
+                                std::size_t length);
+std::pair<std::size_t, std::size_t> ConvertUTF8ToUTF16_AVX512(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    std::uint8_t *out,
+                                                    bool little_endian);
+std::pair<std::size_t, std::size_t> ConvertUTF16ToUTF8_AVX512(
+                                                    const std::uint8_t *in,
+                                                    std::size_t length,
+                                                    std::uint8_t *out,
+                                                    bool little_endian);
+std::size_t UTF16LengthFromUTF8_AVX512(const std::uint8_t *octets,
+                                         std::size_t length);
+std::size_t UTF8LengthFromUTF16_AVX512(const std::uint8_t *in,
+                                         std::size_t length,
+                                         bool little_endian);
+std::size_t CountUTF8CodePoints_AVX512(const std::uint8_t *octets,
+                                       std::size_t length);
+std::size_t CountUTF16CodePoints_AVX512(const std::uint8_t *in,
+                                        std::size_t length,
+                                        bool little_endian);
+
+#endif
+
+} // namespace Terra::CharUtil::SIMD
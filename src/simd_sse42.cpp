@@ -0,0 +1,1107 @@
+/*
+ *  simd_sse42.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      SIMD kernels for processors supporting SSE4.2.  These process 64
+ *      octets per iteration as four 128-bit vectors.
+ *
+ *  Portability Issues:
+ *      This code is only compiled for x86-64 processors.  The functions are
+ *      compiled for the SSE4.2 instruction set and must only be called when
+ *      the processor supports that instruction set.
+ */
+
+#include "simd_dispatch.h"
+
+#ifdef CHARUTIL_X86_64
+
+#include <algorithm>
+#include <bit>
+#include <immintrin.h>
+#include "simd_utf8_tables.h"
+
+#define CHARUTIL_SSE42 CHARUTIL_TARGET("sse4.2")
+
+namespace Terra::CharUtil::SIMD
+{
+
+namespace
+{
+
+/*
+ *  Prev()
+ *
+ *  Description:
+ *      Return a vector containing the input shifted forward by N octets,
+ *      with the first N octets taken from the end of the previous input.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The current input vector.
+ *
+ *      prev_input [in]
+ *          The previous input vector.
+ *
+ *  Returns:
+ *      The shifted vector.
+ *
+ *  Comments:
+ *      None.
+ */
+template<int N>
+CHARUTIL_SSE42 inline __m128i Prev(__m128i input, __m128i prev_input)
+{
+    return _mm_alignr_epi8(input, prev_input, 16 - N);
+}
+
+/*
+ *  CheckUTF8Octets()
+ *
+ *  Description:
+ *      Check the given vector of octets for UTF-8 encoding errors, taking
+ *      into account the octets in the previous vector.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector of octets to check.
+ *
+ *      prev_input [in]
+ *          The vector of octets that precedes the input.
+ *
+ *  Returns:
+ *      A vector that is non-zero if any encoding error was found.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_SSE42 __m128i CheckUTF8Octets(__m128i input, __m128i prev_input)
+{
+    const __m128i low_nibble_mask = _mm_set1_epi8(0x0f);
+    const __m128i byte_1_high_table = _mm_load_si128(
+        reinterpret_cast<const __m128i *>(UTF8Tables::Byte_1_High));
+    const __m128i byte_1_low_table = _mm_load_si128(
+        reinterpret_cast<const __m128i *>(UTF8Tables::Byte_1_Low));
+    const __m128i byte_2_high_table = _mm_load_si128(
+        reinterpret_cast<const __m128i *>(UTF8Tables::Byte_2_High));
+
+    // Check for errors involving pairs of adjacent octets
+    __m128i prev1 = Prev<1>(input, prev_input);
+    __m128i byte_1_high = _mm_shuffle_epi8(
+        byte_1_high_table,
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble_mask));
+    __m128i byte_1_low = _mm_shuffle_epi8(
+        byte_1_low_table,
+        _mm_and_si128(prev1, low_nibble_mask));
+    __m128i byte_2_high = _mm_shuffle_epi8(
+        byte_2_high_table,
+        _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble_mask));
+    __m128i special_cases =
+        _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // Identify the octets that must be the third or fourth octet of a
+    // sequence (only values >= 0xe0 / 0xf0 will be >= 0x80 after subtraction)
+    __m128i prev2 = Prev<2>(input, prev_input);
+    __m128i prev3 = Prev<3>(input, prev_input);
+    __m128i is_third_octet =
+        _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    __m128i is_fourth_octet =
+        _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    __m128i must_be_continuation =
+        _mm_and_si128(_mm_or_si128(is_third_octet, is_fourth_octet),
+                      _mm_set1_epi8(static_cast<char>(0x80)));
+
+    // Continuation octets must appear exactly where expected
+    return _mm_xor_si128(must_be_continuation, special_cases);
+}
+
+/*
+ *  IsIncomplete()
+ *
+ *  Description:
+ *      Determine whether the given vector ends with an incomplete multi-octet
+ *      sequence.
+ *
+ *  Parameters:
+ *      input [in]
+ *          The vector of octets to check.
+ *
+ *  Returns:
+ *      A vector that is non-zero if the input ends with an incomplete
+ *      sequence.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_SSE42 inline __m128i IsIncomplete(__m128i input)
+{
+    return _mm_subs_epu8(
+        input,
+        _mm_load_si128(reinterpret_cast<const __m128i *>(
+            UTF8Tables::Incomplete_Maximum)));
+}
+
+} // namespace
+
+/*
+ *  ValidateUTF8_SSE42()
+ *
+ *  Description:
+ *      Validate the given UTF-8 octets using SSE4.2 instructions, returning
+ *      the length of the prefix that is known to be valid.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to validate.
+ *
+ *      length [in]
+ *          The number of octets to validate.
+ *
+ *  Returns:
+ *      The length of the valid prefix, which always ends on a character
+ *      boundary.  This will be less than the length if an error was found
+ *      or if there are fewer than 64 octets remaining to be processed.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_SSE42 std::size_t ValidateUTF8_SSE42(const std::uint8_t *octets,
+                                              std::size_t length)
+{
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(octets + i);
+        __m128i input_0 = _mm_loadu_si128(p);
+        __m128i input_1 = _mm_loadu_si128(p + 1);
+        __m128i input_2 = _mm_loadu_si128(p + 2);
+        __m128i input_3 = _mm_loadu_si128(p + 3);
+
+        // If all octets are ASCII, the only possible error is an incomplete
+        // sequence at the end of the previous block
+        __m128i any_bits = _mm_or_si128(_mm_or_si128(input_0, input_1),
+                                        _mm_or_si128(input_2, input_3));
+        if (_mm_movemask_epi8(any_bits) == 0)
+        {
+            if (!_mm_testz_si128(prev_incomplete, prev_incomplete)) break;
+            prev_input = _mm_setzero_si128();
+            continue;
+        }
+
+        // Check each vector against the one preceding it
+        __m128i error = _mm_or_si128(
+            _mm_or_si128(CheckUTF8Octets(input_0, prev_input),
+                         CheckUTF8Octets(input_1, input_0)),
+            _mm_or_si128(CheckUTF8Octets(input_2, input_1),
+                         CheckUTF8Octets(input_3, input_2)));
+        if (!_mm_testz_si128(error, error)) break;
+
+        prev_incomplete = IsIncomplete(input_3);
+        prev_input = input_3;
+    }
+
+    return CharacterBoundary(octets, i);
+}
+
+/*
+ *  ConvertASCIIToUTF16_SSE42()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-16 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is widened
+ *      and written, but only the leading ASCII octets are reported as
+ *      converted.  The remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_SSE42 std::size_t ConvertASCIIToUTF16_SSE42(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; (length - i) >= 16; i += 16)
+    {
+        __m128i input =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        int non_ascii = _mm_movemask_epi8(input);
+
+        // Interleave the octets with zeros in the required byte order
+        __m128i low = little_endian ? _mm_unpacklo_epi8(input, zero) :
+                                      _mm_unpacklo_epi8(zero, input);
+        __m128i high = little_endian ? _mm_unpackhi_epi8(input, zero) :
+                                       _mm_unpackhi_epi8(zero, input);
+        __m128i *p = reinterpret_cast<__m128i *>(out + (i * 2));
+        _mm_storeu_si128(p, low);
+        _mm_storeu_si128(p + 1, high);
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(
+                                    static_cast<unsigned>(non_ascii)));
+        }
+    }
+
+    // Process the remaining octets
+    return i + ConvertASCIIToUTF16_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 2),
+                                        little_endian);
+}
+
+/*
+ *  ConvertASCIIFromUTF16_SSE42()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-16
+ *      input to UTF-8 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII character, the remaining characters
+ *      are handled by ConvertASCIIFromUTF16_SWAR().
+ */
+CHARUTIL_SSE42 std::size_t ConvertASCIIFromUTF16_SSE42(const std::uint8_t *in,
+                                                       std::size_t length,
+                                                       std::uint8_t *out,
+                                                       bool little_endian)
+{
+    // Bits that must be zero for a character to be ASCII, as each character
+    // appears when loaded into a 16-bit lane
+    const __m128i non_ascii =
+        _mm_set1_epi16(static_cast<short>(little_endian ? 0xff80 : 0x80ff));
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(in + i);
+        __m128i input_0 = _mm_loadu_si128(p);
+        __m128i input_1 = _mm_loadu_si128(p + 1);
+
+        if (!_mm_testz_si128(_mm_or_si128(input_0, input_1), non_ascii)) break;
+
+        // Move each character into the low octet of its lane and pack
+        if (!little_endian)
+        {
+            input_0 = _mm_srli_epi16(input_0, 8);
+            input_1 = _mm_srli_epi16(input_1, 8);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (i / 2)),
+                         _mm_packus_epi16(input_0, input_1));
+    }
+
+    // Process the remaining characters
+    return i + ConvertASCIIFromUTF16_SWAR(in + i,
+                                          length - i,
+                                          out + (i / 2),
+                                          little_endian);
+}
+
+/*
+ *  UTF16LengthFromUTF8_SSE42()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-8
+ *      input as UTF-16 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.
+ *
+ *  Returns:
+ *      The length of the UTF-16 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.  Counts
+ *      are accumulated in 8-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_SSE42 std::size_t UTF16LengthFromUTF8_SSE42(const std::uint8_t *octets,
+                                                     std::size_t length)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i continuation_max = _mm_set1_epi8(static_cast<char>(0xbf));
+    const __m128i four_octet_min = _mm_set1_epi8(static_cast<char>(0xf0));
+    __m128i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 16)
+    {
+        // Each iteration adds at most two to each counter
+        std::size_t iterations = std::min<std::size_t>((length - i) / 16, 127);
+        __m128i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 16)
+        {
+            __m128i input =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(octets + i));
+
+            // Count octets that are not continuation octets (10xxxxxx) and
+            // those needing a surrogate pair (11110xxx)
+            __m128i non_continuation =
+                _mm_cmpgt_epi8(input, continuation_max);
+            __m128i four_octet = _mm_cmpeq_epi8(
+                _mm_max_epu8(input, four_octet_min),
+                input);
+            counts = _mm_sub_epi8(counts, non_continuation);
+            counts = _mm_sub_epi8(counts, four_octet);
+        }
+
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(counts, zero));
+    }
+
+    // Sum the totals and process the remaining octets
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), totals);
+    std::size_t characters = 0;
+    for (std::uint64_t lane : lanes) characters += lane;
+
+    return (characters * 2) + UTF16LengthFromUTF8_SWAR(octets + i, length - i);
+}
+
+/*
+ *  UTF8LengthFromUTF16_SSE42()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-16
+ *      input as UTF-8 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length of the UTF-8 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.  Counts
+ *      are accumulated in 16-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_SSE42 std::size_t UTF8LengthFromUTF16_SSE42(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     bool little_endian)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two_octet_min = _mm_set1_epi16(0x80);
+    const __m128i three_octet_min = _mm_set1_epi16(0x800);
+    const __m128i surrogate_mask = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogate_min = _mm_set1_epi16(static_cast<short>(0xd800));
+    __m128i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 16)
+    {
+        // Each iteration adds at most two to each counter
+        std::size_t iterations =
+            std::min<std::size_t>((length - i) / 16, 16383);
+        __m128i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 16)
+        {
+            __m128i input =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            if (!little_endian)
+            {
+                input = _mm_or_si128(_mm_slli_epi16(input, 8),
+                                     _mm_srli_epi16(input, 8));
+            }
+
+            // Each character requires one octet, plus one more if >= 0x80
+            // and one more if >= 0x800; each half of a surrogate pair is
+            // counted as three octets, so one is subtracted from each
+            __m128i two_octet = _mm_cmpeq_epi16(
+                _mm_max_epu16(input, two_octet_min),
+                input);
+            __m128i three_octet = _mm_cmpeq_epi16(
+                _mm_max_epu16(input, three_octet_min),
+                input);
+            __m128i surrogate = _mm_cmpeq_epi16(
+                _mm_and_si128(input, surrogate_mask),
+                surrogate_min);
+            counts = _mm_sub_epi16(counts, two_octet);
+            counts = _mm_sub_epi16(counts, three_octet);
+            counts = _mm_add_epi16(counts, surrogate);
+        }
+
+        // Widen the counters to 64 bits and add them to the totals
+        __m128i pairs = _mm_madd_epi16(counts, _mm_set1_epi16(1));
+        totals = _mm_add_epi64(totals, _mm_unpacklo_epi32(pairs, zero));
+        totals = _mm_add_epi64(totals, _mm_unpackhi_epi32(pairs, zero));
+    }
+
+    // Sum the totals and process the remaining characters
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), totals);
+    std::size_t utf8_length = i / 2;
+    for (std::uint64_t lane : lanes) utf8_length += lane;
+
+    return utf8_length +
+           UTF8LengthFromUTF16_SWAR(in + i, length - i, little_endian);
+}
+
+/*
+ *  CountUTF8CodePoints_SSE42()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-8 input using
+ *      SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.  Counts
+ *      are accumulated in 8-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_SSE42 std::size_t CountUTF8CodePoints_SSE42(const std::uint8_t *octets,
+                                                     std::size_t length)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i continuation_max = _mm_set1_epi8(static_cast<char>(0xbf));
+    __m128i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 16)
+    {
+        // Each iteration adds at most one to each counter
+        std::size_t iterations = std::min<std::size_t>((length - i) / 16, 255);
+        __m128i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 16)
+        {
+            __m128i input = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(octets + i));
+
+            // Count octets that are not continuation octets (10xxxxxx)
+            counts = _mm_sub_epi8(counts,
+                                  _mm_cmpgt_epi8(input, continuation_max));
+        }
+
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(counts, zero));
+    }
+
+    // Sum the totals and process the remaining octets
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), totals);
+    std::size_t code_points = 0;
+    for (std::uint64_t lane : lanes) code_points += lane;
+
+    return code_points + CountUTF8CodePoints_SWAR(octets + i, length - i);
+}
+
+/*
+ *  CountUTF16CodePoints_SSE42()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-16 input using
+ *      SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.  Counts
+ *      are accumulated in 16-bit lanes, which are summed before they can
+ *      overflow.
+ */
+CHARUTIL_SSE42 std::size_t CountUTF16CodePoints_SSE42(const std::uint8_t *in,
+                                                      std::size_t length,
+                                                      bool little_endian)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low_surrogate_mask =
+        _mm_set1_epi16(static_cast<short>(0xfc00));
+    const __m128i low_surrogate_min =
+        _mm_set1_epi16(static_cast<short>(0xdc00));
+    __m128i totals = zero;
+    std::size_t i = 0;
+
+    while ((length - i) >= 16)
+    {
+        // Each iteration adds at most one to each counter
+        std::size_t iterations =
+            std::min<std::size_t>((length - i) / 16, 32767);
+        __m128i counts = zero;
+
+        for (; iterations > 0; iterations--, i += 16)
+        {
+            __m128i input =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            if (!little_endian)
+            {
+                input = _mm_or_si128(_mm_slli_epi16(input, 8),
+                                     _mm_srli_epi16(input, 8));
+            }
+
+            // Every code unit is a code point except for low surrogates,
+            // which complete the code point started by a high surrogate
+            counts = _mm_sub_epi16(
+                counts,
+                _mm_cmpeq_epi16(_mm_and_si128(input, low_surrogate_mask),
+                                low_surrogate_min));
+        }
+
+        // Widen the counters to 64 bits and add them to the totals
+        __m128i pairs = _mm_madd_epi16(counts, _mm_set1_epi16(1));
+        totals = _mm_add_epi64(totals, _mm_unpacklo_epi32(pairs, zero));
+        totals = _mm_add_epi64(totals, _mm_unpackhi_epi32(pairs, zero));
+    }
+
+    // Sum the totals and process the remaining characters
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), totals);
+    std::size_t low_surrogates = 0;
+    for (std::uint64_t lane : lanes) low_surrogates += lane;
+
+    return (i / 2) - low_surrogates +
+           CountUTF16CodePoints_SWAR(in + i, length - i, little_endian);
+}
+
+/*
+ *  ConvertASCIIToUTF32_SSE42()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-32 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least four times the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is widened
+ *      and written, but only the leading ASCII octets are reported as
+ *      converted.  The remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_SSE42 std::size_t ConvertASCIIToUTF32_SSE42(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 24);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 16; i += 16)
+    {
+        __m128i input =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        int non_ascii = _mm_movemask_epi8(input);
+
+        // Zero-extend each octet and shift into place for big endian output
+        __m128i *p = reinterpret_cast<__m128i *>(out + (i * 4));
+        _mm_storeu_si128(p,
+                         _mm_sll_epi32(_mm_cvtepu8_epi32(input), shift));
+        _mm_storeu_si128(p + 1,
+                         _mm_sll_epi32(
+                             _mm_cvtepu8_epi32(_mm_srli_si128(input, 4)),
+                             shift));
+        _mm_storeu_si128(p + 2,
+                         _mm_sll_epi32(
+                             _mm_cvtepu8_epi32(_mm_srli_si128(input, 8)),
+                             shift));
+        _mm_storeu_si128(p + 3,
+                         _mm_sll_epi32(
+                             _mm_cvtepu8_epi32(_mm_srli_si128(input, 12)),
+                             shift));
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(
+                                    static_cast<unsigned>(non_ascii)));
+        }
+    }
+
+    // Process the remaining octets
+    return i + ConvertASCIIToUTF32_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 4),
+                                        little_endian);
+}
+
+/*
+ *  ConvertASCIIFromUTF32_SSE42()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-32
+ *      input to UTF-8 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least one quarter the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of ASCII characters converted.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII character, the remaining characters
+ *      are handled by ConvertASCIIFromUTF32_SWAR().
+ */
+CHARUTIL_SSE42 std::size_t ConvertASCIIFromUTF32_SSE42(const std::uint8_t *in,
+                                                       std::size_t length,
+                                                       std::uint8_t *out,
+                                                       bool little_endian)
+{
+    // Bits that must be zero for a character to be ASCII, as each character
+    // appears when loaded into a 32-bit lane
+    const __m128i non_ascii = _mm_set1_epi32(
+        static_cast<int>(little_endian ? 0xffff'ff80 : 0x80ff'ffff));
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 24);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 64; i += 64)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(in + i);
+        __m128i input_0 = _mm_loadu_si128(p);
+        __m128i input_1 = _mm_loadu_si128(p + 1);
+        __m128i input_2 = _mm_loadu_si128(p + 2);
+        __m128i input_3 = _mm_loadu_si128(p + 3);
+
+        if (!_mm_testz_si128(_mm_or_si128(_mm_or_si128(input_0, input_1),
+                                          _mm_or_si128(input_2, input_3)),
+                             non_ascii))
+        {
+            break;
+        }
+
+        // Move each character into the low octet of its lane and pack
+        input_0 = _mm_srl_epi32(input_0, shift);
+        input_1 = _mm_srl_epi32(input_1, shift);
+        input_2 = _mm_srl_epi32(input_2, shift);
+        input_3 = _mm_srl_epi32(input_3, shift);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (i / 4)),
+                         _mm_packus_epi16(_mm_packus_epi32(input_0, input_1),
+                                          _mm_packus_epi32(input_2, input_3)));
+    }
+
+    // Process the remaining characters
+    return i + ConvertASCIIFromUTF32_SWAR(in + i,
+                                          length - i,
+                                          out + (i / 4),
+                                          little_endian);
+}
+
+/*
+ *  ConvertUTF16ToUTF32_SSE42()
+ *
+ *  Description:
+ *      Convert the run of characters that are not surrogates at the start of
+ *      the given UTF-16 input to UTF-32 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 and UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      When a block contains a surrogate, the remaining characters are
+ *      handled by ConvertUTF16ToUTF32_SWAR().
+ */
+CHARUTIL_SSE42 std::size_t ConvertUTF16ToUTF32_SSE42(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    // Bits that identify a surrogate, as each character appears when loaded
+    // into a 16-bit lane
+    const __m128i surrogate_mask =
+        _mm_set1_epi16(static_cast<short>(little_endian ? 0xf800 : 0x00f8));
+    const __m128i surrogate_min =
+        _mm_set1_epi16(static_cast<short>(little_endian ? 0xd800 : 0x00d8));
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 16);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 16; i += 16)
+    {
+        __m128i input =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i surrogate = _mm_cmpeq_epi16(
+            _mm_and_si128(input, surrogate_mask),
+            surrogate_min);
+        if (!_mm_testz_si128(surrogate, surrogate)) break;
+
+        // Zero-extend each character; a big endian character is shifted
+        // into the upper half of its lane
+        __m128i *p = reinterpret_cast<__m128i *>(out + (i * 2));
+        _mm_storeu_si128(p,
+                         _mm_sll_epi32(_mm_cvtepu16_epi32(input), shift));
+        _mm_storeu_si128(p + 1,
+                         _mm_sll_epi32(
+                             _mm_cvtepu16_epi32(_mm_srli_si128(input, 8)),
+                             shift));
+    }
+
+    // Process the remaining characters
+    return i + ConvertUTF16ToUTF32_SWAR(in + i,
+                                        length - i,
+                                        out + (i * 2),
+                                        little_endian);
+}
+
+/*
+ *  ConvertUTF32ToUTF16_SSE42()
+ *
+ *  Description:
+ *      Convert the run of characters in the Basic Multilingual Plane (other
+ *      than surrogates) at the start of the given UTF-32 input to UTF-16
+ *      using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 and UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of characters converted.
+ *
+ *  Comments:
+ *      When a block contains any other character, the remaining characters
+ *      are handled by ConvertUTF32ToUTF16_SWAR().
+ */
+CHARUTIL_SSE42 std::size_t ConvertUTF32ToUTF16_SSE42(const std::uint8_t *in,
+                                                     std::size_t length,
+                                                     std::uint8_t *out,
+                                                     bool little_endian)
+{
+    // Bits that must be zero for a character to be in the BMP and the bits
+    // that identify a surrogate, as each character appears when loaded into
+    // a 32-bit lane
+    const __m128i non_bmp = _mm_set1_epi32(
+        static_cast<int>(little_endian ? 0xffff'0000 : 0x0000'ffff));
+    const __m128i surrogate_mask =
+        _mm_set1_epi32(little_endian ? 0xf800 : 0xf8'0000);
+    const __m128i surrogate_min =
+        _mm_set1_epi32(little_endian ? 0xd800 : 0xd8'0000);
+    const __m128i shift = _mm_cvtsi32_si128(little_endian ? 0 : 16);
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(in + i);
+        __m128i input_0 = _mm_loadu_si128(p);
+        __m128i input_1 = _mm_loadu_si128(p + 1);
+
+        __m128i surrogate = _mm_or_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(input_0, surrogate_mask),
+                            surrogate_min),
+            _mm_cmpeq_epi32(_mm_and_si128(input_1, surrogate_mask),
+                            surrogate_min));
+        if (!_mm_testz_si128(_mm_or_si128(input_0, input_1), non_bmp) ||
+            !_mm_testz_si128(surrogate, surrogate))
+        {
+            break;
+        }
+
+        // Move each character into the low half of its lane and pack
+        input_0 = _mm_srl_epi32(input_0, shift);
+        input_1 = _mm_srl_epi32(input_1, shift);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (i / 2)),
+                         _mm_packus_epi32(input_0, input_1));
+    }
+
+    // Process the remaining characters
+    return i + ConvertUTF32ToUTF16_SWAR(in + i,
+                                        length - i,
+                                        out + (i / 2),
+                                        little_endian);
+}
+
+/*
+ *  CopyASCII_SSE42()
+ *
+ *  Description:
+ *      Copy the run of ASCII characters at the start of the given input
+ *      using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The octets to copy.
+ *
+ *      length [in]
+ *          The number of octets available to copy.
+ *
+ *      out [out]
+ *          The buffer into which to copy the octets.  This must be at least
+ *          the input length.
+ *
+ *  Returns:
+ *      The number of ASCII characters copied.
+ *
+ *  Comments:
+ *      When a block contains a non-ASCII octet, the entire block is copied,
+ *      but only the leading ASCII octets are reported as copied.  The
+ *      remainder of the output is overwritten by the caller.
+ */
+CHARUTIL_SSE42 std::size_t CopyASCII_SSE42(const std::uint8_t *in,
+                                           std::size_t length,
+                                           std::uint8_t *out)
+{
+    std::size_t i = 0;
+
+    for (; (length - i) >= 16; i += 16)
+    {
+        __m128i input =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        int non_ascii = _mm_movemask_epi8(input);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), input);
+
+        if (non_ascii != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(
+                                    static_cast<unsigned>(non_ascii)));
+        }
+    }
+
+    // Process the remaining octets
+    return i + CopyASCII_SWAR(in + i, length - i, out + i);
+}
+
+/*
+ *  ConvertLatin1ToUTF16_SSE42()
+ *
+ *  Description:
+ *      Convert the given Latin-1 input to UTF-16 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The Latin-1 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CHARUTIL_SSE42 void ConvertLatin1ToUTF16_SSE42(const std::uint8_t *in,
+                                               std::size_t length,
+                                               std::uint8_t *out,
+                                               bool little_endian)
+{
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; (length - i) >= 16; i += 16)
+    {
+        __m128i input =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+
+        // Interleave the octets with zeros in the required byte order
+        __m128i low = little_endian ? _mm_unpacklo_epi8(input, zero) :
+                                      _mm_unpacklo_epi8(zero, input);
+        __m128i high = little_endian ? _mm_unpackhi_epi8(input, zero) :
+                                       _mm_unpackhi_epi8(zero, input);
+        __m128i *p = reinterpret_cast<__m128i *>(out + (i * 2));
+        _mm_storeu_si128(p, low);
+        _mm_storeu_si128(p + 1, high);
+    }
+
+    // Process the remaining octets
+    ConvertLatin1ToUTF16_SWAR(in + i, length - i, out + (i * 2), little_endian);
+}
+
+/*
+ *  ConvertLatin1FromUTF16_SSE42()
+ *
+ *  Description:
+ *      Convert the run of characters no greater than 0xff at the start of the
+ *      given UTF-16 input to Latin-1 using SSE4.2 instructions.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the Latin-1 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      When a block contains a character above 0xff, the remaining characters
+ *      are handled by ConvertLatin1FromUTF16_SWAR().
+ */
+CHARUTIL_SSE42 std::size_t ConvertLatin1FromUTF16_SSE42(const std::uint8_t *in,
+                                                        std::size_t length,
+                                                        std::uint8_t *out,
+                                                        bool little_endian)
+{
+    // Bits that must be zero for a character to be Latin-1, as each
+    // character appears when loaded into a 16-bit lane
+    const __m128i non_latin1 =
+        _mm_set1_epi16(static_cast<short>(little_endian ? 0xff00 : 0x00ff));
+    std::size_t i = 0;
+
+    for (; (length - i) >= 32; i += 32)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(in + i);
+        __m128i input_0 = _mm_loadu_si128(p);
+        __m128i input_1 = _mm_loadu_si128(p + 1);
+
+        if (!_mm_testz_si128(_mm_or_si128(input_0, input_1), non_latin1))
+        {
+            break;
+        }
+
+        // Move each character into the low octet of its lane and pack
+        if (!little_endian)
+        {
+            input_0 = _mm_srli_epi16(input_0, 8);
+            input_1 = _mm_srli_epi16(input_1, 8);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (i / 2)),
+                         _mm_packus_epi16(input_0, input_1));
+    }
+
+    // Process the remaining characters
+    return i + ConvertLatin1FromUTF16_SWAR(in + i,
+                                           length - i,
+                                           out + (i / 2),
+                                           little_endian);
+}
+
+} // namespace Terra::CharUtil::SIMD
+
+#endif // CHARUTIL_X86_64
@@ -0,0 +1,954 @@
+/*
+ *  simd_swar.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Kernels that operate on eight octets at a time using ordinary 64-bit
+ *      integer operations ("SIMD within a register").  These are used when
+ *      no SIMD instruction set is available and to process the portion of
+ *      the input that is too short to fill a SIMD register.
+ *
+ *  Portability Issues:
+ *      The word-at-a-time code paths are only used on little endian hosts;
+ *      big endian hosts process one octet at a time.
+ */
+
+#include <bit>
+#include <cstring>
+#include "simd_dispatch.h"
+
+namespace Terra::CharUtil::SIMD
+{
+
+namespace
+{
+
+// Mask to select the high bit of each octet in a 64-bit word
+constexpr std::uint64_t High_Bits = 0x8080'8080'8080'8080;
+
+/*
+ *  Widen()
+ *
+ *  Description:
+ *      Spread the four octets in the low 32 bits of the given value into the
+ *      low octet of four 16-bit lanes.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value containing four octets.
+ *
+ *  Returns:
+ *      The value with each octet moved into its own 16-bit lane.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint64_t Widen(std::uint64_t value)
+{
+    value &= 0xffff'ffff;
+    value = (value | (value << 16)) & 0x0000'ffff'0000'ffff;
+    value = (value | (value << 8)) & 0x00ff'00ff'00ff'00ff;
+
+    return value;
+}
+
+/*
+ *  Narrow()
+ *
+ *  Description:
+ *      Gather the low octet of each of the four 16-bit lanes in the given
+ *      value into the low 32 bits.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value containing four 16-bit lanes.
+ *
+ *  Returns:
+ *      The value with the low octet of each lane packed together.
+ *
+ *  Comments:
+ *      This is the inverse of Widen().
+ */
+constexpr std::uint64_t Narrow(std::uint64_t value)
+{
+    value &= 0x00ff'00ff'00ff'00ff;
+    value = (value | (value >> 8)) & 0x0000'ffff'0000'ffff;
+    value = (value | (value >> 16)) & 0xffff'ffff;
+
+    return value;
+}
+
+} // namespace
+
+/*
+ *  ConvertASCIIToUTF16_SWAR()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-16, processing eight octets at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertASCIIToUTF16_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process eight octets at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const unsigned shift = little_endian ? 0 : 8;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if ((word & High_Bits) != 0) break;
+
+            std::uint64_t low = Widen(word) << shift;
+            std::uint64_t high = Widen(word >> 32) << shift;
+            std::memcpy(out + (i * 2), &low, sizeof(low));
+            std::memcpy(out + (i * 2) + 8, &high, sizeof(high));
+        }
+    }
+
+    // Process any remaining ASCII octets one at a time
+    for (; (i < length) && (in[i] < 0x80); i++)
+    {
+        out[(i * 2) + (little_endian ? 0 : 1)] = in[i];
+        out[(i * 2) + (little_endian ? 1 : 0)] = 0;
+    }
+
+    return i;
+}
+
+/*
+ *  ConvertASCIIFromUTF16_SWAR()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-16
+ *      input to UTF-8, processing four characters at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      ASCII characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertASCIIFromUTF16_SWAR(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process four characters at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const std::uint64_t non_ascii = little_endian ? 0xff80'ff80'ff80'ff80 :
+                                                        0x80ff'80ff'80ff'80ff;
+        const unsigned shift = little_endian ? 0 : 8;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if ((word & non_ascii) != 0) break;
+
+            std::uint32_t narrow =
+                static_cast<std::uint32_t>(Narrow(word >> shift));
+            std::memcpy(out + (i / 2), &narrow, sizeof(narrow));
+        }
+    }
+
+    // Process any remaining ASCII characters one at a time
+    for (; (length - i) >= 2; i += 2)
+    {
+        std::uint8_t high = in[i + (little_endian ? 1 : 0)];
+        std::uint8_t low = in[i + (little_endian ? 0 : 1)];
+        if ((high != 0) || (low >= 0x80)) break;
+        out[i / 2] = low;
+    }
+
+    return i;
+}
+
+/*
+ *  UTF16LengthFromUTF8_SWAR()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-8
+ *      input as UTF-16, processing eight octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.
+ *
+ *  Returns:
+ *      The length of the UTF-16 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.
+ */
+std::size_t UTF16LengthFromUTF8_SWAR(const std::uint8_t *octets,
+                                     std::size_t length)
+{
+    std::size_t characters = 0;
+    std::size_t i = 0;
+
+    // Every octet other than a continuation octet (10xxxxxx) starts a
+    // character, and those starting with 11110xxx need a surrogate pair
+    for (; (length - i) >= 8; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, octets + i, sizeof(word));
+
+        std::uint64_t continuation = word & ~(word << 1) & High_Bits;
+        std::uint64_t four_octet =
+            word & (word << 1) & (word << 2) & (word << 3) & High_Bits;
+
+        characters += 8 - static_cast<std::size_t>(std::popcount(continuation));
+        characters += static_cast<std::size_t>(std::popcount(four_octet));
+    }
+
+    // Process the remaining octets
+    for (; i < length; i++)
+    {
+        if ((octets[i] & 0xc0) != 0x80) characters++;
+        if (octets[i] >= 0xf0) characters++;
+    }
+
+    return characters * 2;
+}
+
+/*
+ *  UTF8LengthFromUTF16_SWAR()
+ *
+ *  Description:
+ *      Compute the number of octets required to represent the given UTF-16
+ *      input as UTF-8, processing eight octets at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to measure.
+ *
+ *      length [in]
+ *          The number of octets to measure.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The length of the UTF-8 encoding in octets.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.
+ */
+std::size_t UTF8LengthFromUTF16_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     bool little_endian)
+{
+    std::size_t utf8_length = 0;
+    std::size_t i = 0;
+
+    // Each character requires one octet, plus one more if >= 0x80 and one
+    // more if >= 0x800; each half of a surrogate pair is counted as three
+    // octets, so one is subtracted from each to produce four in total
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        constexpr std::uint64_t Lane_High = 0x8000'8000'8000'8000;
+        constexpr std::uint64_t Lane_Low = 0x7fff'7fff'7fff'7fff;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if (!little_endian)
+            {
+                word = ((word >> 8) & 0x00ff'00ff'00ff'00ff) |
+                       ((word & 0x00ff'00ff'00ff'00ff) << 8);
+            }
+
+            // Set the high bit of each lane having a value at or above each
+            // threshold without carrying into the next lane
+            std::uint64_t low = word & Lane_Low;
+            std::uint64_t two_octet =
+                ((low + 0x7f80'7f80'7f80'7f80) | word) & Lane_High;
+            std::uint64_t three_octet =
+                ((low + 0x7800'7800'7800'7800) | word) & Lane_High;
+
+            // Surrogates are those lanes that have the value 11011xxx in
+            // the upper octet
+            std::uint64_t surrogate = word ^ 0xd800'd800'd800'd800;
+            std::uint64_t not_surrogate =
+                (((surrogate & Lane_Low) + 0x7800'7800'7800'7800) |
+                 surrogate) &
+                Lane_High;
+
+            utf8_length += 4 +
+                static_cast<std::size_t>(std::popcount(two_octet)) +
+                static_cast<std::size_t>(std::popcount(three_octet)) -
+                (4 - static_cast<std::size_t>(std::popcount(not_surrogate)));
+        }
+    }
+
+    // Process the remaining characters
+    for (; (length - i) >= 2; i += 2)
+    {
+        std::uint16_t character =
+            little_endian ? static_cast<std::uint16_t>(in[i] |
+                                                       (in[i + 1] << 8)) :
+                            static_cast<std::uint16_t>((in[i] << 8) |
+                                                       in[i + 1]);
+        utf8_length++;
+        if (character >= 0x80) utf8_length++;
+        if (character >= 0x800) utf8_length++;
+        if ((character & 0xf800) == 0xd800) utf8_length--;
+    }
+
+    return utf8_length;
+}
+
+/*
+ *  CountUTF8CodePoints_SWAR()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-8 input, processing
+ *      eight octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-8.
+ */
+std::size_t CountUTF8CodePoints_SWAR(const std::uint8_t *octets,
+                                     std::size_t length)
+{
+    std::size_t code_points = 0;
+    std::size_t i = 0;
+
+    // Every octet other than a continuation octet (10xxxxxx) starts a
+    // code point
+    for (; (length - i) >= 8; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, octets + i, sizeof(word));
+
+        std::uint64_t continuation = word & ~(word << 1) & High_Bits;
+
+        code_points +=
+            8 - static_cast<std::size_t>(std::popcount(continuation));
+    }
+
+    // Process the remaining octets
+    for (; i < length; i++)
+    {
+        if ((octets[i] & 0xc0) != 0x80) code_points++;
+    }
+
+    return code_points;
+}
+
+/*
+ *  CountUTF16CodePoints_SWAR()
+ *
+ *  Description:
+ *      Count the number of code points in the given UTF-16 input, processing
+ *      eight octets at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to count.
+ *
+ *      length [in]
+ *          The number of octets to count.  Any odd final octet is ignored.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of code points.
+ *
+ *  Comments:
+ *      The result is only meaningful if the input is valid UTF-16.
+ */
+std::size_t CountUTF16CodePoints_SWAR(const std::uint8_t *in,
+                                      std::size_t length,
+                                      bool little_endian)
+{
+    std::size_t low_surrogates = 0;
+    std::size_t i = 0;
+
+    // Every code unit is a code point except for low surrogates, which
+    // complete a code point started by the preceding high surrogate; these
+    // are identified by the upper octet, which has the value 110111xx
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const std::uint64_t upper_octets = little_endian ?
+                                               0x8000'8000'8000'8000 :
+                                               0x0080'0080'0080'0080;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+
+            // Set the high bit of each octet whose upper six bits match
+            std::uint64_t x = (word ^ 0xdcdc'dcdc'dcdc'dcdc) &
+                              0xfcfc'fcfc'fcfc'fcfc;
+            std::uint64_t match = ~(((x & ~High_Bits) + ~High_Bits) | x) &
+                                  upper_octets;
+
+            low_surrogates += static_cast<std::size_t>(std::popcount(match));
+        }
+    }
+
+    // Process the remaining characters
+    for (; (length - i) >= 2; i += 2)
+    {
+        std::uint8_t upper = little_endian ? in[i + 1] : in[i];
+        if ((upper & 0xfc) == 0xdc) low_surrogates++;
+    }
+
+    return (i / 2) - low_surrogates;
+}
+
+/*
+ *  ConvertASCIIToUTF32_SWAR()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-8
+ *      input to UTF-32, processing eight octets at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-8 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least four times the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of ASCII characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertASCIIToUTF32_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process eight octets at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const unsigned shift = little_endian ? 0 : 24;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if ((word & High_Bits) != 0) break;
+
+            // Spread each pair of octets into two 32-bit lanes
+            for (unsigned j = 0; j < 4; j++)
+            {
+                std::uint64_t pair = (word >> (j * 16)) & 0xffff;
+                pair = ((pair | (pair << 24)) & 0x0000'00ff'0000'00ff) << shift;
+                std::memcpy(out + (i * 4) + (j * 8), &pair, sizeof(pair));
+            }
+        }
+    }
+
+    // Process any remaining ASCII octets one at a time
+    for (; (i < length) && (in[i] < 0x80); i++)
+    {
+        out[(i * 4) + 0] = little_endian ? in[i] : 0;
+        out[(i * 4) + 1] = 0;
+        out[(i * 4) + 2] = 0;
+        out[(i * 4) + 3] = little_endian ? 0 : in[i];
+    }
+
+    return i;
+}
+
+/*
+ *  ConvertASCIIFromUTF32_SWAR()
+ *
+ *  Description:
+ *      Convert the run of ASCII characters at the start of the given UTF-32
+ *      input to UTF-8, processing two characters at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-8 octets.  This must be
+ *          at least one quarter the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of ASCII characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertASCIIFromUTF32_SWAR(const std::uint8_t *in,
+                                       std::size_t length,
+                                       std::uint8_t *out,
+                                       bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process two characters at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const std::uint64_t non_ascii = little_endian ? 0xffff'ff80'ffff'ff80 :
+                                                        0x80ff'ffff'80ff'ffff;
+        const unsigned shift = little_endian ? 0 : 24;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if ((word & non_ascii) != 0) break;
+
+            out[(i / 4) + 0] = static_cast<std::uint8_t>(word >> shift);
+            out[(i / 4) + 1] = static_cast<std::uint8_t>(word >> (shift + 32));
+        }
+    }
+
+    // Process any remaining ASCII characters one at a time
+    for (; (length - i) >= 4; i += 4)
+    {
+        std::uint8_t low = in[i + (little_endian ? 0 : 3)];
+        if ((low >= 0x80) ||
+            ((in[i + (little_endian ? 1 : 2)] |
+              in[i + (little_endian ? 2 : 1)] |
+              in[i + (little_endian ? 3 : 0)]) != 0))
+        {
+            break;
+        }
+        out[i / 4] = low;
+    }
+
+    return i;
+}
+
+/*
+ *  ConvertUTF16ToUTF32_SWAR()
+ *
+ *  Description:
+ *      Convert the run of characters that are not surrogates at the start of
+ *      the given UTF-16 input to UTF-32, processing four characters at a
+ *      time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-32 octets.  This must be
+ *          at least twice the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 and UTF-32 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertUTF16ToUTF32_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process four characters at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        constexpr std::uint64_t Lane_High = 0x8000'8000'8000'8000;
+        constexpr std::uint64_t Lane_Low = 0x7fff'7fff'7fff'7fff;
+        const unsigned shift = little_endian ? 0 : 16;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+
+            // Surrogates are those lanes that have the value 11011xxx in the
+            // upper octet of the character
+            std::uint64_t surrogate =
+                word ^ (little_endian ? 0xd800'd800'd800'd800 :
+                                        0x00d8'00d8'00d8'00d8);
+            if (!little_endian)
+            {
+                surrogate = ((surrogate >> 8) & 0x00ff'00ff'00ff'00ff) |
+                            ((surrogate & 0x00ff'00ff'00ff'00ff) << 8);
+            }
+            std::uint64_t not_surrogate =
+                (((surrogate & Lane_Low) + 0x7800'7800'7800'7800) |
+                 surrogate) &
+                Lane_High;
+            if (not_surrogate != Lane_High) break;
+
+            // Move each character into its own 32-bit lane; a big endian
+            // character occupies the upper half of its lane
+            std::uint64_t low = (((word & 0xffff) |
+                                  ((word & 0xffff'0000) << 16))) << shift;
+            std::uint64_t high = ((((word >> 32) & 0xffff) |
+                                   ((word >> 16) & 0xffff'0000'0000))) << shift;
+            std::memcpy(out + (i * 2), &low, sizeof(low));
+            std::memcpy(out + (i * 2) + 8, &high, sizeof(high));
+        }
+    }
+
+    // Process any remaining characters one at a time
+    for (; (length - i) >= 2; i += 2)
+    {
+        std::uint8_t high = in[i + (little_endian ? 1 : 0)];
+        std::uint8_t low = in[i + (little_endian ? 0 : 1)];
+        if ((high & 0xf8) == 0xd8) break;
+        out[(i * 2) + 0] = little_endian ? low : 0;
+        out[(i * 2) + 1] = little_endian ? high : 0;
+        out[(i * 2) + 2] = little_endian ? 0 : high;
+        out[(i * 2) + 3] = little_endian ? 0 : low;
+    }
+
+    return i;
+}
+
+/*
+ *  ConvertUTF32ToUTF16_SWAR()
+ *
+ *  Description:
+ *      Convert the run of characters in the Basic Multilingual Plane (other
+ *      than surrogates) at the start of the given UTF-32 input to UTF-16,
+ *      processing two characters at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-32 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any partial final
+ *          character is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-32 and UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-32 octets consumed, which is four times the number
+ *      of characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertUTF32ToUTF16_SWAR(const std::uint8_t *in,
+                                     std::size_t length,
+                                     std::uint8_t *out,
+                                     bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process two characters at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        // Bits that must be zero for a character to be in the BMP and the
+        // bits that identify a surrogate, as each character appears when
+        // loaded into a 32-bit lane
+        const std::uint64_t non_bmp = little_endian ? 0xffff'0000'ffff'0000 :
+                                                      0x0000'ffff'0000'ffff;
+        const std::uint64_t surrogate_mask = little_endian ? 0xf800 : 0xf8'0000;
+        const std::uint64_t surrogate = little_endian ? 0xd800 : 0xd8'0000;
+        const unsigned shift = little_endian ? 0 : 16;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if (((word & non_bmp) != 0) ||
+                ((word & surrogate_mask) == surrogate) ||
+                (((word >> 32) & surrogate_mask) == surrogate))
+            {
+                break;
+            }
+
+            std::uint32_t narrow =
+                static_cast<std::uint32_t>(((word >> shift) & 0xffff) |
+                                           ((word >> (shift + 16)) &
+                                            0xffff'0000));
+            std::memcpy(out + (i / 2), &narrow, sizeof(narrow));
+        }
+    }
+
+    // Process any remaining characters one at a time
+    for (; (length - i) >= 4; i += 4)
+    {
+        std::uint8_t high = in[i + (little_endian ? 1 : 2)];
+        std::uint8_t low = in[i + (little_endian ? 0 : 3)];
+        if (((in[i + (little_endian ? 2 : 1)] |
+              in[i + (little_endian ? 3 : 0)]) != 0) ||
+            ((high & 0xf8) == 0xd8))
+        {
+            break;
+        }
+        out[(i / 2) + (little_endian ? 0 : 1)] = low;
+        out[(i / 2) + (little_endian ? 1 : 0)] = high;
+    }
+
+    return i;
+}
+
+/*
+ *  CopyASCII_SWAR()
+ *
+ *  Description:
+ *      Copy the run of ASCII characters at the start of the given input,
+ *      processing eight octets at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The octets to copy.
+ *
+ *      length [in]
+ *          The number of octets available to copy.
+ *
+ *      out [out]
+ *          The buffer into which to copy the octets.  This must be at least
+ *          the input length.
+ *
+ *  Returns:
+ *      The number of ASCII characters copied.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t CopyASCII_SWAR(const std::uint8_t *in,
+                           std::size_t length,
+                           std::uint8_t *out)
+{
+    std::size_t i = 0;
+
+    // Process eight octets at a time
+    for (; (length - i) >= 8; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, in + i, sizeof(word));
+        if ((word & High_Bits) != 0) break;
+        std::memcpy(out + i, &word, sizeof(word));
+    }
+
+    // Process any remaining ASCII octets one at a time
+    for (; (i < length) && (in[i] < 0x80); i++) out[i] = in[i];
+
+    return i;
+}
+
+/*
+ *  ConvertLatin1ToUTF16_SWAR()
+ *
+ *  Description:
+ *      Convert the given Latin-1 input to UTF-16, processing eight octets at
+ *      a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The Latin-1 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets to convert.
+ *
+ *      out [out]
+ *          The buffer into which to write the UTF-16 octets.  This must be
+ *          twice the input length.
+ *
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ConvertLatin1ToUTF16_SWAR(const std::uint8_t *in,
+                               std::size_t length,
+                               std::uint8_t *out,
+                               bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process eight octets at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const unsigned shift = little_endian ? 0 : 8;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+
+            std::uint64_t low = Widen(word) << shift;
+            std::uint64_t high = Widen(word >> 32) << shift;
+            std::memcpy(out + (i * 2), &low, sizeof(low));
+            std::memcpy(out + (i * 2) + 8, &high, sizeof(high));
+        }
+    }
+
+    // Process any remaining octets one at a time
+    for (; i < length; i++)
+    {
+        out[(i * 2) + (little_endian ? 0 : 1)] = in[i];
+        out[(i * 2) + (little_endian ? 1 : 0)] = 0;
+    }
+}
+
+/*
+ *  ConvertLatin1FromUTF16_SWAR()
+ *
+ *  Description:
+ *      Convert the run of characters no greater than 0xff at the start of the
+ *      given UTF-16 input to Latin-1, processing four characters at a time.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The UTF-16 octets to convert.
+ *
+ *      length [in]
+ *          The number of octets available to convert.  Any odd final octet
+ *          is ignored.
+ *
+ *      out [out]
+ *          The buffer into which to write the Latin-1 octets.  This must be
+ *          at least half the input length.
+ *
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      The number of UTF-16 octets consumed, which is twice the number of
+ *      characters converted.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t ConvertLatin1FromUTF16_SWAR(const std::uint8_t *in,
+                                        std::size_t length,
+                                        std::uint8_t *out,
+                                        bool little_endian)
+{
+    std::size_t i = 0;
+
+    // Process four characters at a time
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const std::uint64_t non_latin1 = little_endian ?
+                                             0xff00'ff00'ff00'ff00 :
+                                             0x00ff'00ff'00ff'00ff;
+        const unsigned shift = little_endian ? 0 : 8;
+
+        for (; (length - i) >= 8; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            if ((word & non_latin1) != 0) break;
+
+            std::uint32_t narrow =
+                static_cast<std::uint32_t>(Narrow(word >> shift));
+            std::memcpy(out + (i / 2), &narrow, sizeof(narrow));
+        }
+    }
+
+    // Process any remaining characters one at a time
+    for (; (length - i) >= 2; i += 2)
+    {
+        if (in[i + (little_endian ? 1 : 0)] != 0) break;
+        out[i / 2] = in[i + (little_endian ? 0 : 1)];
+    }
+
+    return i;
+}
+
+} // namespace Terra::CharUtil::SIMD
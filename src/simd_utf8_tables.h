@@ -0,0 +1,146 @@
+/*
+ *  simd_utf8_tables.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Lookup tables used by the SIMD UTF-8 validation kernels.  The
+ *      validation algorithm is described in "Validating UTF-8 In Less Than
+ *      One Instruction Per Byte" by John Keiser and Daniel Lemire
+ *      (https://arxiv.org/abs/2010.03090).  Each pair of adjacent octets is
+ *      classified using three 16-entry tables indexed by the high nibble of
+ *      the first octet, the low nibble of the first octet, and the high
+ *      nibble of the second octet.  The bitwise AND of the three lookups is
+ *      non-zero only if the pair of octets is in error.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Terra::CharUtil::SIMD::UTF8Tables
+{
+
+// Error classes (one bit each)
+constexpr std::uint8_t Too_Short = 1 << 0;      // 11______ 0_______
+                                                // 11______ 11______
+constexpr std::uint8_t Too_Long = 1 << 1;       // 0_______ 10______
+constexpr std::uint8_t Overlong_3 = 1 << 2;     // 11100000 100_____
+constexpr std::uint8_t Too_Large = 1 << 3;      // 11110100 1001____
+                                                // 11110100 101_____
+                                                // 11110101 1001____
+                                                // 11110101 101_____
+                                                // 1111011_ 1001____
+                                                // 1111011_ 101_____
+                                                // 11111___ 1001____
+                                                // 11111___ 101_____
+constexpr std::uint8_t Surrogate = 1 << 4;      // 11101101 101_____
+constexpr std::uint8_t Overlong_2 = 1 << 5;     // 1100000_ 10______
+constexpr std::uint8_t Too_Large_1000 = 1 << 6; // 11110101 1000____
+                                                // 1111011_ 1000____
+                                                // 11111___ 1000____
+constexpr std::uint8_t Overlong_4 = 1 << 6;     // 11110000 1000____
+constexpr std::uint8_t Two_Conts = 1 << 7;      // 10______ 10______
+
+// Errors that do not depend on the low nibble of the first octet
+constexpr std::uint8_t Carry = Too_Short | Too_Long | Two_Conts;
+
+// Indexed by the high nibble of the first octet
+alignas(16) constexpr std::uint8_t Byte_1_High[16] =
+{
+    // 0_______ ________ <ASCII in byte 1>
+    Too_Long, Too_Long, Too_Long, Too_Long,
+    Too_Long, Too_Long, Too_Long, Too_Long,
+
+    // 10______ ________ <continuation in byte 1>
+    Two_Conts, Two_Conts, Two_Conts, Two_Conts,
+
+    // 1100____ ________ <two octet lead in byte 1>
+    Too_Short | Overlong_2,
+
+    // 1101____ ________ <two octet lead in byte 1>
+    Too_Short,
+
+    // 1110____ ________ <three octet lead in byte 1>
+    Too_Short | Overlong_3 | Surrogate,
+
+    // 1111____ ________ <four+ octet lead in byte 1>
+    Too_Short | Too_Large | Too_Large_1000 | Overlong_4
+};
+
+// Indexed by the low nibble of the first octet
+alignas(16) constexpr std::uint8_t Byte_1_Low[16] =
+{
+    // ____0000 ________
+    Carry | Overlong_3 | Overlong_2 | Overlong_4,
+
+    // ____0001 ________
+    Carry | Overlong_2,
+
+    // ____001_ ________
+    Carry,
+    Carry,
+
+    // ____0100 ________
+    Carry | Too_Large,
+
+    // ____0101 ________
+    Carry | Too_Large | Too_Large_1000,
+
+    // ____011_ ________
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000,
+
+    // ____1___ ________
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000,
+
+    // ____1101 ________
+    Carry | Too_Large | Too_Large_1000 | Surrogate,
+
+    Carry | Too_Large | Too_Large_1000,
+    Carry | Too_Large | Too_Large_1000
+};
+
+// Indexed by the high nibble of the second octet
+alignas(16) constexpr std::uint8_t Byte_2_High[16] =
+{
+    // ________ 0_______ <ASCII in byte 2>
+    Too_Short, Too_Short, Too_Short, Too_Short,
+    Too_Short, Too_Short, Too_Short, Too_Short,
+
+    // ________ 1000____
+    Too_Long | Overlong_2 | Two_Conts | Overlong_3 | Too_Large_1000 |
+        Overlong_4,
+
+    // ________ 1001____
+    Too_Long | Overlong_2 | Two_Conts | Overlong_3 | Too_Large,
+
+    // ________ 101_____
+    Too_Long | Overlong_2 | Two_Conts | Surrogate | Too_Large,
+    Too_Long | Overlong_2 | Two_Conts | Surrogate | Too_Large,
+
+    // ________ 11______
+    Too_Short, Too_Short, Too_Short, Too_Short
+};
+
+// Octets at the end of a block that are greater than these values start a
+// sequence that is incomplete (i.e., continues into the next block)
+alignas(16) constexpr std::uint8_t Incomplete_Maximum[16] =
+{
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+};
+
+} // namespace Terra::CharUtil::SIMD::UTF8Tables
@@ -0,0 +1,232 @@
+/*
+ *  utf16_to_utf8_converter.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements an object that will convert a stream of UTF-16
+ *      octets (either little endian or big endian) to UTF-8 as successive
+ *      chunks of the stream become available.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <terra/charutil/utf16_to_utf8_converter.h>
+
+namespace Terra::CharUtil
+{
+
+namespace
+{
+
+/*
+ *  IsHighSurrogate()
+ *
+ *  Description:
+ *      Determine whether the UTF-16 character at the given location is a
+ *      high surrogate.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The two octets of the UTF-16 character.
+ *
+ *      little_endian [in]
+ *          Is the UTF-16 character in little endian order?
+ *
+ *  Returns:
+ *      True if the character is a high surrogate, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr bool IsHighSurrogate(const std::uint8_t *octets, bool little_endian)
+{
+    return (octets[little_endian ? 1 : 0] & 0xfc) == 0xd8;
+}
+
+} // namespace
+
+/*
+ *  UTF16ToUTF8Converter::UTF16ToUTF8Converter()
+ *
+ *  Description:
+ *      Constructor for the UTF16ToUTF8Converter object.
+ *
+ *  Parameters:
+ *      little_endian [in]
+ *          Are the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+UTF16ToUTF8Converter::UTF16ToUTF8Converter(bool little_endian) :
+    little_endian{little_endian},
+    pending{},
+    pending_length{}
+{
+}
+
+/*
+ *  UTF16ToUTF8Converter::Feed()
+ *
+ *  Description:
+ *      Convert the next chunk of the UTF-16 stream to UTF-8, stopping when
+ *      the chunk is exhausted or when the next character will not fit in the
+ *      output span.  An odd final octet or a high surrogate at the end of
+ *      the chunk is retained and completed by the next call.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The next chunk of the UTF-16 stream.  This may have any length.
+ *
+ *      out [out]
+ *          The span into which the UTF-8 octets are written.  This may be of
+ *          any size, though a span at least 1.5x larger than the input span
+ *          plus four octets will always accept the entire chunk.
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the chunk length only if the output span
+ *      was filled, in which case the remainder of the chunk should be given
+ *      in the next call.  On failure, the number of octets consumed indicates
+ *      where the invalid character begins (or zero if the invalid character
+ *      began in a previous chunk) and the error indicates why it is invalid.
+ *
+ *  Comments:
+ *      Once an error is reported, Reset() must be called before converting
+ *      another stream.
+ */
+ConversionResult UTF16ToUTF8Converter::Feed(std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    std::size_t consumed{};
+    std::size_t produced{};
+
+    // Complete any character left incomplete by the previous chunk
+    if (pending_length > 0)
+    {
+        std::array<std::uint8_t, 4> octets = pending;
+        std::size_t available = std::min(octets.size() - pending_length,
+                                         in.size());
+        std::copy(in.begin(),
+                  in.begin() + available,
+                  octets.begin() + pending_length);
+        available += pending_length;
+
+        // Determine the length of the character (or surrogate pair)
+        std::size_t character_length =
+            ((available >= 2) && IsHighSurrogate(octets.data(), little_endian))
+                ? 4 : 2;
+
+        // If the character is still incomplete, retain what is available
+        if (available < character_length)
+        {
+            pending = octets;
+            pending_length = available;
+            return {true, in.size(), 0, UnicodeError::None};
+        }
+
+        // Convert the completed character
+        ConversionResult result = ConvertUTF16ToUTF8Partial(
+            std::span<const std::uint8_t>(octets.data(), character_length),
+            out,
+            little_endian);
+        if (!result.success) return {false, 0, 0, result.error};
+
+        // If the character did not fit, it remains pending
+        if (result.produced == 0) return {true, 0, 0, UnicodeError::None};
+
+        consumed = character_length - pending_length;
+        produced = result.produced;
+        pending_length = 0;
+    }
+
+    // Locate the end of the last complete character in the chunk, which
+    // excludes any odd final octet and a final high surrogate
+    std::size_t boundary =
+        consumed + ((in.size() - consumed) & ~std::size_t{1});
+    if (((boundary - consumed) >= 2) &&
+        IsHighSurrogate(in.data() + boundary - 2, little_endian))
+    {
+        boundary -= 2;
+    }
+
+    // Convert the complete characters in the chunk
+    ConversionResult result = ConvertUTF16ToUTF8Partial(
+        in.subspan(consumed, boundary - consumed),
+        out.subspan(produced),
+        little_endian);
+    consumed += result.consumed;
+    produced += result.produced;
+
+    // Stop on error or if the output span was filled
+    if (!result.success || (consumed < boundary))
+    {
+        return {result.success, consumed, produced, result.error};
+    }
+
+    // Retain the incomplete character at the end of the chunk
+    pending_length = in.size() - boundary;
+    std::copy(in.begin() + boundary, in.end(), pending.begin());
+
+    return {true, in.size(), produced, UnicodeError::None};
+}
+
+/*
+ *  UTF16ToUTF8Converter::Finish()
+ *
+ *  Description:
+ *      Indicate that the end of the UTF-16 stream has been reached.  This
+ *      resets the object so that it may be used to convert another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the stream ended on a character boundary or false if it
+ *      ended with an odd octet or an unpaired high surrogate.
+ *
+ *  Comments:
+ *      None.
+ */
+bool UTF16ToUTF8Converter::Finish()
+{
+    bool complete = pending_length == 0;
+
+    Reset();
+
+    return complete;
+}
+
+/*
+ *  UTF16ToUTF8Converter::Reset()
+ *
+ *  Description:
+ *      Discard any incomplete character so that the object may be used to
+ *      convert another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void UTF16ToUTF8Converter::Reset()
+{
+    pending_length = 0;
+}
+
+} // namespace Terra::CharUtil
@@ -0,0 +1,265 @@
+/*
+ *  utf8_dfa.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      A table-driven deterministic finite automaton (DFA) that recognizes
+ *      well-formed UTF-8 as defined in IETF RFC 3629 (and Table 3-7 of the
+ *      Unicode Standard).  Overlong encodings, surrogates, and values above
+ *      0x10ffff are all rejected by the transitions themselves, so no
+ *      data-dependent branches are needed to check the decoded value.
+ *
+ *      The transitions are defined in terms of twelve octet classes, from
+ *      which a row of 64 bits is produced for each octet value.  The row
+ *      holds the next state for every current state in a six bit field, and
+ *      each state value is the position of its field.  Advancing the DFA is
+ *      thus a single table lookup indexed by the octet (which does not
+ *      depend on the previous state) followed by a shift, so successive
+ *      octets are processed with a dependency chain of only a few cycles.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace Terra::CharUtil::UTF8DFA
+{
+
+// Number of octet classes
+constexpr std::size_t Classes = 12;
+
+// States: a complete character has been seen, the input is ill-formed, or
+// more octets of a multi-octet sequence are expected
+constexpr std::uint8_t Accept = 0 * 6;
+constexpr std::uint8_t Reject = 1 * 6;
+constexpr std::uint8_t One = 2 * 6;             // One more 80..bf
+constexpr std::uint8_t Two = 3 * 6;             // Two more 80..bf
+constexpr std::uint8_t E0 = 4 * 6;              // a0..bf, then One
+constexpr std::uint8_t ED = 5 * 6;              // 80..9f, then One
+constexpr std::uint8_t F0 = 6 * 6;              // 90..bf, then Two
+constexpr std::uint8_t F1 = 7 * 6;              // 80..bf, then Two
+constexpr std::uint8_t F4 = 8 * 6;              // 80..8f, then Two
+
+// Number of states
+constexpr std::size_t States = 9;
+
+/*
+ *  MakeOctetClasses()
+ *
+ *  Description:
+ *      Produce the table that maps each octet value to its class.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The octet class table.
+ *
+ *  Comments:
+ *      The classes are:
+ *           0: 00..7f          4: c0..c1, f5..ff     8: ed
+ *           1: 80..8f          5: c2..df             9: f0
+ *           2: 90..9f          6: e0                10: f1..f3
+ *           3: a0..bf          7: e1..ec, ee..ef    11: f4
+ */
+constexpr std::array<std::uint8_t, 256> MakeOctetClasses()
+{
+    std::array<std::uint8_t, 256> classes{};
+
+    for (std::size_t octet = 0; octet < classes.size(); octet++)
+    {
+        classes[octet] = (octet <= 0x7f) ? 0 :
+                         (octet <= 0x8f) ? 1 :
+                         (octet <= 0x9f) ? 2 :
+                         (octet <= 0xbf) ? 3 :
+                         (octet <= 0xc1) ? 4 :
+                         (octet <= 0xdf) ? 5 :
+                         (octet == 0xe0) ? 6 :
+                         (octet == 0xed) ? 8 :
+                         (octet <= 0xef) ? 7 :
+                         (octet == 0xf0) ? 9 :
+                         (octet <= 0xf3) ? 10 :
+                         (octet == 0xf4) ? 11 : 4;
+    }
+
+    return classes;
+}
+
+// Class of each octet value
+constexpr std::array<std::uint8_t, 256> Octet_Classes = MakeOctetClasses();
+
+// Next state, indexed by the current state (divided by six) times the number
+// of classes plus the class of the octet
+constexpr std::array<std::uint8_t, States * Classes> Transitions =
+{
+    // Accept
+    Accept, Reject, Reject, Reject, Reject, One,
+    E0,     Two,    ED,     F0,     F1,     F4,
+    // Reject
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // One
+    Reject, Accept, Accept, Accept, Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // Two
+    Reject, One,    One,    One,    Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // E0
+    Reject, Reject, Reject, One,    Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // ED
+    Reject, One,    One,    Reject, Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // F0
+    Reject, Reject, Two,    Two,    Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // F1
+    Reject, Two,    Two,    Two,    Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject,
+    // F4
+    Reject, Two,    Reject, Reject, Reject, Reject,
+    Reject, Reject, Reject, Reject, Reject, Reject
+};
+
+/*
+ *  MakeRows()
+ *
+ *  Description:
+ *      Produce the table that holds, for each octet value, the next state
+ *      for every current state.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The table of rows indexed by octet value.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::array<std::uint64_t, 256> MakeRows()
+{
+    std::array<std::uint64_t, 256> rows{};
+
+    for (std::size_t octet = 0; octet < rows.size(); octet++)
+    {
+        for (std::size_t state = 0; state < States; state++)
+        {
+            std::uint64_t next =
+                Transitions[state * Classes + Octet_Classes[octet]];
+            rows[octet] |= next << (state * 6);
+        }
+    }
+
+    return rows;
+}
+
+// Next state for every current state, indexed by octet value
+constexpr std::array<std::uint64_t, 256> Rows = MakeRows();
+
+/*
+ *  MakeLeadMasks()
+ *
+ *  Description:
+ *      Produce the table that holds, for each octet value, the bits that
+ *      contribute to the character when the octet begins a sequence.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The table of masks indexed by octet value.
+ *
+ *  Comments:
+ *      Octets that cannot begin a sequence have a mask of zero.
+ */
+constexpr std::array<std::uint8_t, 256> MakeLeadMasks()
+{
+    constexpr std::array<std::uint8_t, Classes> class_masks =
+    {
+        0x7f, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x0f, 0x0f, 0x0f, 0x07, 0x07, 0x07
+    };
+    std::array<std::uint8_t, 256> masks{};
+
+    for (std::size_t octet = 0; octet < masks.size(); octet++)
+    {
+        masks[octet] = class_masks[Octet_Classes[octet]];
+    }
+
+    return masks;
+}
+
+// Bits of a lead octet that contribute to the character
+constexpr std::array<std::uint8_t, 256> Lead_Masks = MakeLeadMasks();
+
+/*
+ *  Advance()
+ *
+ *  Description:
+ *      Advance the DFA by one octet.
+ *
+ *  Parameters:
+ *      state [in]
+ *          The current state.
+ *
+ *      octet [in]
+ *          The next octet of input.
+ *
+ *  Returns:
+ *      The next state.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint8_t Advance(std::uint8_t state, std::uint8_t octet)
+{
+    return static_cast<std::uint8_t>((Rows[octet] >> state) & 0x3f);
+}
+
+/*
+ *  IsSequencePrefix()
+ *
+ *  Description:
+ *      Determine whether the given octets are the start of a well-formed
+ *      multi-octet sequence that is not yet complete.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to check.
+ *
+ *      length [in]
+ *          The number of octets to check.
+ *
+ *  Returns:
+ *      True if further octets could complete the sequence, false if the
+ *      octets are empty, complete, or can never be well-formed.
+ *
+ *  Comments:
+ *      This is used by the streaming objects to decide whether octets at the
+ *      end of a chunk should be retained for the next chunk.
+ */
+constexpr bool IsSequencePrefix(const std::uint8_t *octets, std::size_t length)
+{
+    std::uint8_t state = Accept;
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        state = Advance(state, octets[i]);
+        if (state == Reject) return false;
+    }
+
+    return state != Accept;
+}
+
+} // namespace Terra::CharUtil::UTF8DFA
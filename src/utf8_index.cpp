@@ -0,0 +1,302 @@
+/*
+ *  utf8_index.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements an object that maps between code point positions
+ *      and octet offsets within a UTF-8 string.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <terra/charutil/utf8_index.h>
+#include "simd_dispatch.h"
+
+namespace Terra::CharUtil
+{
+
+namespace
+{
+
+// Sizes of the blocks of octets counted by the SIMD kernel when skipping
+// code points, from largest to smallest
+constexpr std::array<std::size_t, 2> Skip_Blocks = {256, 32};
+
+// Mask of the high bit of each octet in a 64-bit word
+constexpr std::uint64_t High_Bits = 0x8080'8080'8080'8080;
+
+/*
+ *  SkipCodePoints()
+ *
+ *  Description:
+ *      Find the offset of the code point that follows the given number of
+ *      code points at the start of the UTF-8 string.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The UTF-8 string, which must begin on a character boundary.
+ *
+ *      length [in]
+ *          The length of the string in octets.
+ *
+ *      count [in]
+ *          The number of code points to skip.
+ *
+ *  Returns:
+ *      The offset of the first octet of the code point, or the length of
+ *      the string if it contains no more than count code points.
+ *
+ *  Comments:
+ *      Blocks of octets are skipped by counting the code points they
+ *      contain using the SIMD kernel, first using large blocks and then
+ *      small blocks, and then words of eight octets are skipped, so that
+ *      only the final few octets are examined one at a time.
+ */
+std::size_t SkipCodePoints(const std::uint8_t *octets,
+                           std::size_t length,
+                           std::size_t count)
+{
+    const SIMD::Kernels &kernels = SIMD::GetKernels();
+    std::size_t i = 0;
+
+    // Skip blocks while the target lies beyond the block; a block holds at
+    // least one code point per four octets, so a block is not counted if it
+    // is certain to hold the target
+    for (std::size_t block : Skip_Blocks)
+    {
+        while ((count >= (block / 4)) && ((length - i) >= block))
+        {
+            std::size_t starts =
+                kernels.count_utf8_code_points(octets + i, block);
+            if (starts > count) break;
+            count -= starts;
+            i += block;
+        }
+    }
+
+    // Skip words of eight octets while the target lies beyond the word
+    for (; (length - i) >= 8; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, octets + i, sizeof(word));
+
+        // Every octet other than a continuation octet (10xxxxxx) starts a
+        // code point
+        std::uint64_t continuation = word & ~(word << 1) & High_Bits;
+        std::size_t starts =
+            8 - static_cast<std::size_t>(std::popcount(continuation));
+        if (starts > count) break;
+        count -= starts;
+    }
+
+    // Locate the code point within the final octets
+    for (; i < length; i++)
+    {
+        if ((octets[i] & 0xc0) == 0x80) continue;
+        if (count == 0) return i;
+        count--;
+    }
+
+    return length;
+}
+
+} // namespace
+
+/*
+ *  UTF8Index::UTF8Index()
+ *
+ *  Description:
+ *      Constructor for the UTF8Index object, which records the offset of
+ *      every stride'th code point in the given string.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The UTF-8 string to index.  The string must remain unchanged for
+ *          as long as this object is used.
+ *
+ *      stride [in]
+ *          The number of code points between recorded offsets.  A smaller
+ *          stride makes lookups faster at the expense of memory.  A stride
+ *          of zero is treated as one.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The index requires memory for one offset per stride code points.
+ */
+UTF8Index::UTF8Index(std::span<const std::uint8_t> text,
+                     std::size_t stride) :
+    text{text},
+    stride{std::max<std::size_t>(stride, 1)},
+    code_points{},
+    offsets{}
+{
+    // Every code point requires at least one octet
+    offsets.reserve((text.size() / this->stride) + 1);
+
+    // Record the offset of every stride'th code point
+    offsets.push_back(0);
+    while (true)
+    {
+        std::size_t offset = offsets.back();
+        std::size_t next = offset + SkipCodePoints(text.data() + offset,
+                                                   text.size() - offset,
+                                                   this->stride);
+        if (next == text.size()) break;
+        offsets.push_back(next);
+    }
+
+    // Count the code points following the last recorded offset
+    code_points = ((offsets.size() - 1) * this->stride) +
+                  SIMD::GetKernels().count_utf8_code_points(
+                      text.data() + offsets.back(),
+                      text.size() - offsets.back());
+}
+
+/*
+ *  UTF8Index::CodePoints()
+ *
+ *  Description:
+ *      Return the number of code points in the string.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of code points in the string.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t UTF8Index::CodePoints() const noexcept
+{
+    return code_points;
+}
+
+/*
+ *  UTF8Index::OffsetOf()
+ *
+ *  Description:
+ *      Return the offset of the first octet of the code point at the given
+ *      position in the string.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the code point, counting from zero.
+ *
+ *  Returns:
+ *      The offset of the code point in octets.  If the position is equal to
+ *      the number of code points, the length of the string is returned.  If
+ *      the position is beyond that, an empty optional is returned.
+ *
+ *  Comments:
+ *      The search begins at the nearest recorded offset, so at most one
+ *      stride of the string is examined.
+ */
+std::optional<std::size_t> UTF8Index::OffsetOf(std::size_t position) const
+{
+    if (position > code_points) return {};
+    if (position == code_points) return text.size();
+
+    std::size_t offset = offsets[position / stride];
+
+    return offset + SkipCodePoints(text.data() + offset,
+                                   text.size() - offset,
+                                   position % stride);
+}
+
+/*
+ *  UTF8Index::PositionOf()
+ *
+ *  Description:
+ *      Return the position of the code point that contains the octet at the
+ *      given offset in the string.
+ *
+ *  Parameters:
+ *      offset [in]
+ *          The offset of the octet.
+ *
+ *  Returns:
+ *      The position of the code point, counting from zero.  If the offset is
+ *      within a multi-octet character, the position of that character is
+ *      returned.  If the offset is equal to the length of the string, the
+ *      number of code points is returned.  If the offset is beyond that, an
+ *      empty optional is returned.
+ *
+ *  Comments:
+ *      The nearest recorded offset is found using a binary search, and then
+ *      the code points between it and the given offset are counted, so at
+ *      most one stride of the string is examined.
+ */
+std::optional<std::size_t> UTF8Index::PositionOf(std::size_t offset) const
+{
+    if (offset > text.size()) return {};
+    if (offset == text.size()) return code_points;
+
+    // Find the last recorded offset at or before the given offset
+    std::size_t block = static_cast<std::size_t>(
+        std::upper_bound(offsets.begin(), offsets.end(), offset) -
+        offsets.begin() - 1);
+
+    // Count the code points that start before the given offset
+    std::size_t position = (block * stride) +
+                           SIMD::GetKernels().count_utf8_code_points(
+                               text.data() + offsets[block],
+                               offset - offsets[block]);
+
+    // A continuation octet belongs to the preceding code point
+    if ((text[offset] & 0xc0) == 0x80) position--;
+
+    return position;
+}
+
+/*
+ *  UTF8Index::Substring()
+ *
+ *  Description:
+ *      Return the octets of the given range of code points.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The position of the first code point, counting from zero.
+ *
+ *      count [in]
+ *          The number of code points.  If the string ends before this many
+ *          code points, the range ends at the end of the string.
+ *
+ *  Returns:
+ *      A span referring to the octets of the code points within the
+ *      original string, or an empty optional if the position is beyond the
+ *      number of code points in the string.
+ *
+ *  Comments:
+ *      None.
+ */
+std::optional<std::span<const std::uint8_t>> UTF8Index::Substring(
+                                                std::size_t position,
+                                                std::size_t count) const
+{
+    std::optional<std::size_t> first = OffsetOf(position);
+    if (!first) return {};
+
+    // Skip the requested code points from the first one
+    std::size_t length = SkipCodePoints(text.data() + *first,
+                                        text.size() - *first,
+                                        count);
+
+    return text.subspan(*first, length);
+}
+
+} // namespace Terra::CharUtil
@@ -0,0 +1,204 @@
+/*
+ *  utf8_to_utf16_converter.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements an object that will convert a stream of UTF-8
+ *      octets to UTF-16 (either little endian or big endian) as successive
+ *      chunks of the stream become available.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <terra/charutil/utf8_to_utf16_converter.h>
+#include "simd_dispatch.h"
+#include "utf8_dfa.h"
+
+namespace Terra::CharUtil
+{
+
+/*
+ *  UTF8ToUTF16Converter::UTF8ToUTF16Converter()
+ *
+ *  Description:
+ *      Constructor for the UTF8ToUTF16Converter object.
+ *
+ *  Parameters:
+ *      little_endian [in]
+ *          Store the UTF-16 characters in little endian order?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+UTF8ToUTF16Converter::UTF8ToUTF16Converter(bool little_endian) :
+    little_endian{little_endian},
+    pending{},
+    pending_length{}
+{
+}
+
+/*
+ *  UTF8ToUTF16Converter::Feed()
+ *
+ *  Description:
+ *      Convert the next chunk of the UTF-8 stream to UTF-16, stopping when
+ *      the chunk is exhausted or when the next character will not fit in the
+ *      output span.  A multi-octet character that is incomplete at the end of
+ *      the chunk is retained and completed by the next call.
+ *
+ *  Parameters:
+ *      in [in]
+ *          The next chunk of the UTF-8 stream.
+ *
+ *      out [out]
+ *          The span into which the UTF-16 octets are written.  This may be
+ *          of any size, though a span at least 2x larger than the input span
+ *          plus two octets will always accept the entire chunk.
+ *
+ *  Returns:
+ *      The result of the conversion.  On success, the number of octets
+ *      consumed will be less than the chunk length only if the output span
+ *      was filled, in which case the remainder of the chunk should be given
+ *      in the next call.  On failure, the number of octets consumed indicates
+ *      where the invalid sequence begins (or zero if the invalid sequence
+ *      began in a previous chunk) and the error indicates why it is invalid.
+ *
+ *  Comments:
+ *      Once an error is reported, Reset() must be called before converting
+ *      another stream.
+ */
+ConversionResult UTF8ToUTF16Converter::Feed(std::span<const std::uint8_t> in,
+                                            std::span<std::uint8_t> out)
+{
+    std::size_t consumed{};
+    std::size_t produced{};
+
+    // Complete any character left incomplete by the previous chunk
+    if (pending_length > 0)
+    {
+        std::size_t sequence_length = (pending[0] >= 0xf0) ? 4 :
+                                      (pending[0] >= 0xe0) ? 3 : 2;
+        std::size_t needed = std::min(sequence_length - pending_length,
+                                      in.size());
+        std::array<std::uint8_t, 4> octets = pending;
+
+        // Append the continuation octets found in this chunk
+        for (std::size_t i = 0; i < needed; i++)
+        {
+            if ((in[i] & 0xc0) != 0x80)
+            {
+                return {false, 0, 0, UnicodeError::TruncatedSequence};
+            }
+            octets[pending_length + i] = in[i];
+        }
+
+        // If the character is still incomplete, retain what is available
+        if ((pending_length + needed) < sequence_length)
+        {
+            pending = octets;
+            pending_length += needed;
+            return {true, in.size(), 0, UnicodeError::None};
+        }
+
+        // Convert the completed character
+        ConversionResult result = ConvertUTF8ToUTF16Partial(
+            std::span<const std::uint8_t>(octets.data(), sequence_length),
+            out,
+            little_endian);
+        if (!result.success) return {false, 0, 0, result.error};
+
+        // If the character did not fit, it remains pending
+        if (result.produced == 0) return {true, 0, 0, UnicodeError::None};
+
+        pending_length = 0;
+        consumed = needed;
+        produced = result.produced;
+    }
+
+    // Convert the complete characters in the chunk (octets at the end that
+    // can never form a valid character are converted so that the error is
+    // reported immediately)
+    std::size_t boundary = SIMD::CharacterBoundary(in.data(), in.size());
+    if (!UTF8DFA::IsSequencePrefix(in.data() + boundary, in.size() - boundary))
+    {
+        boundary = in.size();
+    }
+    ConversionResult result = ConvertUTF8ToUTF16Partial(
+        in.subspan(consumed, boundary - consumed),
+        out.subspan(produced),
+        little_endian);
+    consumed += result.consumed;
+    produced += result.produced;
+
+    // Stop on error or if the output span was filled
+    if (!result.success || (consumed < boundary))
+    {
+        return {result.success, consumed, produced, result.error};
+    }
+
+    // Retain the incomplete character at the end of the chunk
+    pending_length = in.size() - boundary;
+    std::copy(in.begin() + boundary, in.end(), pending.begin());
+
+    return {true, in.size(), produced, UnicodeError::None};
+}
+
+/*
+ *  UTF8ToUTF16Converter::Finish()
+ *
+ *  Description:
+ *      Indicate that the end of the UTF-8 stream has been reached.  This
+ *      resets the object so that it may be used to convert another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the stream ended on a character boundary or false if the
+ *      final character was incomplete.
+ *
+ *  Comments:
+ *      None.
+ */
+bool UTF8ToUTF16Converter::Finish()
+{
+    bool complete = pending_length == 0;
+
+    Reset();
+
+    return complete;
+}
+
+/*
+ *  UTF8ToUTF16Converter::Reset()
+ *
+ *  Description:
+ *      Discard any incomplete character so that the object may be used to
+ *      convert another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void UTF8ToUTF16Converter::Reset()
+{
+    pending_length = 0;
+}
+
+} // namespace Terra::CharUtil
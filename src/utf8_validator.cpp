@@ -0,0 +1,159 @@
+/*
+ *  utf8_validator.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This file implements an object that will verify that a stream of
+ *      octets is valid UTF-8 as successive chunks of the stream become
+ *      available.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <terra/charutil/utf8_validator.h>
+#include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
+#include "utf8_dfa.h"
+
+namespace Terra::CharUtil
+{
+
+/*
+ *  UTF8Validator::UTF8Validator()
+ *
+ *  Description:
+ *      Constructor for the UTF8Validator object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+UTF8Validator::UTF8Validator() : valid{true}, pending{}, pending_length{}
+{
+}
+
+/*
+ *  UTF8Validator::Feed()
+ *
+ *  Description:
+ *      Validate the next chunk of the stream.  A multi-octet character that
+ *      is incomplete at the end of the chunk is retained and validated once
+ *      the next chunk completes it.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The next chunk of the stream.
+ *
+ *  Returns:
+ *      False if the stream has been found to be invalid, true otherwise.
+ *
+ *  Comments:
+ *      Once the stream is found to be invalid, subsequent chunks are ignored
+ *      until the object is reset.
+ */
+bool UTF8Validator::Feed(std::span<const std::uint8_t> octets)
+{
+    std::size_t consumed{};
+
+    if (!valid) return false;
+
+    // Complete any character left incomplete by the previous chunk
+    if (pending_length > 0)
+    {
+        std::size_t sequence_length = (pending[0] >= 0xf0) ? 4 :
+                                      (pending[0] >= 0xe0) ? 3 : 2;
+        consumed = std::min(sequence_length - pending_length, octets.size());
+        std::copy(octets.begin(),
+                  octets.begin() + consumed,
+                  pending.begin() + pending_length);
+        pending_length += consumed;
+
+        // If the character is still incomplete, wait for the next chunk
+        if (pending_length < sequence_length) return true;
+
+        valid = IsUTF8Valid(std::span<const std::uint8_t>(pending.data(),
+                                                          sequence_length));
+        pending_length = 0;
+        if (!valid) return false;
+    }
+
+    // Validate the complete characters in the chunk (octets at the end that
+    // can never form a valid character are validated so that the error is
+    // reported immediately)
+    std::size_t boundary = SIMD::CharacterBoundary(octets.data(),
+                                                   octets.size());
+    if (!UTF8DFA::IsSequencePrefix(octets.data() + boundary,
+                                   octets.size() - boundary))
+    {
+        boundary = octets.size();
+    }
+    valid = IsUTF8Valid(octets.subspan(consumed, boundary - consumed));
+    if (!valid) return false;
+
+    // Retain the incomplete character at the end of the chunk
+    pending_length = octets.size() - boundary;
+    std::copy(octets.begin() + boundary, octets.end(), pending.begin());
+
+    return true;
+}
+
+/*
+ *  UTF8Validator::Finish()
+ *
+ *  Description:
+ *      Indicate that the end of the stream has been reached.  This resets the
+ *      object so that it may be used to validate another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the entire stream is valid UTF-8, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool UTF8Validator::Finish()
+{
+    bool result = valid && (pending_length == 0);
+
+    Reset();
+
+    return result;
+}
+
+/*
+ *  UTF8Validator::Reset()
+ *
+ *  Description:
+ *      Reset the object so that it may be used to validate another stream.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void UTF8Validator::Reset()
+{
+    valid = true;
+    pending_length = 0;
+}
+
+} // namespace Terra::CharUtil
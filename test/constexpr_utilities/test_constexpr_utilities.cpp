@@ -0,0 +1,219 @@
+/*
+ *  test_constexpr_utilities.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the functions that may be evaluated at compile
+ *      time, both at compile time and by comparing the results at run time
+ *      with those of the library functions.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <terra/charutil/constexpr_utilities.h>
+#include <terra/charutil/character_utilities.h>
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Validation at compile time
+static_assert(Constexpr::IsUTF8Valid(std::u8string_view(u8"")));
+static_assert(Constexpr::IsUTF8Valid(std::u8string_view(u8"Hello!")));
+static_assert(Constexpr::IsUTF8Valid(std::u8string_view(u8"你好世界 😀")));
+static_assert(!Constexpr::IsUTF8Valid(std::u8string_view(u8"abc\xc0\x80")));
+static_assert(!Constexpr::IsUTF8Valid(std::u8string_view(u8"\xed\xa0\x80")));
+static_assert(!Constexpr::IsUTF8Valid(std::u8string_view(u8"\xf4\x90\x80")));
+static_assert(!Constexpr::IsUTF8Valid(std::u8string_view(u8"\xe4\xbd")));
+
+// Produce a UTF-16 table from a UTF-8 literal at compile time
+constexpr auto Greeting = []
+{
+    std::array<char16_t, 16> table{};
+    auto [result, length] =
+        Constexpr::ConvertUTF8ToUTF16(std::u8string_view(u8"Hi 😀"), table);
+    return std::pair{table, result ? length : 0};
+}();
+static_assert(Greeting.second == 5);
+static_assert(Greeting.first[0] == u'H');
+static_assert(Greeting.first[2] == u' ');
+static_assert(Greeting.first[3] == 0xd83d);
+static_assert(Greeting.first[4] == 0xde00);
+
+// Produce a UTF-8 table from a UTF-16 literal at compile time
+constexpr auto Farewell = []
+{
+    std::array<char8_t, 32> table{};
+    auto [result, length] =
+        Constexpr::ConvertUTF16ToUTF8(std::u16string_view(u"Bye 🌍"), table);
+    return std::pair{table, result ? length : 0};
+}();
+static_assert(Farewell.second == 8);
+static_assert(Farewell.first[4] == 0xf0);
+static_assert(Farewell.first[7] == 0x8d);
+
+// Produce big endian UTF-16 octets at compile time
+constexpr auto Octets = []
+{
+    constexpr std::array<std::uint8_t, 3> in = {'a', 0xc3, 0xa9};
+    std::array<std::uint8_t, 6> out{};
+    auto [result, length] = Constexpr::ConvertUTF8ToUTF16(in, out, false);
+    return std::pair{out, result ? length : 0};
+}();
+static_assert(Octets.second == 4);
+static_assert(Octets.first[0] == 0x00);
+static_assert(Octets.first[1] == 'a');
+static_assert(Octets.first[2] == 0x00);
+static_assert(Octets.first[3] == 0xe9);
+
+// Produce a string long enough to be processed by the SIMD kernels when
+// given to the library functions
+std::u8string MultilingualText()
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return text;
+}
+
+} // namespace
+
+STF_TEST(TestConstexpr, UTF8ToUTF16)
+{
+    const std::u8string text = MultilingualText();
+    const std::vector<std::uint8_t> octets(text.begin(), text.end());
+
+    for (bool little_endian : {true, false})
+    {
+        std::vector<std::uint8_t> expected(octets.size() * 2);
+        auto [expected_result, expected_length] =
+            ConvertUTF8ToUTF16(octets, expected, little_endian);
+        STF_ASSERT_TRUE(expected_result);
+        expected.resize(expected_length);
+
+        std::vector<std::uint8_t> output(octets.size() * 2);
+        auto [result, length] =
+            Constexpr::ConvertUTF8ToUTF16(octets, output, little_endian);
+        STF_ASSERT_TRUE(result);
+        output.resize(length);
+        STF_ASSERT_EQ(expected, output);
+    }
+
+    // The output span must be at least 2x the input span
+    std::vector<std::uint8_t> output(octets.size() * 2 - 1);
+    STF_ASSERT_FALSE(
+        Constexpr::ConvertUTF8ToUTF16(octets, output, true).first);
+
+    // Convert directly to code units
+    std::u16string units(text.size(), u'\0');
+    auto [result, length] = Constexpr::ConvertUTF8ToUTF16(text, units);
+    STF_ASSERT_TRUE(result);
+    units.resize(length);
+    std::u16string expected(text.size(), u'\0');
+    auto [expected_result, expected_length] =
+        ConvertUTF8ToUTF16(text, expected);
+    STF_ASSERT_TRUE(expected_result);
+    expected.resize(expected_length);
+    STF_ASSERT_TRUE(expected == units);
+}
+
+STF_TEST(TestConstexpr, UTF16ToUTF8)
+{
+    const std::u8string text = MultilingualText();
+    std::u16string units(text.size(), u'\0');
+    auto [converted, units_length] = ConvertUTF8ToUTF16(text, units);
+    STF_ASSERT_TRUE(converted);
+    units.resize(units_length);
+
+    for (bool little_endian : {true, false})
+    {
+        std::vector<std::uint8_t> octets;
+        for (char16_t c : units)
+        {
+            std::uint8_t high = static_cast<std::uint8_t>(c >> 8);
+            std::uint8_t low = static_cast<std::uint8_t>(c & 0xff);
+            octets.push_back(little_endian ? low : high);
+            octets.push_back(little_endian ? high : low);
+        }
+
+        std::vector<std::uint8_t> output(octets.size() * 3 / 2);
+        auto [result, length] =
+            Constexpr::ConvertUTF16ToUTF8(octets, output, little_endian);
+        STF_ASSERT_TRUE(result);
+        output.resize(length);
+        STF_ASSERT_EQ(std::vector<std::uint8_t>(text.begin(), text.end()),
+                      output);
+
+        // An odd number of octets is rejected
+        octets.pop_back();
+        STF_ASSERT_FALSE(
+            Constexpr::ConvertUTF16ToUTF8(octets, output, little_endian)
+                .first);
+    }
+
+    // Convert directly from code units
+    std::u8string output(units.size() * 3, u8'\0');
+    auto [result, length] = Constexpr::ConvertUTF16ToUTF8(units, output);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_TRUE(text == output);
+}
+
+STF_TEST(TestConstexpr, Invalid)
+{
+    const std::vector<std::vector<std::uint8_t>> invalid_utf8 =
+    {
+        {'a', 0x80},                            // Lone continuation octet
+        {0xc0, 0xaf},                           // Overlong encoding
+        {0xe0, 0x80, 0xaf},                     // Overlong encoding
+        {0xed, 0xa0, 0x80},                     // Surrogate
+        {0xf4, 0x90, 0x80, 0x80},               // Beyond 0x10ffff
+        {0xf5, 0x80, 0x80, 0x80},               // Invalid lead octet
+        {0xe4, 0xbd},                           // Truncated sequence
+        {0xc3, 'a'}                             // Missing continuation octet
+    };
+
+    for (const auto &octets : invalid_utf8)
+    {
+        std::vector<std::uint8_t> output(octets.size() * 2);
+        STF_ASSERT_EQ(IsUTF8Valid(octets), Constexpr::IsUTF8Valid(octets));
+        STF_ASSERT_FALSE(Constexpr::IsUTF8Valid(octets));
+        STF_ASSERT_FALSE(
+            Constexpr::ConvertUTF8ToUTF16(octets, output, true).first);
+    }
+
+    const std::vector<std::u16string> invalid_utf16 =
+    {
+        {u'a', static_cast<char16_t>(0xdc00)},  // Unpaired low surrogate
+        {static_cast<char16_t>(0xd83d), u'a'},  // Unpaired high surrogate
+        {u'a', static_cast<char16_t>(0xd83d)}   // Truncated surrogate pair
+    };
+
+    for (const auto &units : invalid_utf16)
+    {
+        std::u8string output(units.size() * 3, u8'\0');
+        STF_ASSERT_FALSE(Constexpr::ConvertUTF16ToUTF8(units, output).first);
+    }
+}
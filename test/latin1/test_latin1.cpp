@@ -0,0 +1,274 @@
+/*
+ *  test_latin1.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test logic related converting strings between
+ *      Latin-1 (ISO-8859-1) and both UTF-8 and UTF-16.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <tuple>
+#include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a Latin-1 string of the given length that contains every octet
+// value, starting with the given value
+std::vector<std::uint8_t> Latin1Text(std::size_t length, std::size_t start)
+{
+    std::vector<std::uint8_t> text;
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        text.push_back(static_cast<std::uint8_t>((start + i) & 0xff));
+    }
+
+    return text;
+}
+
+// Encode the Latin-1 string as UTF-8 one character at a time
+std::vector<std::uint8_t> ExpectedUTF8(const std::vector<std::uint8_t> &text)
+{
+    std::vector<std::uint8_t> octets;
+
+    for (std::uint8_t c : text)
+    {
+        if (c < 0x80)
+        {
+            octets.push_back(c);
+        }
+        else
+        {
+            octets.push_back(static_cast<std::uint8_t>(0xc0 | (c >> 6)));
+            octets.push_back(static_cast<std::uint8_t>(0x80 | (c & 0x3f)));
+        }
+    }
+
+    return octets;
+}
+
+// Encode the Latin-1 string as UTF-16 one character at a time
+std::vector<std::uint8_t> ExpectedUTF16(const std::vector<std::uint8_t> &text,
+                                        bool little_endian)
+{
+    std::vector<std::uint8_t> octets;
+
+    for (std::uint8_t c : text)
+    {
+        octets.push_back(little_endian ? c : 0);
+        octets.push_back(little_endian ? 0 : c);
+    }
+
+    return octets;
+}
+
+// Call the given function using every supported SIMD tier
+template<typename F>
+void ForAllTiers(F function)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+        function();
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+} // namespace
+
+STF_TEST(TestLatin1, Empty)
+{
+    std::vector<std::uint8_t> input;
+    std::vector<std::uint8_t> output;
+
+    auto [result, length] = ConvertLatin1ToUTF8(input, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(0u, length);
+
+    std::tie(result, length) = ConvertUTF8ToLatin1(input, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(0u, length);
+
+    std::tie(result, length) = ConvertLatin1ToUTF16(input, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(0u, length);
+
+    std::tie(result, length) = ConvertUTF16ToLatin1(input, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(0u, length);
+}
+
+STF_TEST(TestLatin1, Example)
+{
+    // "Café Ñ" in each encoding
+    const std::vector<std::uint8_t> latin1 =
+    {
+        0x43, 0x61, 0x66, 0xe9, 0x20, 0xd1
+    };
+    const std::vector<std::uint8_t> utf8 =
+    {
+        0x43, 0x61, 0x66, 0xc3, 0xa9, 0x20, 0xc3, 0x91
+    };
+    const std::vector<std::uint8_t> utf16_be =
+    {
+        0x00, 0x43, 0x00, 0x61, 0x00, 0x66, 0x00, 0xe9, 0x00, 0x20, 0x00, 0xd1
+    };
+
+    std::vector<std::uint8_t> output(32);
+    auto [result, length] = ConvertLatin1ToUTF8(latin1, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf8, std::vector<std::uint8_t>(output.begin(),
+                                                  output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF8ToLatin1(utf8, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(latin1, std::vector<std::uint8_t>(output.begin(),
+                                                    output.begin() + length));
+
+    std::tie(result, length) = ConvertLatin1ToUTF16(latin1, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf16_be,
+                  std::vector<std::uint8_t>(output.begin(),
+                                            output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF16ToLatin1(utf16_be, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(latin1, std::vector<std::uint8_t>(output.begin(),
+                                                    output.begin() + length));
+}
+
+STF_TEST(TestLatin1, AllLengths)
+{
+    // Convert strings of every length up to several SIMD blocks, starting
+    // at various octet values so that both ASCII runs and characters above
+    // 0x7f are found at every position
+    for (std::size_t i = 0; i < 300; i++)
+    {
+        for (std::size_t start : {0, 0x60, 0x80, 0xf0})
+        {
+            const std::vector<std::uint8_t> latin1 = Latin1Text(i, start);
+            const std::vector<std::uint8_t> utf8 = ExpectedUTF8(latin1);
+
+            ForAllTiers([&]()
+            {
+                std::vector<std::uint8_t> output(latin1.size() * 2);
+
+                auto [result, length] = ConvertLatin1ToUTF8(latin1, output);
+                STF_ASSERT_TRUE(result);
+                output.resize(length);
+                STF_ASSERT_EQ(utf8, output);
+
+                std::tie(result, length) = ConvertUTF8ToLatin1(utf8, output);
+                STF_ASSERT_TRUE(result);
+                output.resize(length);
+                STF_ASSERT_EQ(latin1, output);
+
+                for (bool little_endian : {true, false})
+                {
+                    const std::vector<std::uint8_t> utf16 =
+                        ExpectedUTF16(latin1, little_endian);
+
+                    output.resize(latin1.size() * 2);
+                    std::tie(result, length) =
+                        ConvertLatin1ToUTF16(latin1, output, little_endian);
+                    STF_ASSERT_TRUE(result);
+                    STF_ASSERT_EQ(utf16, output);
+
+                    std::tie(result, length) =
+                        ConvertUTF16ToLatin1(utf16, output, little_endian);
+                    STF_ASSERT_TRUE(result);
+                    output.resize(length);
+                    STF_ASSERT_EQ(latin1, output);
+                }
+            });
+        }
+    }
+}
+
+STF_TEST(TestLatin1, Unrepresentable)
+{
+    const std::vector<std::uint8_t> latin1 = Latin1Text(200, 0x20);
+
+    // Place a character above 0xff at every position within a long string
+    // to ensure the SIMD kernels never convert past it
+    for (std::size_t i = 0; i < latin1.size(); i++)
+    {
+        std::vector<std::uint8_t> utf8 = ExpectedUTF8(
+            std::vector<std::uint8_t>(latin1.begin(), latin1.begin() + i));
+        utf8.insert(utf8.end(), {0xc4, 0x80});
+        std::vector<std::uint8_t> utf16_le = ExpectedUTF16(latin1, true);
+        utf16_le[(i * 2) + 1] = 0x01;
+        std::vector<std::uint8_t> utf16_be = ExpectedUTF16(latin1, false);
+        utf16_be[i * 2] = 0xd8;
+
+        ForAllTiers([&]()
+        {
+            std::vector<std::uint8_t> output(utf16_le.size());
+
+            STF_ASSERT_FALSE(ConvertUTF8ToLatin1(utf8, output).first);
+            STF_ASSERT_FALSE(
+                ConvertUTF16ToLatin1(utf16_le, output, true).first);
+            STF_ASSERT_FALSE(
+                ConvertUTF16ToLatin1(utf16_be, output, false).first);
+        });
+    }
+}
+
+STF_TEST(TestLatin1, Invalid)
+{
+    std::vector<std::uint8_t> output(16);
+
+    // Ill-formed UTF-8 is rejected
+    for (const std::vector<std::uint8_t> &utf8 :
+            {std::vector<std::uint8_t>{0x61, 0xc3},
+             std::vector<std::uint8_t>{0xc3, 0x61},
+             std::vector<std::uint8_t>{0xc0, 0x80},
+             std::vector<std::uint8_t>{0xc1, 0xbf},
+             std::vector<std::uint8_t>{0x80},
+             std::vector<std::uint8_t>{0xe0, 0x83, 0xbf}})
+    {
+        STF_ASSERT_FALSE(ConvertUTF8ToLatin1(utf8, output).first);
+    }
+
+    // UTF-16 must have an even number of octets
+    STF_ASSERT_FALSE(
+        ConvertUTF16ToLatin1(std::vector<std::uint8_t>{0x61, 0x00, 0x62},
+                             output,
+                             true).first);
+
+    // The output span must be sufficiently large
+    std::vector<std::uint8_t> small_output(1);
+    STF_ASSERT_FALSE(
+        ConvertLatin1ToUTF8(std::vector<std::uint8_t>{0x61}, small_output)
+            .first);
+    STF_ASSERT_FALSE(
+        ConvertUTF8ToLatin1(std::vector<std::uint8_t>{0x61, 0x62},
+                            small_output).first);
+    STF_ASSERT_FALSE(
+        ConvertLatin1ToUTF16(std::vector<std::uint8_t>{0x61},
+                             small_output,
+                             true).first);
+}
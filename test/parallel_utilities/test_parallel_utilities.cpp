@@ -0,0 +1,287 @@
+/*
+ *  test_parallel_utilities.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the functions that convert or validate very
+ *      large strings using multiple threads by comparing their results with
+ *      those of the single-threaded functions.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <terra/charutil/parallel_utilities.h>
+#include <terra/charutil/character_utilities.h>
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a UTF-8 string long enough to be split into several chunks
+std::vector<std::uint8_t> LargeUTF8Text()
+{
+    std::u8string text;
+
+    while (text.size() < (Min_Parallel_Chunk * 8))
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Convert the text to UTF-16 on the calling thread
+std::vector<std::uint8_t> ToUTF16(const std::vector<std::uint8_t> &text,
+                                  bool little_endian)
+{
+    std::vector<std::uint8_t> output(text.size() * 2);
+    auto [result, length] = ConvertUTF8ToUTF16(text, output, little_endian);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+
+    return output;
+}
+
+} // namespace
+
+STF_TEST(TestParallel, UTF8ToUTF16)
+{
+    const std::vector<std::uint8_t> text = LargeUTF8Text();
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> expected = ToUTF16(text,
+                                                           little_endian);
+
+        for (std::size_t threads : {0, 1, 2, 3, 4, 7, 8, 16})
+        {
+            std::vector<std::uint8_t> output(text.size() * 2);
+            auto [result, length] = ConvertUTF8ToUTF16Parallel(text,
+                                                               output,
+                                                               little_endian,
+                                                               threads);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+}
+
+STF_TEST(TestParallel, UTF8ToUTF16Boundaries)
+{
+    // Place a four-octet character at every offset relative to the split
+    // between two chunks
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        std::vector<std::uint8_t> text(Min_Parallel_Chunk * 2, 'a');
+        std::size_t offset = Min_Parallel_Chunk - i;
+        text[offset] = 0xf0;
+        text[offset + 1] = 0x9f;
+        text[offset + 2] = 0x98;
+        text[offset + 3] = 0x80;
+
+        const std::vector<std::uint8_t> expected = ToUTF16(text, true);
+        std::vector<std::uint8_t> output(text.size() * 2);
+        auto [result, length] = ConvertUTF8ToUTF16Parallel(text,
+                                                           output,
+                                                           true,
+                                                           2);
+        STF_ASSERT_TRUE(result);
+        output.resize(length);
+        STF_ASSERT_EQ(expected, output);
+    }
+}
+
+STF_TEST(TestParallel, UTF8ToUTF16Invalid)
+{
+    const std::vector<std::uint8_t> text = LargeUTF8Text();
+    std::vector<std::uint8_t> output(text.size() * 2);
+
+    // An invalid octet in any chunk causes the conversion to fail
+    for (std::size_t position : {std::size_t{0},
+                                 text.size() / 2,
+                                 text.size() / 4 * 3 + 1,
+                                 text.size() - 1})
+    {
+        std::vector<std::uint8_t> invalid = text;
+        invalid[position] = 0xff;
+        STF_ASSERT_FALSE(
+            ConvertUTF8ToUTF16Parallel(invalid, output, true, 4).first);
+    }
+
+    // A run of continuation octets across a split causes a failure
+    std::vector<std::uint8_t> invalid(Min_Parallel_Chunk * 2, 0x80);
+    STF_ASSERT_FALSE(
+        ConvertUTF8ToUTF16Parallel(invalid, output, true, 2).first);
+
+    // A truncated character at the end causes a failure
+    invalid = text;
+    invalid.push_back(0xe4);
+    output.resize(invalid.size() * 2);
+    STF_ASSERT_FALSE(
+        ConvertUTF8ToUTF16Parallel(invalid, output, true, 4).first);
+
+    // The output span must be at least 2x the input span
+    output.resize(text.size() * 2 - 1);
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16Parallel(text, output, true, 4).first);
+}
+
+STF_TEST(TestParallel, UTF16ToUTF8)
+{
+    const std::vector<std::uint8_t> expected = LargeUTF8Text();
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> text = ToUTF16(expected,
+                                                       little_endian);
+
+        for (std::size_t threads : {0, 1, 2, 3, 4, 7, 8, 16})
+        {
+            std::vector<std::uint8_t> output(text.size() * 3 / 2);
+            auto [result, length] = ConvertUTF16ToUTF8Parallel(text,
+                                                               output,
+                                                               little_endian,
+                                                               threads);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+}
+
+STF_TEST(TestParallel, UTF16ToUTF8Boundaries)
+{
+    // Place a surrogate pair on either side of the split between two chunks
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        std::vector<std::uint8_t> utf8(Min_Parallel_Chunk, 'a');
+        std::vector<std::uint8_t> text = ToUTF16(utf8, true);
+        std::size_t offset = Min_Parallel_Chunk - (i * 2);
+        text[offset] = 0x3d;
+        text[offset + 1] = 0xd8;
+        text[offset + 2] = 0x00;
+        text[offset + 3] = 0xde;
+
+        std::vector<std::uint8_t> expected(text.size() * 3 / 2);
+        auto [expected_result, expected_length] =
+            ConvertUTF16ToUTF8(text, expected, true);
+        STF_ASSERT_TRUE(expected_result);
+        expected.resize(expected_length);
+
+        std::vector<std::uint8_t> output(text.size() * 3 / 2);
+        auto [result, length] = ConvertUTF16ToUTF8Parallel(text,
+                                                           output,
+                                                           true,
+                                                           2);
+        STF_ASSERT_TRUE(result);
+        output.resize(length);
+        STF_ASSERT_EQ(expected, output);
+    }
+}
+
+STF_TEST(TestParallel, UTF16ToUTF8Invalid)
+{
+    const std::vector<std::uint8_t> text = ToUTF16(LargeUTF8Text(), false);
+    std::vector<std::uint8_t> output(text.size() * 3 / 2);
+
+    // An unpaired high surrogate in any chunk causes the conversion to fail
+    for (std::size_t position : {std::size_t{0},
+                                 text.size() / 4 * 2,
+                                 text.size() / 8 * 6 + 2,
+                                 text.size() - 4})
+    {
+        std::vector<std::uint8_t> invalid = text;
+        invalid[position] = 0xd8;
+        invalid[position + 1] = 0x3d;
+        invalid[position + 2] = 0x00;
+        invalid[position + 3] = 0x61;
+        STF_ASSERT_FALSE(
+            ConvertUTF16ToUTF8Parallel(invalid, output, false, 4).first);
+    }
+
+    // An odd number of octets causes a failure
+    std::vector<std::uint8_t> invalid = text;
+    invalid.push_back(0x00);
+    output.resize(invalid.size() * 3 / 2);
+    STF_ASSERT_FALSE(
+        ConvertUTF16ToUTF8Parallel(invalid, output, false, 4).first);
+}
+
+STF_TEST(TestParallel, IsUTF8Valid)
+{
+    const std::vector<std::uint8_t> text = LargeUTF8Text();
+
+    for (std::size_t threads : {0, 1, 2, 3, 4, 7, 8, 16})
+    {
+        STF_ASSERT_TRUE(IsUTF8ValidParallel(text, threads));
+    }
+
+    // Place a four-octet character at every offset relative to the split
+    // between two chunks and to the end of the first validation block
+    std::vector<std::uint8_t> ascii(Min_Parallel_Chunk * 4, 'a');
+    for (std::size_t split : {Min_Parallel_Chunk, Min_Parallel_Chunk * 2})
+    {
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            std::vector<std::uint8_t> valid = ascii;
+            std::size_t offset = split - i;
+            valid[offset] = 0xf0;
+            valid[offset + 1] = 0x9f;
+            valid[offset + 2] = 0x98;
+            valid[offset + 3] = 0x80;
+            STF_ASSERT_TRUE(IsUTF8ValidParallel(valid, 2));
+        }
+    }
+}
+
+STF_TEST(TestParallel, IsUTF8ValidInvalid)
+{
+    const std::vector<std::uint8_t> text = LargeUTF8Text();
+
+    // An invalid octet anywhere is found by the thread validating it
+    for (std::size_t position : {std::size_t{0},
+                                 text.size() / 3,
+                                 text.size() / 2,
+                                 text.size() / 4 * 3 + 1,
+                                 text.size() - 1})
+    {
+        std::vector<std::uint8_t> invalid = text;
+        invalid[position] = 0xc0;
+
+        for (std::size_t threads : {1, 2, 4, 8})
+        {
+            STF_ASSERT_FALSE(IsUTF8ValidParallel(invalid, threads));
+        }
+    }
+
+    // A character truncated where the input is split is found
+    std::vector<std::uint8_t> invalid(Min_Parallel_Chunk * 2, 'a');
+    invalid[Min_Parallel_Chunk - 1] = 0xe4;
+    invalid[Min_Parallel_Chunk] = 0xbd;
+    STF_ASSERT_FALSE(IsUTF8ValidParallel(invalid, 2));
+
+    // A run of continuation octets across a split is found
+    invalid = std::vector<std::uint8_t>(Min_Parallel_Chunk * 2, 0x80);
+    STF_ASSERT_FALSE(IsUTF8ValidParallel(invalid, 2));
+
+    // A truncated character at the end is found
+    invalid = text;
+    invalid.push_back(0xf0);
+    STF_ASSERT_FALSE(IsUTF8ValidParallel(invalid, 4));
+}
@@ -18,8 +18,14 @@
 
 #include <cstdint>
 #include <vector>
+#include <string>
+#include <utility>
+#include <tuple>
+#include <optional>
+#include <memory_resource>
 #include <algorithm>
 #include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
 #include <terra/stf/adapters/integral_vector.h>
 #include <terra/stf/stf.h>
 
@@ -430,3 +436,661 @@ STF_TEST(TestUTF16toUTF8, Emoji_2)
               std::back_inserter(expected_vec));
     STF_ASSERT_EQ(expected_vec, output);
 }
+
+namespace
+{
+
+// Produce a UTF-16 string long enough to be processed by the SIMD kernels
+std::vector<std::uint16_t> MultilingualText()
+{
+    std::vector<std::uint16_t> text;
+
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        // "Hello, "
+        for (std::uint16_t c : {0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c, 0x20})
+        {
+            text.push_back(c);
+        }
+
+        // "你好世界！"
+        for (std::uint16_t c : {0x4f60, 0x597d, 0x4e16, 0x754c, 0xff01})
+        {
+            text.push_back(c);
+        }
+
+        // "Привет"
+        for (std::uint16_t c : {0x041f, 0x0440, 0x0438, 0x0432, 0x0435, 0x0442})
+        {
+            text.push_back(c);
+        }
+
+        // "😀 🌍"
+        for (std::uint16_t c : {0xd83d, 0xde00, 0x0020, 0xd83c, 0xdf0d})
+        {
+            text.push_back(c);
+        }
+    }
+
+    return text;
+}
+
+// Serialize the UTF-16 code units in the given byte order
+std::vector<std::uint8_t> Serialize(const std::vector<std::uint16_t> &text,
+                                    bool little_endian)
+{
+    std::vector<std::uint8_t> octets;
+
+    for (std::uint16_t c : text)
+    {
+        if (little_endian)
+        {
+            octets.push_back(static_cast<std::uint8_t>(c & 0xff));
+            octets.push_back(static_cast<std::uint8_t>(c >> 8));
+        }
+        else
+        {
+            octets.push_back(static_cast<std::uint8_t>(c >> 8));
+            octets.push_back(static_cast<std::uint8_t>(c & 0xff));
+        }
+    }
+
+    return octets;
+}
+
+// Convert the text using every supported SIMD tier and ensure each produces
+// the same result as the scalar implementation
+void CheckAllTiers(const std::vector<std::uint16_t> &text,
+                   bool expected_result)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> octets = Serialize(text,
+                                                           little_endian);
+
+        SIMD::SetTier(SIMD::Tier::Scalar);
+        std::vector<std::uint8_t> expected(octets.size() * 3 / 2);
+        auto [expected_result_scalar, expected_length] =
+            ConvertUTF16ToUTF8(octets, expected, little_endian);
+        STF_ASSERT_EQ(expected_result, expected_result_scalar);
+        expected.resize(expected_length);
+
+        for (auto tier : {SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            std::vector<std::uint8_t> output(octets.size() * 3 / 2);
+            auto [result, length] =
+                ConvertUTF16ToUTF8(octets, output, little_endian);
+            STF_ASSERT_EQ(expected_result, result);
+            if (!result) continue;
+            output.resize(length);
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+} // namespace
+
+STF_TEST(TestUTF16toUTF8, LongText)
+{
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    // Check every alignment of the text relative to the SIMD block size
+    for (std::size_t i = 0; i < 32; i++)
+    {
+        std::vector<std::uint16_t> shifted(i, 0x78);
+        shifted.insert(shifted.end(), text.begin(), text.end());
+        CheckAllTiers(shifted, true);
+    }
+}
+
+STF_TEST(TestUTF16toUTF8, LongASCII)
+{
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        CheckAllTiers(std::vector<std::uint16_t>(i, 0x61), true);
+    }
+}
+
+STF_TEST(TestUTF16toUTF8, LongUnpairedSurrogate)
+{
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    // Place a lone high surrogate and a lone low surrogate at every position
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        for (std::uint16_t surrogate : {0xd800, 0xdc00})
+        {
+            std::vector<std::uint16_t> invalid = text;
+            invalid[i] = surrogate;
+
+            // Replacing half of a surrogate pair with the same kind of
+            // surrogate leaves the text valid
+            bool valid = (text[i] & 0xfc00) == surrogate;
+            CheckAllTiers(invalid, valid);
+        }
+    }
+}
+
+STF_TEST(TestUTF16toUTF8, LongTruncated)
+{
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    // Truncate the text at every position, which is valid only when the
+    // truncation does not split a surrogate pair
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        bool valid = (text[i] & 0xfc00) != 0xdc00;
+        CheckAllTiers(std::vector<std::uint16_t>(text.begin(),
+                                                 text.begin() + i),
+                      valid);
+    }
+}
+
+STF_TEST(TestUTF16toUTF8, ASCIIRuns)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+
+    // Non-ASCII characters and their UTF-8 encoding, chosen such that either
+    // octet of the UTF-16 character may be the one that is not ASCII
+    const std::vector<std::pair<std::uint16_t, std::vector<std::uint8_t>>>
+        characters =
+    {
+        {0x0080, {0xc2, 0x80}},
+        {0x0100, {0xc4, 0x80}},
+        {0x4100, {0xe4, 0x84, 0x80}}
+    };
+
+    // Place a non-ASCII character at every position within runs of ASCII
+    // characters to exercise the ASCII narrowing in each tier
+    for (const auto &[character, encoding] : characters)
+    {
+        for (std::size_t i = 0; i < 80; i++)
+        {
+            for (std::size_t j = 0; j <= i; j++)
+            {
+                std::vector<std::uint16_t> text(i, 0x61);
+                text.insert(text.begin() + j, character);
+
+                std::vector<std::uint8_t> expected(i, 0x61);
+                expected.insert(expected.begin() + j,
+                                encoding.begin(),
+                                encoding.end());
+
+                for (bool little_endian : {true, false})
+                {
+                    const std::vector<std::uint8_t> octets =
+                        Serialize(text, little_endian);
+
+                    for (auto tier : {SIMD::Tier::Scalar,
+                                      SIMD::Tier::SSE42,
+                                      SIMD::Tier::AVX2,
+                                      SIMD::Tier::AVX512})
+                    {
+                        if (!SIMD::SetTier(tier)) continue;
+
+                        std::vector<std::uint8_t> output(octets.size() * 3 /
+                                                         2);
+                        auto [result, length] =
+                            ConvertUTF16ToUTF8(octets, output, little_endian);
+                        STF_ASSERT_TRUE(result);
+                        output.resize(length);
+                        STF_ASSERT_EQ(expected, output);
+                    }
+                }
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF16toUTF8, UTF8Length)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    STF_ASSERT_EQ(0u, UTF8LengthFromUTF16({}, true));
+
+    // Measure every prefix of the text that does not split a surrogate pair
+    for (std::size_t i = 0; i <= text.size(); i++)
+    {
+        if ((i < text.size()) && ((text[i] & 0xfc00) == 0xdc00)) continue;
+
+        for (bool little_endian : {true, false})
+        {
+            const std::vector<std::uint8_t> octets = Serialize(
+                std::vector<std::uint16_t>(text.begin(), text.begin() + i),
+                little_endian);
+
+            std::vector<std::uint8_t> output(octets.size() * 3 / 2);
+            auto [result, length] =
+                ConvertUTF16ToUTF8(octets, output, little_endian);
+            STF_ASSERT_TRUE(result);
+
+            for (auto tier : {SIMD::Tier::Scalar,
+                              SIMD::Tier::SSE42,
+                              SIMD::Tier::AVX2,
+                              SIMD::Tier::AVX512})
+            {
+                if (!SIMD::SetTier(tier)) continue;
+
+                STF_ASSERT_EQ(length,
+                              UTF8LengthFromUTF16(octets, little_endian));
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF16toUTF8, CodePointCount)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    STF_ASSERT_EQ(0u, CountUTF16CodePoints({}, true));
+
+    // Count every prefix of the text that does not split a surrogate pair
+    for (std::size_t i = 0; i <= text.size(); i++)
+    {
+        if ((i < text.size()) && ((text[i] & 0xfc00) == 0xdc00)) continue;
+
+        for (bool little_endian : {true, false})
+        {
+            const std::vector<std::uint8_t> octets = Serialize(
+                std::vector<std::uint16_t>(text.begin(), text.begin() + i),
+                little_endian);
+
+            std::vector<std::uint8_t> output(octets.size() * 2);
+            auto [result, length] =
+                ConvertUTF16ToUTF32(octets, output, little_endian);
+            STF_ASSERT_TRUE(result);
+
+            for (auto tier : {SIMD::Tier::Scalar,
+                              SIMD::Tier::SSE42,
+                              SIMD::Tier::AVX2,
+                              SIMD::Tier::AVX512})
+            {
+                if (!SIMD::SetTier(tier)) continue;
+
+                STF_ASSERT_EQ(length / 4,
+                              CountUTF16CodePoints(octets, little_endian));
+            }
+        }
+    }
+
+    // Count an input long enough to overflow any narrow vector counters
+    std::vector<std::uint16_t> pairs;
+    while (pairs.size() < 1'100'000)
+    {
+        pairs.insert(pairs.end(), {0xd83d, 0xde00});
+    }
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> octets = Serialize(pairs,
+                                                           little_endian);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            STF_ASSERT_EQ(pairs.size() / 2,
+                          CountUTF16CodePoints(octets, little_endian));
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF16toUTF8, PartialBuffers)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> octets = Serialize(text,
+                                                           little_endian);
+        std::vector<std::uint8_t> expected(octets.size() * 3 / 2);
+        auto [result, length] =
+            ConvertUTF16ToUTF8(octets, expected, little_endian);
+        STF_ASSERT_TRUE(result);
+        expected.resize(length);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            // Convert the text into fixed-size buffers of various sizes
+            for (std::size_t buffer_size = 4; buffer_size < 200; buffer_size++)
+            {
+                std::vector<std::uint8_t> output;
+                std::vector<std::uint8_t> buffer(buffer_size);
+                std::span<const std::uint8_t> remaining(octets);
+
+                while (!remaining.empty())
+                {
+                    ConversionResult partial = ConvertUTF16ToUTF8Partial(
+                        remaining,
+                        buffer,
+                        little_endian);
+                    STF_ASSERT_TRUE(partial.success);
+                    STF_ASSERT_GT(partial.produced, 0u);
+                    STF_ASSERT_LE(partial.produced, buffer_size);
+                    output.insert(output.end(),
+                                  buffer.begin(),
+                                  buffer.begin() + partial.produced);
+                    remaining = remaining.subspan(partial.consumed);
+                }
+
+                STF_ASSERT_EQ(expected, output);
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF16toUTF8, PartialErrors)
+{
+    std::vector<std::uint8_t> output(64);
+
+    // An unpaired low surrogate is reported at its position
+    const std::vector<std::uint8_t> unpaired = {0x61, 0x00, 0xe9, 0x00,
+                                                0x00, 0xdc};
+    ConversionResult result =
+        ConvertUTF16ToUTF8Partial(unpaired, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(4u, result.consumed);
+    STF_ASSERT_EQ(3u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::UnpairedSurrogate);
+
+    // A high surrogate not followed by a low surrogate is reported at its
+    // position, as is a high surrogate at the end of the input
+    const std::vector<std::uint8_t> high = {0x61, 0x00, 0x3d, 0xd8,
+                                            0x61, 0x00};
+    result = ConvertUTF16ToUTF8Partial(high, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::UnpairedSurrogate);
+    result = ConvertUTF16ToUTF8Partial(
+        std::span<const std::uint8_t>(high.data(), 4),
+        output,
+        true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::UnpairedSurrogate);
+
+    // An odd final octet is reported at its position
+    const std::vector<std::uint8_t> odd = {0x61, 0x00, 0x62};
+    result = ConvertUTF16ToUTF8Partial(odd, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_EQ(1u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::TruncatedSequence);
+
+    // A three octet character is not split when the output is too small
+    const std::vector<std::uint8_t> cjk = {0x61, 0x00, 0x60, 0x4f};
+    result = ConvertUTF16ToUTF8Partial(
+        cjk,
+        std::span<std::uint8_t>(output.data(), 3),
+        true);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_EQ(1u, result.produced);
+}
+
+STF_TEST(TestUTF16toUTF8, Lossy)
+{
+    // "a", lone low surrogate, "b", high surrogate followed by "cd", high
+    // surrogate followed by an odd final octet (a truncated pair)
+    const std::vector<std::uint8_t> input = {
+        0x61, 0x00, 0x00, 0xdc, 0x62, 0x00, 0x3d, 0xd8,
+        0x63, 0x00, 0x64, 0x00, 0x3d, 0xd8, 0x41
+    };
+    const std::vector<std::uint8_t> expected = {
+        0x61, 0xef, 0xbf, 0xbd, 0x62, 0xef, 0xbf, 0xbd,
+        0x63, 0x64, 0xef, 0xbf, 0xbd
+    };
+    std::vector<std::uint8_t> output(24);
+
+    auto [result, length] = ConvertUTF16ToUTF8Lossy(input, output, true);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_EQ(expected, output);
+
+    // A lone odd octet is replaced
+    output.resize(3);
+    std::tie(result, length) = ConvertUTF16ToUTF8Lossy(
+        std::span<const std::uint8_t>(input.data(), 1),
+        output,
+        true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(std::vector<std::uint8_t>({0xef, 0xbf, 0xbd}), output);
+
+    // The output span must have room to replace the odd final octet
+    output.resize(23);
+    std::tie(result, length) = ConvertUTF16ToUTF8Lossy(input, output, true);
+    STF_ASSERT_FALSE(result);
+}
+
+STF_TEST(TestUTF16toUTF8, LongLossy)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::vector<std::uint16_t> text = MultilingualText();
+
+    // Replace each character outside of a surrogate pair with a lone low
+    // surrogate, which results in a single replacement character
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        if ((text[i] & 0xf800) == 0xd800) continue;
+
+        std::vector<std::uint16_t> invalid = text;
+        invalid[i] = 0xdc00;
+
+        for (bool little_endian : {true, false})
+        {
+            const std::vector<std::uint8_t> octets = Serialize(invalid,
+                                                               little_endian);
+
+            // Build the expected output from the valid text either side
+            SIMD::SetTier(SIMD::Tier::Scalar);
+            std::vector<std::uint8_t> expected(octets.size() * 3 / 2);
+            auto [result, length] = ConvertUTF16ToUTF8(
+                std::span<const std::uint8_t>(octets.data(), i * 2),
+                expected,
+                little_endian);
+            STF_ASSERT_TRUE(result);
+            expected.resize(length);
+            expected.insert(expected.end(), {0xef, 0xbf, 0xbd});
+            std::vector<std::uint8_t> suffix(octets.size() * 3 / 2);
+            std::tie(result, length) = ConvertUTF16ToUTF8(
+                std::span<const std::uint8_t>(octets).subspan(i * 2 + 2),
+                suffix,
+                little_endian);
+            STF_ASSERT_TRUE(result);
+            expected.insert(expected.end(),
+                            suffix.begin(),
+                            suffix.begin() + length);
+
+            for (auto tier : {SIMD::Tier::Scalar,
+                              SIMD::Tier::SSE42,
+                              SIMD::Tier::AVX2,
+                              SIMD::Tier::AVX512})
+            {
+                if (!SIMD::SetTier(tier)) continue;
+
+                std::vector<std::uint8_t> output(octets.size() * 3 / 2);
+                std::tie(result, length) =
+                    ConvertUTF16ToUTF8Lossy(octets, output, little_endian);
+                STF_ASSERT_TRUE(result);
+                output.resize(length);
+                STF_ASSERT_EQ(expected, output);
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF16toUTF8, NativeCodeUnits)
+{
+    const std::u16string_view text = u"Hello, 你好世界！ Привет 😀🌍";
+    const std::u8string expected = u8"Hello, 你好世界！ Привет 😀🌍";
+
+    // Convert directly from a std::u16string in the host's byte order
+    std::u8string output(text.size() * 3, u8'\0');
+    auto [result, length] = ConvertUTF16ToUTF8(text, output);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_TRUE(expected == output);
+
+    // An unpaired surrogate is rejected
+    const std::u16string invalid = {u'a', static_cast<char16_t>(0xdc00)};
+    output.resize(invalid.size() * 3);
+    STF_ASSERT_FALSE(ConvertUTF16ToUTF8(invalid, output).first);
+}
+
+STF_TEST(TestUTF16toUTF8, TemplateByteOrder)
+{
+    const std::vector<std::uint16_t> text = MultilingualText();
+    const std::vector<std::uint8_t> little = Serialize(text, true);
+    const std::vector<std::uint8_t> big = Serialize(text, false);
+    std::vector<std::uint8_t> expected(little.size() * 3 / 2);
+    std::vector<std::uint8_t> output(little.size() * 3 / 2);
+
+    // Little endian instantiation matches the run time byte order selection
+    auto [expected_result, expected_length] =
+        ConvertUTF16ToUTF8(little, expected, true);
+    STF_ASSERT_TRUE(expected_result);
+    auto [result, length] =
+        ConvertUTF16ToUTF8<std::endian::little>(little, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(expected_length, length);
+    STF_ASSERT_EQ(expected, output);
+
+    // Big endian instantiation produces the same UTF-8 string
+    std::tie(result, length) = ConvertUTF16ToUTF8<std::endian::big>(big,
+                                                                    output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(expected_length, length);
+    STF_ASSERT_EQ(expected, output);
+
+    // The partial conversion reports errors in the same way
+    const std::vector<std::uint8_t> invalid = {0x00, 0x61, 0xdc, 0x00};
+    ConversionResult partial =
+        ConvertUTF16ToUTF8Partial<std::endian::big>(invalid, output);
+    STF_ASSERT_FALSE(partial.success);
+    STF_ASSERT_EQ(2u, partial.consumed);
+    STF_ASSERT_EQ(1u, partial.produced);
+    STF_ASSERT_TRUE(partial.error == UnicodeError::UnpairedSurrogate);
+}
+
+namespace
+{
+
+// Memory resource that counts the allocations made through it
+class CountingResource : public std::pmr::memory_resource
+{
+    public:
+        std::size_t allocations{};
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes,
+                                                              alignment);
+        }
+
+        void do_deallocate(void *p,
+                           std::size_t bytes,
+                           std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+};
+
+} // namespace
+
+STF_TEST(TestUTF16toUTF8, Allocating)
+{
+    const std::vector<std::uint16_t> text = MultilingualText();
+    const std::u16string units(text.begin(), text.end());
+
+    // The octets returned match those of the non-allocating function
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> octets = Serialize(text,
+                                                           little_endian);
+        std::vector<std::uint8_t> expected(octets.size() * 3 / 2);
+        auto [result, length] =
+            ConvertUTF16ToUTF8(octets, expected, little_endian);
+        STF_ASSERT_TRUE(result);
+        expected.resize(length);
+
+        std::optional<std::vector<std::uint8_t>> output =
+            ConvertUTF16ToUTF8(octets, little_endian);
+        STF_ASSERT_TRUE(output.has_value());
+        STF_ASSERT_EQ(expected, *output);
+
+        // An odd number of octets produces no output
+        STF_ASSERT_FALSE(ConvertUTF16ToUTF8(
+            std::span<const std::uint8_t>(octets).first(octets.size() - 1),
+            little_endian));
+    }
+
+    // The string returned has exactly the required length
+    std::u8string expected(units.size() * 3, u8'\0');
+    auto [result, length] = ConvertUTF16ToUTF8(units, expected);
+    STF_ASSERT_TRUE(result);
+    expected.resize(length);
+    std::optional<std::string> output = ConvertUTF16ToUTF8(units);
+    STF_ASSERT_TRUE(output.has_value());
+    STF_ASSERT_EQ(expected.size(), output->size());
+    STF_ASSERT_TRUE(std::equal(expected.begin(),
+                               expected.end(),
+                               output->begin(),
+                               [](char8_t a, char b)
+                               {
+                                   return a == static_cast<char8_t>(b);
+                               }));
+
+    // Only one allocation is made from the memory resource
+    CountingResource resource;
+    std::optional<std::pmr::string> pmr_output =
+        ConvertUTF16ToUTF8(units, &resource);
+    STF_ASSERT_TRUE(pmr_output.has_value());
+    STF_ASSERT_TRUE(std::string_view(*pmr_output) == *output);
+    STF_ASSERT_EQ(1u, resource.allocations);
+
+    // Empty input produces an empty string
+    output = ConvertUTF16ToUTF8(std::u16string_view{});
+    STF_ASSERT_TRUE(output.has_value());
+    STF_ASSERT_TRUE(output->empty());
+
+    // An unpaired surrogate produces no string
+    const std::u16string invalid = {u'a', static_cast<char16_t>(0xd83d)};
+    STF_ASSERT_FALSE(ConvertUTF16ToUTF8(invalid));
+    STF_ASSERT_FALSE(ConvertUTF16ToUTF8(invalid, &resource));
+}
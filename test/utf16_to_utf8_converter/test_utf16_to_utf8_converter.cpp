@@ -0,0 +1,211 @@
+/*
+ *  test_utf16_to_utf8_converter.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the object that converts a stream of UTF-16
+ *      octets to UTF-8.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <terra/charutil/utf16_to_utf8_converter.h>
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a UTF-16 string long enough to be processed by the SIMD kernels
+std::vector<std::uint8_t> MultilingualText(bool little_endian)
+{
+    std::u16string text;
+
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        text += u"Hello, World! ";
+        text += u"你好世界！";
+        text += u"Привет, мир! ";
+        text += u"😀 🌍 ";
+    }
+
+    std::vector<std::uint8_t> octets;
+    for (char16_t c : text)
+    {
+        if (little_endian)
+        {
+            octets.push_back(static_cast<std::uint8_t>(c & 0xff));
+            octets.push_back(static_cast<std::uint8_t>(c >> 8));
+        }
+        else
+        {
+            octets.push_back(static_cast<std::uint8_t>(c >> 8));
+            octets.push_back(static_cast<std::uint8_t>(c & 0xff));
+        }
+    }
+
+    return octets;
+}
+
+// Convert the entire text in one call
+std::vector<std::uint8_t> Convert(const std::vector<std::uint8_t> &text,
+                                  bool little_endian)
+{
+    std::vector<std::uint8_t> output(text.size() * 3 / 2);
+    auto [result, length] = ConvertUTF16ToUTF8(text, output, little_endian);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+
+    return output;
+}
+
+} // namespace
+
+STF_TEST(TestUTF16toUTF8Converter, Chunks)
+{
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> text = MultilingualText(little_endian);
+        const std::vector<std::uint8_t> expected = Convert(text,
+                                                           little_endian);
+        UTF16ToUTF8Converter converter(little_endian);
+
+        // Feed the text in chunks of every size up to 100 octets, giving an
+        // output span large enough to accept each entire chunk
+        for (std::size_t chunk_size = 1; chunk_size <= 100; chunk_size++)
+        {
+            std::vector<std::uint8_t> output;
+
+            for (std::size_t i = 0; i < text.size(); i += chunk_size)
+            {
+                std::span<const std::uint8_t> chunk =
+                    std::span<const std::uint8_t>(text).subspan(
+                        i,
+                        std::min(chunk_size, text.size() - i));
+                std::vector<std::uint8_t> buffer(chunk.size() * 3 / 2 + 4);
+
+                ConversionResult result = converter.Feed(chunk, buffer);
+                STF_ASSERT_TRUE(result.success);
+                STF_ASSERT_EQ(chunk.size(), result.consumed);
+                output.insert(output.end(),
+                              buffer.begin(),
+                              buffer.begin() + result.produced);
+            }
+
+            STF_ASSERT_TRUE(converter.Finish());
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+}
+
+STF_TEST(TestUTF16toUTF8Converter, SmallOutput)
+{
+    const std::vector<std::uint8_t> text = MultilingualText(true);
+    const std::vector<std::uint8_t> expected = Convert(text, true);
+    UTF16ToUTF8Converter converter(true);
+
+    // Feed the text in chunks into an output span that holds only a few
+    // characters, feeding the unconsumed remainder of each chunk again
+    for (std::size_t chunk_size = 1; chunk_size <= 20; chunk_size++)
+    {
+        std::vector<std::uint8_t> output;
+        std::vector<std::uint8_t> buffer(5);
+
+        for (std::size_t i = 0; i < text.size(); i += chunk_size)
+        {
+            std::span<const std::uint8_t> chunk =
+                std::span<const std::uint8_t>(text).subspan(
+                    i,
+                    std::min(chunk_size, text.size() - i));
+
+            while (!chunk.empty())
+            {
+                ConversionResult result = converter.Feed(chunk, buffer);
+                STF_ASSERT_TRUE(result.success);
+                output.insert(output.end(),
+                              buffer.begin(),
+                              buffer.begin() + result.produced);
+                chunk = chunk.subspan(result.consumed);
+            }
+        }
+
+        STF_ASSERT_TRUE(converter.Finish());
+        STF_ASSERT_EQ(expected, output);
+    }
+}
+
+STF_TEST(TestUTF16toUTF8Converter, Truncated)
+{
+    std::vector<std::uint8_t> output(16);
+    UTF16ToUTF8Converter converter(true);
+
+    // An odd final octet is retained
+    ConversionResult result =
+        converter.Feed(std::vector<std::uint8_t>{0x61, 0x00, 0x62}, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(3u, result.consumed);
+    STF_ASSERT_EQ(1u, result.produced);
+    STF_ASSERT_FALSE(converter.Finish());
+
+    // A high surrogate is retained until the low surrogate arrives
+    result = converter.Feed(std::vector<std::uint8_t>{0x3d, 0xd8}, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_EQ(0u, result.produced);
+    result = converter.Feed(std::vector<std::uint8_t>{0x00}, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(0u, result.produced);
+    result = converter.Feed(std::vector<std::uint8_t>{0xde, 0x61, 0x00},
+                            output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(3u, result.consumed);
+    STF_ASSERT_EQ(5u, result.produced);
+    STF_ASSERT_EQ(std::vector<std::uint8_t>({0xf0, 0x9f, 0x98, 0x80, 0x61}),
+                  std::vector<std::uint8_t>(output.begin(),
+                                            output.begin() + 5));
+    STF_ASSERT_TRUE(converter.Finish());
+
+    // The stream ends with an unpaired high surrogate
+    result = converter.Feed(std::vector<std::uint8_t>{0x3d, 0xd8}, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_FALSE(converter.Finish());
+}
+
+STF_TEST(TestUTF16toUTF8Converter, Invalid)
+{
+    std::vector<std::uint8_t> output(16);
+    UTF16ToUTF8Converter converter(false);
+
+    // An unpaired low surrogate is reported at its position
+    ConversionResult result = converter.Feed(
+        std::vector<std::uint8_t>{0x00, 0x61, 0xdc, 0x00, 0x00, 0x62},
+        output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_EQ(1u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::UnpairedSurrogate);
+    converter.Reset();
+
+    // A high surrogate split across chunks must be followed by a low
+    // surrogate
+    result = converter.Feed(std::vector<std::uint8_t>{0xd8}, output);
+    STF_ASSERT_TRUE(result.success);
+    result = converter.Feed(std::vector<std::uint8_t>{0x3d, 0x00, 0x61},
+                            output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(0u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::UnpairedSurrogate);
+}
@@ -0,0 +1,381 @@
+/*
+ *  test_utf32.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test logic related converting strings between UTF-32
+ *      and both UTF-8 and UTF-16.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Serialize the UTF-8 string as a vector of octets
+std::vector<std::uint8_t> Serialize(const std::u8string &text)
+{
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Serialize the UTF-16 or UTF-32 string in the specified byte order
+template<typename T>
+std::vector<std::uint8_t> Serialize(const std::basic_string<T> &text,
+                                    bool little_endian)
+{
+    std::vector<std::uint8_t> octets;
+
+    for (T c : text)
+    {
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            std::size_t shift = little_endian ? (i * 8) :
+                                                ((sizeof(T) - 1 - i) * 8);
+            octets.push_back(static_cast<std::uint8_t>(
+                (static_cast<std::uint32_t>(c) >> shift) & 0xff));
+        }
+    }
+
+    return octets;
+}
+
+// Text in each encoding long enough to be processed by the SIMD kernels
+struct MultilingualText
+{
+    std::u8string utf8;
+    std::u16string utf16;
+    std::u32string utf32;
+
+    MultilingualText()
+    {
+        for (std::size_t i = 0; i < 8; i++)
+        {
+            utf8 += u8"Hello, World! The quick brown fox jumps over the dog. ";
+            utf8 += u8"你好世界！Привет, мир! 😀 🌍 ";
+            utf16 += u"Hello, World! The quick brown fox jumps over the dog. ";
+            utf16 += u"你好世界！Привет, мир! 😀 🌍 ";
+            utf32 += U"Hello, World! The quick brown fox jumps over the dog. ";
+            utf32 += U"你好世界！Привет, мир! 😀 🌍 ";
+        }
+    }
+};
+
+// Call the given function using every supported SIMD tier
+template<typename F>
+void ForAllTiers(F function)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+        function();
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+} // namespace
+
+STF_TEST(TestUTF32, Empty)
+{
+    std::vector<std::uint8_t> input;
+    std::vector<std::uint8_t> output;
+
+    auto [result_1, length_1] = ConvertUTF8ToUTF32(input, output, true);
+    STF_ASSERT_TRUE(result_1);
+    STF_ASSERT_EQ(0u, length_1);
+
+    auto [result_2, length_2] = ConvertUTF32ToUTF8(input, output, true);
+    STF_ASSERT_TRUE(result_2);
+    STF_ASSERT_EQ(0u, length_2);
+
+    auto [result_3, length_3] = ConvertUTF16ToUTF32(input, output, true);
+    STF_ASSERT_TRUE(result_3);
+    STF_ASSERT_EQ(0u, length_3);
+
+    auto [result_4, length_4] = ConvertUTF32ToUTF16(input, output, true);
+    STF_ASSERT_TRUE(result_4);
+    STF_ASSERT_EQ(0u, length_4);
+}
+
+STF_TEST(TestUTF32, Emoji_LE)
+{
+    const std::vector<std::uint8_t> utf8 =
+    {
+        0x61, 0xc3, 0xa9, 0xe4, 0xbd, 0xa0, 0xf0, 0x9f, 0x98, 0x80
+    };
+    const std::vector<std::uint8_t> utf16 =
+    {
+        0x61, 0x00, 0xe9, 0x00, 0x60, 0x4f, 0x3d, 0xd8, 0x00, 0xde
+    };
+    const std::vector<std::uint8_t> utf32 =
+    {
+        0x61, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00,
+        0x60, 0x4f, 0x00, 0x00, 0x00, 0xf6, 0x01, 0x00
+    };
+
+    std::vector<std::uint8_t> output(64);
+    auto [result, length] = ConvertUTF8ToUTF32(utf8, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf32, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF32ToUTF8(utf32, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf8, std::vector<std::uint8_t>(output.begin(),
+                                                  output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF16ToUTF32(utf16, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf32, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF32ToUTF16(utf32, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf16, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+}
+
+STF_TEST(TestUTF32, Emoji_BE)
+{
+    const std::vector<std::uint8_t> utf8 =
+    {
+        0x61, 0xc3, 0xa9, 0xe4, 0xbd, 0xa0, 0xf0, 0x9f, 0x98, 0x80
+    };
+    const std::vector<std::uint8_t> utf16 =
+    {
+        0x00, 0x61, 0x00, 0xe9, 0x4f, 0x60, 0xd8, 0x3d, 0xde, 0x00
+    };
+    const std::vector<std::uint8_t> utf32 =
+    {
+        0x00, 0x00, 0x00, 0x61, 0x00, 0x00, 0x00, 0xe9,
+        0x00, 0x00, 0x4f, 0x60, 0x00, 0x01, 0xf6, 0x00
+    };
+
+    std::vector<std::uint8_t> output(64);
+    auto [result, length] = ConvertUTF8ToUTF32(utf8, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf32, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF32ToUTF8(utf32, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf8, std::vector<std::uint8_t>(output.begin(),
+                                                  output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF16ToUTF32(utf16, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf32, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+
+    std::tie(result, length) = ConvertUTF32ToUTF16(utf32, output, false);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(utf16, std::vector<std::uint8_t>(output.begin(),
+                                                   output.begin() + length));
+}
+
+STF_TEST(TestUTF32, InsufficientOutput)
+{
+    const std::vector<std::uint8_t> utf32 = {0x61, 0x00, 0x00, 0x00};
+    std::vector<std::uint8_t> output(3);
+
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF32(std::vector<std::uint8_t>{0x61},
+                                        output,
+                                        true).first);
+    STF_ASSERT_FALSE(ConvertUTF32ToUTF8(utf32, output, true).first);
+    STF_ASSERT_FALSE(
+        ConvertUTF16ToUTF32(std::vector<std::uint8_t>{0x61, 0x00},
+                            output,
+                            true).first);
+    STF_ASSERT_FALSE(ConvertUTF32ToUTF16(utf32, output, true).first);
+}
+
+STF_TEST(TestUTF32, Invalid)
+{
+    std::vector<std::uint8_t> output(64);
+
+    // UTF-32 must be a multiple of four octets and contain only Unicode
+    // scalar values
+    for (const std::vector<std::uint8_t> &utf32 :
+            {std::vector<std::uint8_t>{0x61, 0x00, 0x00},
+             std::vector<std::uint8_t>{0x00, 0xd8, 0x00, 0x00},
+             std::vector<std::uint8_t>{0xff, 0xdf, 0x00, 0x00},
+             std::vector<std::uint8_t>{0x00, 0x00, 0x11, 0x00},
+             std::vector<std::uint8_t>{0x61, 0x00, 0x00, 0x80}})
+    {
+        STF_ASSERT_FALSE(ConvertUTF32ToUTF8(utf32, output, true).first);
+        STF_ASSERT_FALSE(ConvertUTF32ToUTF16(utf32, output, true).first);
+    }
+
+    // UTF-16 must have an even number of octets and paired surrogates
+    for (const std::vector<std::uint8_t> &utf16 :
+            {std::vector<std::uint8_t>{0x61, 0x00, 0x62},
+             std::vector<std::uint8_t>{0x3d, 0xd8},
+             std::vector<std::uint8_t>{0x3d, 0xd8, 0x61, 0x00},
+             std::vector<std::uint8_t>{0x00, 0xde, 0x3d, 0xd8}})
+    {
+        STF_ASSERT_FALSE(ConvertUTF16ToUTF32(utf16, output, true).first);
+    }
+
+    // UTF-8 must be well-formed
+    for (const std::vector<std::uint8_t> &utf8 :
+            {std::vector<std::uint8_t>{0x61, 0xe4, 0xbd},
+             std::vector<std::uint8_t>{0xc0, 0x80},
+             std::vector<std::uint8_t>{0xed, 0xa0, 0x80},
+             std::vector<std::uint8_t>{0xf4, 0x90, 0x80, 0x80},
+             std::vector<std::uint8_t>{0x80}})
+    {
+        STF_ASSERT_FALSE(ConvertUTF8ToUTF32(utf8, output, true).first);
+    }
+}
+
+STF_TEST(TestUTF32, LongText)
+{
+    const MultilingualText text;
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> utf8 = Serialize(text.utf8);
+        const std::vector<std::uint8_t> utf16 = Serialize(text.utf16,
+                                                          little_endian);
+        const std::vector<std::uint8_t> utf32 = Serialize(text.utf32,
+                                                          little_endian);
+
+        ForAllTiers([&]()
+        {
+            std::vector<std::uint8_t> output(utf8.size() * 4);
+
+            auto [result, length] =
+                ConvertUTF8ToUTF32(utf8, output, little_endian);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(utf32, output);
+
+            output.resize(utf32.size());
+            std::tie(result, length) =
+                ConvertUTF32ToUTF8(utf32, output, little_endian);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(utf8, output);
+
+            output.resize(utf16.size() * 2);
+            std::tie(result, length) =
+                ConvertUTF16ToUTF32(utf16, output, little_endian);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(utf32, output);
+
+            output.resize(utf32.size());
+            std::tie(result, length) =
+                ConvertUTF32ToUTF16(utf32, output, little_endian);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(utf16, output);
+        });
+    }
+}
+
+STF_TEST(TestUTF32, LongASCII)
+{
+    // Convert ASCII strings of every length up to several SIMD blocks
+    for (std::size_t i = 0; i < 300; i++)
+    {
+        for (bool little_endian : {true, false})
+        {
+            const std::vector<std::uint8_t> utf8 =
+                Serialize(std::u8string(i, u8'a'));
+            const std::vector<std::uint8_t> utf16 =
+                Serialize(std::u16string(i, u'a'), little_endian);
+            const std::vector<std::uint8_t> utf32 =
+                Serialize(std::u32string(i, U'a'), little_endian);
+
+            ForAllTiers([&]()
+            {
+                std::vector<std::uint8_t> output(utf32.size());
+
+                auto [result, length] =
+                    ConvertUTF8ToUTF32(utf8, output, little_endian);
+                STF_ASSERT_TRUE(result);
+                STF_ASSERT_EQ(utf32, output);
+
+                std::tie(result, length) =
+                    ConvertUTF32ToUTF8(utf32, output, little_endian);
+                STF_ASSERT_TRUE(result);
+                STF_ASSERT_EQ(utf8,
+                              std::vector<std::uint8_t>(
+                                  output.begin(),
+                                  output.begin() + length));
+
+                std::tie(result, length) =
+                    ConvertUTF16ToUTF32(utf16, output, little_endian);
+                STF_ASSERT_TRUE(result);
+                STF_ASSERT_EQ(utf32, output);
+
+                std::tie(result, length) =
+                    ConvertUTF32ToUTF16(utf32, output, little_endian);
+                STF_ASSERT_TRUE(result);
+                STF_ASSERT_EQ(utf16,
+                              std::vector<std::uint8_t>(
+                                  output.begin(),
+                                  output.begin() + length));
+            });
+        }
+    }
+}
+
+STF_TEST(TestUTF32, LongInvalid)
+{
+    const std::u32string text(200, U'你');
+
+    // Place an invalid value at every position within a long string to
+    // ensure the SIMD kernels never convert past it
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        for (bool little_endian : {true, false})
+        {
+            std::u32string invalid_utf32 = text;
+            invalid_utf32[i] = (i & 1) ? 0xdc00 : 0x11'0000;
+            const std::vector<std::uint8_t> utf32 = Serialize(invalid_utf32,
+                                                              little_endian);
+
+            std::u16string invalid_utf16(text.begin(), text.end());
+            invalid_utf16[i] = (i & 1) ? u'\xdc00' : u'\xd800';
+            const std::vector<std::uint8_t> utf16 = Serialize(invalid_utf16,
+                                                              little_endian);
+
+            ForAllTiers([&]()
+            {
+                std::vector<std::uint8_t> output(utf32.size() * 4);
+
+                STF_ASSERT_FALSE(
+                    ConvertUTF32ToUTF8(utf32, output, little_endian).first);
+                STF_ASSERT_FALSE(
+                    ConvertUTF32ToUTF16(utf32, output, little_endian).first);
+                STF_ASSERT_FALSE(
+                    ConvertUTF16ToUTF32(utf16, output, little_endian).first);
+            });
+        }
+    }
+}
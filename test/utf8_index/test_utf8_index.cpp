@@ -0,0 +1,187 @@
+/*
+ *  test_utf8_index.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the object that maps between code point
+ *      positions and octet offsets within a UTF-8 string.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <string>
+#include <terra/charutil/utf8_index.h>
+#include <terra/charutil/character_utilities.h>
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a string with characters of every encoded length
+std::vector<std::uint8_t> MultilingualText(std::size_t repetitions)
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < repetitions; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Return the offset of each code point, followed by the length of the text
+std::vector<std::size_t> CodePointOffsets(const std::vector<std::uint8_t> &text)
+{
+    std::vector<std::size_t> offsets;
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        if ((text[i] & 0xc0) != 0x80) offsets.push_back(i);
+    }
+    offsets.push_back(text.size());
+
+    return offsets;
+}
+
+// Verify every lookup using an index with the given stride
+void CheckIndex(const std::vector<std::uint8_t> &text, std::size_t stride)
+{
+    const std::vector<std::size_t> expected = CodePointOffsets(text);
+    const std::size_t code_points = expected.size() - 1;
+    UTF8Index index(text, stride);
+
+    STF_ASSERT_EQ(code_points, index.CodePoints());
+
+    // Map each code point position to its offset
+    for (std::size_t i = 0; i <= code_points; i++)
+    {
+        std::optional<std::size_t> offset = index.OffsetOf(i);
+        STF_ASSERT_TRUE(offset.has_value());
+        STF_ASSERT_EQ(expected[i], *offset);
+    }
+    STF_ASSERT_FALSE(index.OffsetOf(code_points + 1).has_value());
+
+    // Map each offset to the position of the code point containing it
+    std::size_t position = 0;
+    for (std::size_t i = 0; i <= text.size(); i++)
+    {
+        if (expected[position + 1] <= i) position++;
+
+        std::optional<std::size_t> result = index.PositionOf(i);
+        STF_ASSERT_TRUE(result.has_value());
+        STF_ASSERT_EQ(position, *result);
+    }
+    STF_ASSERT_FALSE(index.PositionOf(text.size() + 1).has_value());
+}
+
+} // namespace
+
+STF_TEST(TestUTF8Index, Empty)
+{
+    const std::vector<std::uint8_t> text;
+    UTF8Index index(text);
+
+    STF_ASSERT_EQ(0u, index.CodePoints());
+
+    std::optional<std::size_t> offset = index.OffsetOf(0);
+    STF_ASSERT_TRUE(offset.has_value());
+    STF_ASSERT_EQ(0u, *offset);
+    STF_ASSERT_FALSE(index.OffsetOf(1).has_value());
+
+    std::optional<std::size_t> position = index.PositionOf(0);
+    STF_ASSERT_TRUE(position.has_value());
+    STF_ASSERT_EQ(0u, *position);
+    STF_ASSERT_FALSE(index.PositionOf(1).has_value());
+
+    STF_ASSERT_EQ(0u, index.Substring(0, 10)->size());
+    STF_ASSERT_FALSE(index.Substring(1, 1).has_value());
+}
+
+STF_TEST(TestUTF8Index, ASCII)
+{
+    const std::vector<std::uint8_t> text(1000, 'a');
+
+    for (std::size_t stride : {0, 1, 7, 64, 256, 1000, 4096})
+    {
+        CheckIndex(text, stride);
+    }
+}
+
+STF_TEST(TestUTF8Index, Multilingual)
+{
+    const std::vector<std::uint8_t> text = MultilingualText(40);
+
+    for (std::size_t stride : {1, 2, 3, 8, 31, 64, 255, 256, 257, 1024})
+    {
+        CheckIndex(text, stride);
+    }
+
+    // Strides that divide the number of code points exactly
+    const std::size_t code_points = CodePointOffsets(text).size() - 1;
+    CheckIndex(text, code_points);
+    CheckIndex(text, code_points / 2);
+}
+
+STF_TEST(TestUTF8Index, Large)
+{
+    const std::vector<std::uint8_t> text = MultilingualText(2000);
+    const std::vector<std::size_t> expected = CodePointOffsets(text);
+    UTF8Index index(text);
+
+    STF_ASSERT_EQ(expected.size() - 1, index.CodePoints());
+
+    for (std::size_t i = 0; i < expected.size(); i += 97)
+    {
+        std::optional<std::size_t> offset = index.OffsetOf(i);
+        STF_ASSERT_TRUE(offset.has_value());
+        STF_ASSERT_EQ(expected[i], *offset);
+
+        std::optional<std::size_t> position = index.PositionOf(expected[i]);
+        STF_ASSERT_TRUE(position.has_value());
+        STF_ASSERT_EQ(i, *position);
+    }
+}
+
+STF_TEST(TestUTF8Index, Substring)
+{
+    const std::u8string hello = u8"Hello, 世界😀!";
+    const std::vector<std::uint8_t> text(hello.begin(), hello.end());
+    UTF8Index index(text, 2);
+
+    auto Expect = [](const std::u8string &string)
+    {
+        return std::vector<std::uint8_t>(string.begin(), string.end());
+    };
+    auto Extract = [&](std::size_t position, std::size_t count)
+    {
+        std::span<const std::uint8_t> octets = *index.Substring(position,
+                                                                count);
+        return std::vector<std::uint8_t>(octets.begin(), octets.end());
+    };
+
+    STF_ASSERT_EQ(Expect(u8"Hello"), Extract(0, 5));
+    STF_ASSERT_EQ(Expect(u8"世界"), Extract(7, 2));
+    STF_ASSERT_EQ(Expect(u8"界😀!"), Extract(8, 100));
+    STF_ASSERT_EQ(Expect(u8""), Extract(11, 1));
+    STF_ASSERT_FALSE(index.Substring(12, 1).has_value());
+
+    // The span refers to the original string
+    STF_ASSERT_EQ(text.data() + 7, index.Substring(7, 1)->data());
+}
@@ -18,7 +18,12 @@
 
 #include <cstdint>
 #include <vector>
+#include <string>
+#include <tuple>
+#include <optional>
+#include <memory_resource>
 #include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
 #include <terra/stf/adapters/integral_vector.h>
 #include <terra/stf/stf.h>
 
@@ -421,3 +426,684 @@ STF_TEST(TestUTF8toUTF16, Emoji_2)
     // Ensure the conversion is correct
     STF_ASSERT_EQ(expected, output);
 }
+
+namespace
+{
+
+// Produce a string long enough to be processed by the SIMD kernels
+std::u8string MultilingualText()
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return text;
+}
+
+// Convert the text using every supported SIMD tier and ensure each produces
+// the same result as the scalar implementation
+void CheckAllTiers(const std::u8string &text, bool expected_result)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    for (bool little_endian : {true, false})
+    {
+        SIMD::SetTier(SIMD::Tier::Scalar);
+        std::vector<std::uint8_t> expected(text.size() * 2);
+        auto [expected_result_scalar, expected_length] =
+            ConvertUTF8ToUTF16(octets, expected, little_endian);
+        STF_ASSERT_EQ(expected_result, expected_result_scalar);
+        expected.resize(expected_length);
+
+        for (auto tier : {SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            std::vector<std::uint8_t> output(text.size() * 2);
+            auto [result, length] =
+                ConvertUTF8ToUTF16(octets, output, little_endian);
+            STF_ASSERT_EQ(expected_result, result);
+            if (!result) continue;
+            output.resize(length);
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+} // namespace
+
+STF_TEST(TestUTF8toUTF16, LongText)
+{
+    const std::u8string text = MultilingualText();
+
+    // Check every alignment of the text relative to the SIMD block size
+    for (std::size_t i = 0; i < 64; i++)
+    {
+        CheckAllTiers(std::u8string(i, u8'x') + text, true);
+    }
+}
+
+STF_TEST(TestUTF8toUTF16, LongASCII)
+{
+    for (std::size_t i = 0; i < 200; i++)
+    {
+        CheckAllTiers(std::u8string(i, u8'a'), true);
+    }
+}
+
+STF_TEST(TestUTF8toUTF16, LongRoundTrip)
+{
+    const std::u8string text = MultilingualText();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    // Convert to UTF-16 and back again
+    std::vector<std::uint8_t> utf16(text.size() * 2);
+    auto [result, length] = ConvertUTF8ToUTF16(octets, utf16, false);
+    STF_ASSERT_TRUE(result);
+    utf16.resize(length);
+
+    std::vector<std::uint8_t> utf8(utf16.size() * 3 / 2);
+    std::tie(result, length) = ConvertUTF16ToUTF8(utf16, utf8, false);
+    STF_ASSERT_TRUE(result);
+    utf8.resize(length);
+
+    STF_ASSERT_EQ(std::vector<std::uint8_t>(octets.begin(), octets.end()),
+                  utf8);
+}
+
+STF_TEST(TestUTF8toUTF16, LongInvalidOctet)
+{
+    const std::u8string text = MultilingualText();
+
+    // Place an invalid octet at every position
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        std::u8string invalid = text;
+        invalid[i] = static_cast<char8_t>(0xff);
+        CheckAllTiers(invalid, false);
+    }
+}
+
+STF_TEST(TestUTF8toUTF16, LongTruncated)
+{
+    const std::u8string text = MultilingualText();
+
+    // Truncate the text at every position, which is valid only when the
+    // truncation occurs at a character boundary
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        bool boundary = (static_cast<std::uint8_t>(text[i]) & 0xc0) != 0x80;
+        CheckAllTiers(text.substr(0, i), boundary);
+    }
+}
+
+STF_TEST(TestUTF8toUTF16, ASCIIRuns)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+
+    // Place a non-ASCII character at every position within runs of ASCII
+    // characters to exercise the ASCII widening in each tier
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        for (std::size_t j = 0; j <= i; j++)
+        {
+            std::u8string text(i, u8'a');
+            text.insert(j, u8"é");
+
+            std::vector<std::uint8_t> expected;
+            for (std::size_t k = 0; k <= i; k++)
+            {
+                if (k == j)
+                {
+                    expected.push_back(0xe9);
+                    expected.push_back(0x00);
+                }
+                if (k < i)
+                {
+                    expected.push_back('a');
+                    expected.push_back(0x00);
+                }
+            }
+
+            for (auto tier : {SIMD::Tier::Scalar,
+                              SIMD::Tier::SSE42,
+                              SIMD::Tier::AVX2,
+                              SIMD::Tier::AVX512})
+            {
+                if (!SIMD::SetTier(tier)) continue;
+
+                std::vector<std::uint8_t> output(text.size() * 2);
+                auto [result, length] = ConvertUTF8ToUTF16(
+                    std::span<const std::uint8_t>(
+                        reinterpret_cast<const std::uint8_t *>(text.data()),
+                        text.size()),
+                    output,
+                    true);
+                STF_ASSERT_TRUE(result);
+                output.resize(length);
+                STF_ASSERT_EQ(expected, output);
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF8toUTF16, UTF16Length)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::u8string text = MultilingualText();
+
+    STF_ASSERT_EQ(0u, UTF16LengthFromUTF8({}));
+
+    // Measure every prefix of the text that ends on a character boundary
+    for (std::size_t i = 0; i <= text.size(); i++)
+    {
+        if ((i < text.size()) &&
+            ((static_cast<std::uint8_t>(text[i]) & 0xc0) == 0x80))
+        {
+            continue;
+        }
+
+        const std::span<const std::uint8_t> octets(
+            reinterpret_cast<const std::uint8_t *>(text.data()),
+            i);
+
+        std::vector<std::uint8_t> output(octets.size() * 2);
+        auto [result, length] = ConvertUTF8ToUTF16(octets, output, true);
+        STF_ASSERT_TRUE(result);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            STF_ASSERT_EQ(length, UTF16LengthFromUTF8(octets));
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF8toUTF16, CodePointCount)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::u8string text = MultilingualText();
+
+    STF_ASSERT_EQ(0u, CountUTF8CodePoints({}));
+
+    // Count every prefix of the text that ends on a character boundary
+    for (std::size_t i = 0; i <= text.size(); i++)
+    {
+        if ((i < text.size()) &&
+            ((static_cast<std::uint8_t>(text[i]) & 0xc0) == 0x80))
+        {
+            continue;
+        }
+
+        const std::span<const std::uint8_t> octets(
+            reinterpret_cast<const std::uint8_t *>(text.data()),
+            i);
+
+        std::vector<std::uint8_t> output(octets.size() * 4);
+        auto [result, length] = ConvertUTF8ToUTF32(octets, output, true);
+        STF_ASSERT_TRUE(result);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            STF_ASSERT_EQ(length / 4, CountUTF8CodePoints(octets));
+        }
+    }
+
+    // Count inputs long enough to overflow any narrow vector counters
+    const std::vector<std::uint8_t> ascii(100'000, 'a');
+    std::vector<std::uint8_t> emoji;
+    while (emoji.size() < 100'000)
+    {
+        emoji.insert(emoji.end(), {0xf0, 0x9f, 0x98, 0x80});
+    }
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+
+        STF_ASSERT_EQ(ascii.size(), CountUTF8CodePoints(ascii));
+        STF_ASSERT_EQ(emoji.size() / 4, CountUTF8CodePoints(emoji));
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF8toUTF16, PartialBuffers)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::u8string text = MultilingualText();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    for (bool little_endian : {true, false})
+    {
+        std::vector<std::uint8_t> expected(text.size() * 2);
+        auto [result, length] =
+            ConvertUTF8ToUTF16(octets, expected, little_endian);
+        STF_ASSERT_TRUE(result);
+        expected.resize(length);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            // Convert the text into fixed-size buffers of various sizes
+            for (std::size_t buffer_size = 4; buffer_size < 200; buffer_size++)
+            {
+                std::vector<std::uint8_t> output;
+                std::vector<std::uint8_t> buffer(buffer_size);
+                std::size_t position = 0;
+
+                while (position < octets.size())
+                {
+                    ConversionResult partial = ConvertUTF8ToUTF16Partial(
+                        octets.subspan(position),
+                        buffer,
+                        little_endian);
+                    STF_ASSERT_TRUE(partial.success);
+                    STF_ASSERT_GT(partial.produced, 0u);
+                    STF_ASSERT_LE(partial.produced, buffer_size);
+                    output.insert(output.end(),
+                                  buffer.begin(),
+                                  buffer.begin() + partial.produced);
+                    position += partial.consumed;
+                }
+
+                STF_ASSERT_EQ(expected, output);
+            }
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF8toUTF16, PartialErrors)
+{
+    std::vector<std::uint8_t> output(64);
+
+    // An invalid octet is reported at its position
+    const std::vector<std::uint8_t> invalid = {'a', 'b', 0xc3, 0xa9, 0xff};
+    ConversionResult result = ConvertUTF8ToUTF16Partial(invalid, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(4u, result.consumed);
+    STF_ASSERT_EQ(6u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::InvalidLeadOctet);
+
+    // A truncated sequence is reported at its start
+    const std::vector<std::uint8_t> truncated = {'a', 0xe4, 0xbd};
+    result = ConvertUTF8ToUTF16Partial(truncated, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(1u, result.consumed);
+    STF_ASSERT_EQ(2u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::TruncatedSequence);
+
+    // A surrogate code point is reported at its start
+    const std::vector<std::uint8_t> surrogate = {'a', 0xed, 0xb0, 0x80};
+    result = ConvertUTF8ToUTF16Partial(surrogate, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(1u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::Surrogate);
+
+    // A code point above U+10FFFF is reported at its start
+    const std::vector<std::uint8_t> range = {'a', 'b', 0xf5, 0x80, 0x80, 0x80};
+    result = ConvertUTF8ToUTF16Partial(range, output, true);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::OutOfRange);
+
+    // A surrogate pair is not split when the output is too small
+    const std::vector<std::uint8_t> emoji = {'a', 0xf0, 0x9f, 0x98, 0x80};
+    result = ConvertUTF8ToUTF16Partial(
+        emoji,
+        std::span<std::uint8_t>(output.data(), 4),
+        true);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(1u, result.consumed);
+    STF_ASSERT_EQ(2u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::None);
+
+    // Nothing is produced given an empty output span
+    result = ConvertUTF8ToUTF16Partial(emoji, {}, true);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(0u, result.consumed);
+    STF_ASSERT_EQ(0u, result.produced);
+}
+
+STF_TEST(TestUTF8toUTF16, Lossy)
+{
+    // Example from Section 3.9 of the Unicode Standard (Table 3-8)
+    const std::vector<std::uint8_t> input = {
+        0x61, 0xf1, 0x80, 0x80, 0xe1, 0x80, 0xc2, 0x62,
+        0x80, 0x63, 0x80, 0xbf, 0x64
+    };
+    const std::vector<std::uint8_t> expected = {
+        0x00, 0x61, 0xff, 0xfd, 0xff, 0xfd, 0xff, 0xfd,
+        0x00, 0x62, 0xff, 0xfd, 0x00, 0x63, 0xff, 0xfd,
+        0xff, 0xfd, 0x00, 0x64
+    };
+    std::vector<std::uint8_t> output(input.size() * 2);
+
+    auto [result, length] = ConvertUTF8ToUTF16Lossy(input, output, false);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_EQ(expected, output);
+
+    // Surrogates and characters above U+10FFFF are replaced one octet at a
+    // time since no prefix of them is valid
+    const std::vector<std::uint8_t> invalid = {0xed, 0xa0, 0x80, 0xf4, 0x90,
+                                               0x80, 0x80, 0xe4, 0xbd};
+    output.resize(invalid.size() * 2);
+    std::tie(result, length) = ConvertUTF8ToUTF16Lossy(invalid, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(16u, length);
+    for (std::size_t i = 0; i < length; i += 2)
+    {
+        STF_ASSERT_EQ(0xfd, output[i]);
+        STF_ASSERT_EQ(0xff, output[i + 1]);
+    }
+
+    // The output span must be at least twice the input length
+    output.resize(invalid.size() * 2 - 1);
+    std::tie(result, length) = ConvertUTF8ToUTF16Lossy(invalid, output, true);
+    STF_ASSERT_FALSE(result);
+}
+
+STF_TEST(TestUTF8toUTF16, LongLossy)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::u8string text = MultilingualText();
+
+    // Corrupt the lead octet of each character, which results in one
+    // replacement character for each octet of the character
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        if ((static_cast<std::uint8_t>(text[i]) & 0xc0) == 0x80) continue;
+
+        std::size_t next = i + 1;
+        while ((next < text.size()) &&
+               ((static_cast<std::uint8_t>(text[next]) & 0xc0) == 0x80))
+        {
+            next++;
+        }
+
+        std::u8string invalid = text;
+        invalid[i] = static_cast<char8_t>(0xff);
+
+        // Build the expected output from the valid text either side
+        std::vector<std::uint8_t> expected(text.size() * 2);
+        SIMD::SetTier(SIMD::Tier::Scalar);
+        auto [result, length] = ConvertUTF8ToUTF16(
+            std::span<const std::uint8_t>(
+                reinterpret_cast<const std::uint8_t *>(text.data()),
+                i),
+            expected,
+            true);
+        STF_ASSERT_TRUE(result);
+        expected.resize(length);
+        for (std::size_t j = i; j < next; j++)
+        {
+            expected.push_back(0xfd);
+            expected.push_back(0xff);
+        }
+        std::vector<std::uint8_t> suffix((text.size() - next) * 2);
+        std::tie(result, length) = ConvertUTF8ToUTF16(
+            std::span<const std::uint8_t>(
+                reinterpret_cast<const std::uint8_t *>(text.data()) + next,
+                text.size() - next),
+            suffix,
+            true);
+        STF_ASSERT_TRUE(result);
+        expected.insert(expected.end(),
+                        suffix.begin(),
+                        suffix.begin() + length);
+
+        for (auto tier : {SIMD::Tier::Scalar,
+                          SIMD::Tier::SSE42,
+                          SIMD::Tier::AVX2,
+                          SIMD::Tier::AVX512})
+        {
+            if (!SIMD::SetTier(tier)) continue;
+
+            std::vector<std::uint8_t> output(invalid.size() * 2);
+            std::tie(result, length) = ConvertUTF8ToUTF16Lossy(
+                std::span<const std::uint8_t>(
+                    reinterpret_cast<const std::uint8_t *>(invalid.data()),
+                    invalid.size()),
+                output,
+                true);
+            STF_ASSERT_TRUE(result);
+            output.resize(length);
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+STF_TEST(TestUTF8toUTF16, Overlong)
+{
+    std::vector<std::uint8_t> output(16);
+
+    // The shortest and longest characters of each length convert correctly
+    const std::vector<std::uint8_t> boundaries = {
+        0xc2, 0x80, 0xdf, 0xbf, 0xe0, 0xa0, 0x80, 0xef,
+        0xbf, 0xbf, 0xf0, 0x90, 0x80, 0x80, 0xf4, 0x8f,
+        0xbf, 0xbf
+    };
+    const std::vector<std::uint8_t> expected = {
+        0x00, 0x80, 0x07, 0xff, 0x08, 0x00, 0xff, 0xff,
+        0xd8, 0x00, 0xdc, 0x00, 0xdb, 0xff, 0xdf, 0xff
+    };
+    output.resize(boundaries.size() * 2);
+    auto [result, length] = ConvertUTF8ToUTF16(boundaries, output, false);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_EQ(expected, output);
+
+    // Overlong encodings are rejected
+    for (const std::vector<std::uint8_t> &overlong :
+            {std::vector<std::uint8_t>{'a', 0xc0, 0x80},
+             std::vector<std::uint8_t>{'a', 0xc1, 0xbf},
+             std::vector<std::uint8_t>{'a', 0xe0, 0x9f, 0xbf},
+             std::vector<std::uint8_t>{'a', 0xf0, 0x8f, 0xbf, 0xbf}})
+    {
+        output.resize(overlong.size() * 2);
+        ConversionResult partial =
+            ConvertUTF8ToUTF16Partial(overlong, output, true);
+        STF_ASSERT_FALSE(partial.success);
+        STF_ASSERT_EQ(1u, partial.consumed);
+        STF_ASSERT_EQ(2u, partial.produced);
+        STF_ASSERT_TRUE(partial.error == UnicodeError::Overlong);
+    }
+
+    // Each octet of an overlong encoding is replaced by the lossy conversion
+    const std::vector<std::uint8_t> overlong = {0xc0, 0xaf, 0xe0, 0x80, 0xbf};
+    output.resize(overlong.size() * 2);
+    std::tie(result, length) = ConvertUTF8ToUTF16Lossy(overlong, output, true);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(10u, length);
+}
+
+STF_TEST(TestUTF8toUTF16, NativeCodeUnits)
+{
+    const std::u8string_view text = u8"Hello, 你好世界！ Привет 😀🌍";
+    const std::u16string expected = u"Hello, 你好世界！ Привет 😀🌍";
+
+    // Convert directly into a std::u16string in the host's byte order
+    std::u16string output(text.size(), u'\0');
+    auto [result, length] = ConvertUTF8ToUTF16(text, output);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+    STF_ASSERT_TRUE(expected == output);
+
+    // Invalid input is rejected
+    const std::u8string invalid = u8"abc\xc0\x80";
+    output.resize(invalid.size());
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16(invalid, output).first);
+
+    // The output must have as many code units as the input has octets
+    output.resize(text.size() - 1);
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16(text, output).first);
+}
+
+STF_TEST(TestUTF8toUTF16, TemplateByteOrder)
+{
+    const std::u8string text = MultilingualText();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+    std::vector<std::uint8_t> expected(text.size() * 2);
+    std::vector<std::uint8_t> output(text.size() * 2);
+
+    // Little endian instantiation matches the run time byte order selection
+    auto [expected_result, expected_length] =
+        ConvertUTF8ToUTF16(octets, expected, true);
+    STF_ASSERT_TRUE(expected_result);
+    auto [result, length] =
+        ConvertUTF8ToUTF16<std::endian::little>(octets, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(expected_length, length);
+    STF_ASSERT_EQ(expected, output);
+
+    // Big endian instantiation matches the run time byte order selection
+    std::tie(expected_result, expected_length) =
+        ConvertUTF8ToUTF16(octets, expected, false);
+    STF_ASSERT_TRUE(expected_result);
+    std::tie(result, length) =
+        ConvertUTF8ToUTF16<std::endian::big>(octets, output);
+    STF_ASSERT_TRUE(result);
+    STF_ASSERT_EQ(expected_length, length);
+    STF_ASSERT_EQ(expected, output);
+
+    // The partial conversion reports errors in the same way
+    const std::vector<std::uint8_t> invalid = {'a', 'b', 0xc0, 0x80};
+    ConversionResult partial =
+        ConvertUTF8ToUTF16Partial<std::endian::big>(invalid, output);
+    STF_ASSERT_FALSE(partial.success);
+    STF_ASSERT_EQ(2u, partial.consumed);
+    STF_ASSERT_EQ(4u, partial.produced);
+    STF_ASSERT_EQ(std::vector<std::uint8_t>({0x00, 'a', 0x00, 'b'}),
+                  std::vector<std::uint8_t>(output.begin(),
+                                            output.begin() + 4));
+    STF_ASSERT_TRUE(partial.error == UnicodeError::Overlong);
+}
+
+namespace
+{
+
+// Memory resource that counts the allocations made through it
+class CountingResource : public std::pmr::memory_resource
+{
+    public:
+        std::size_t allocations{};
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes,
+                                                              alignment);
+        }
+
+        void do_deallocate(void *p,
+                           std::size_t bytes,
+                           std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+};
+
+} // namespace
+
+STF_TEST(TestUTF8toUTF16, Allocating)
+{
+    const std::u8string text = MultilingualText();
+    const std::string_view utf8(reinterpret_cast<const char *>(text.data()),
+                                text.size());
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    // The octets returned match those of the non-allocating function
+    for (bool little_endian : {true, false})
+    {
+        std::vector<std::uint8_t> expected(text.size() * 2);
+        auto [result, length] =
+            ConvertUTF8ToUTF16(octets, expected, little_endian);
+        STF_ASSERT_TRUE(result);
+        expected.resize(length);
+
+        std::optional<std::vector<std::uint8_t>> output =
+            ConvertUTF8ToUTF16(octets, little_endian);
+        STF_ASSERT_TRUE(output.has_value());
+        STF_ASSERT_EQ(expected, *output);
+    }
+
+    // The string returned has exactly the required length
+    std::u16string expected(text.size(), u'\0');
+    auto [result, length] = ConvertUTF8ToUTF16(text, expected);
+    STF_ASSERT_TRUE(result);
+    expected.resize(length);
+    std::optional<std::u16string> output = ConvertUTF8ToUTF16(utf8);
+    STF_ASSERT_TRUE(output.has_value());
+    STF_ASSERT_TRUE(expected == *output);
+
+    // Only one allocation is made from the memory resource
+    CountingResource resource;
+    std::optional<std::pmr::u16string> pmr_output =
+        ConvertUTF8ToUTF16(utf8, &resource);
+    STF_ASSERT_TRUE(pmr_output.has_value());
+    STF_ASSERT_TRUE(std::u16string_view(*pmr_output) == expected);
+    STF_ASSERT_EQ(1u, resource.allocations);
+
+    // Empty input produces an empty string
+    output = ConvertUTF8ToUTF16(std::string_view{});
+    STF_ASSERT_TRUE(output.has_value());
+    STF_ASSERT_TRUE(output->empty());
+
+    // Invalid input produces no string
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16(std::string_view("abc\xc0\x80")));
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16(std::string_view("abc\xe4\xbd")));
+    STF_ASSERT_FALSE(ConvertUTF8ToUTF16(std::string_view("\xff"), &resource));
+}
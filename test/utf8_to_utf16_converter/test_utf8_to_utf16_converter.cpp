@@ -0,0 +1,204 @@
+/*
+ *  test_utf8_to_utf16_converter.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the object that converts a stream of UTF-8
+ *      octets to UTF-16.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <terra/charutil/utf8_to_utf16_converter.h>
+#include <terra/stf/adapters/integral_vector.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a string long enough to be processed by the SIMD kernels
+std::vector<std::uint8_t> MultilingualText()
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Convert the entire text in one call
+std::vector<std::uint8_t> Convert(const std::vector<std::uint8_t> &text,
+                                  bool little_endian)
+{
+    std::vector<std::uint8_t> output(text.size() * 2);
+    auto [result, length] = ConvertUTF8ToUTF16(text, output, little_endian);
+    STF_ASSERT_TRUE(result);
+    output.resize(length);
+
+    return output;
+}
+
+} // namespace
+
+STF_TEST(TestUTF8toUTF16Converter, Chunks)
+{
+    const std::vector<std::uint8_t> text = MultilingualText();
+
+    for (bool little_endian : {true, false})
+    {
+        const std::vector<std::uint8_t> expected = Convert(text,
+                                                           little_endian);
+        UTF8ToUTF16Converter converter(little_endian);
+
+        // Feed the text in chunks of every size up to 100 octets, giving an
+        // output span large enough to accept each entire chunk
+        for (std::size_t chunk_size = 1; chunk_size <= 100; chunk_size++)
+        {
+            std::vector<std::uint8_t> output;
+
+            for (std::size_t i = 0; i < text.size(); i += chunk_size)
+            {
+                std::span<const std::uint8_t> chunk =
+                    std::span<const std::uint8_t>(text).subspan(
+                        i,
+                        std::min(chunk_size, text.size() - i));
+                std::vector<std::uint8_t> buffer(chunk.size() * 2 + 2);
+
+                ConversionResult result = converter.Feed(chunk, buffer);
+                STF_ASSERT_TRUE(result.success);
+                STF_ASSERT_EQ(chunk.size(), result.consumed);
+                output.insert(output.end(),
+                              buffer.begin(),
+                              buffer.begin() + result.produced);
+            }
+
+            STF_ASSERT_TRUE(converter.Finish());
+            STF_ASSERT_EQ(expected, output);
+        }
+    }
+}
+
+STF_TEST(TestUTF8toUTF16Converter, SmallOutput)
+{
+    const std::vector<std::uint8_t> text = MultilingualText();
+    const std::vector<std::uint8_t> expected = Convert(text, true);
+    UTF8ToUTF16Converter converter(true);
+
+    // Feed the text in chunks into an output span that holds only a few
+    // characters, feeding the unconsumed remainder of each chunk again
+    for (std::size_t chunk_size = 1; chunk_size <= 20; chunk_size++)
+    {
+        std::vector<std::uint8_t> output;
+        std::vector<std::uint8_t> buffer(6);
+
+        for (std::size_t i = 0; i < text.size(); i += chunk_size)
+        {
+            std::span<const std::uint8_t> chunk =
+                std::span<const std::uint8_t>(text).subspan(
+                    i,
+                    std::min(chunk_size, text.size() - i));
+
+            while (!chunk.empty())
+            {
+                ConversionResult result = converter.Feed(chunk, buffer);
+                STF_ASSERT_TRUE(result.success);
+                output.insert(output.end(),
+                              buffer.begin(),
+                              buffer.begin() + result.produced);
+                chunk = chunk.subspan(result.consumed);
+            }
+        }
+
+        STF_ASSERT_TRUE(converter.Finish());
+        STF_ASSERT_EQ(expected, output);
+    }
+}
+
+STF_TEST(TestUTF8toUTF16Converter, Truncated)
+{
+    const std::vector<std::uint8_t> text = {'a', 0xf0, 0x9f, 0x98};
+    std::vector<std::uint8_t> output(16);
+    UTF8ToUTF16Converter converter(true);
+
+    // The incomplete character is retained, so the chunk is accepted
+    ConversionResult result = converter.Feed(text, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(4u, result.consumed);
+    STF_ASSERT_EQ(2u, result.produced);
+
+    // The stream ends with an incomplete character
+    STF_ASSERT_FALSE(converter.Finish());
+
+    // The converter may be used again after Finish()
+    result = converter.Feed(text, output);
+    STF_ASSERT_TRUE(result.success);
+    result = converter.Feed(std::vector<std::uint8_t>{0x80}, output);
+    STF_ASSERT_TRUE(result.success);
+    STF_ASSERT_EQ(1u, result.consumed);
+    STF_ASSERT_EQ(std::vector<std::uint8_t>({0x3d, 0xd8, 0x00, 0xde}),
+                  std::vector<std::uint8_t>(output.begin(),
+                                            output.begin() + 4));
+    STF_ASSERT_TRUE(converter.Finish());
+}
+
+STF_TEST(TestUTF8toUTF16Converter, Invalid)
+{
+    std::vector<std::uint8_t> output(16);
+    UTF8ToUTF16Converter converter(true);
+
+    // An invalid octet within a chunk is reported at its position
+    ConversionResult result =
+        converter.Feed(std::vector<std::uint8_t>{'a', 'b', 0xff}, output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(2u, result.consumed);
+    STF_ASSERT_EQ(4u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::InvalidLeadOctet);
+    converter.Reset();
+
+    // A character that spans chunks must be completed by continuation octets
+    result = converter.Feed(std::vector<std::uint8_t>{'a', 0xe4}, output);
+    STF_ASSERT_TRUE(result.success);
+    result = converter.Feed(std::vector<std::uint8_t>{'b'}, output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(0u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::TruncatedSequence);
+    converter.Reset();
+
+    // A surrogate split across chunks is rejected once its second octet
+    // arrives
+    result = converter.Feed(std::vector<std::uint8_t>{0xed}, output);
+    STF_ASSERT_TRUE(result.success);
+    result = converter.Feed(std::vector<std::uint8_t>{0xa0, 0x80}, output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(0u, result.consumed);
+    STF_ASSERT_TRUE(result.error == UnicodeError::Surrogate);
+    converter.Reset();
+
+    // The start of an overlong sequence at the end of a chunk is rejected
+    // without waiting for the next chunk
+    result = converter.Feed(std::vector<std::uint8_t>{'a', 0xe0, 0x80},
+                            output);
+    STF_ASSERT_FALSE(result.success);
+    STF_ASSERT_EQ(1u, result.consumed);
+    STF_ASSERT_EQ(2u, result.produced);
+    STF_ASSERT_TRUE(result.error == UnicodeError::Overlong);
+}
@@ -0,0 +1,140 @@
+/*
+ *  test_utf8_validator.cpp
+ *
+ *  Copyright (c) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module will test the object that validates a stream of UTF-8
+ *      octets.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <terra/charutil/utf8_validator.h>
+#include <terra/charutil/character_utilities.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::CharUtil;
+
+namespace
+{
+
+// Produce a string long enough to be processed by the SIMD kernels
+std::vector<std::uint8_t> MultilingualText()
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return std::vector<std::uint8_t>(text.begin(), text.end());
+}
+
+// Validate the text by feeding it in chunks of the given size
+bool ValidateChunks(UTF8Validator &validator,
+                    const std::vector<std::uint8_t> &text,
+                    std::size_t chunk_size)
+{
+    for (std::size_t i = 0; i < text.size(); i += chunk_size)
+    {
+        validator.Feed(std::span<const std::uint8_t>(text).subspan(
+            i,
+            std::min(chunk_size, text.size() - i)));
+    }
+
+    return validator.Finish();
+}
+
+} // namespace
+
+STF_TEST(TestUTF8Validator, Empty)
+{
+    UTF8Validator validator;
+
+    STF_ASSERT_TRUE(validator.Feed({}));
+    STF_ASSERT_TRUE(validator.Finish());
+}
+
+STF_TEST(TestUTF8Validator, ValidChunks)
+{
+    const std::vector<std::uint8_t> text = MultilingualText();
+    UTF8Validator validator;
+
+    for (std::size_t chunk_size = 1; chunk_size <= 100; chunk_size++)
+    {
+        STF_ASSERT_TRUE(ValidateChunks(validator, text, chunk_size));
+    }
+}
+
+STF_TEST(TestUTF8Validator, InvalidChunks)
+{
+    const std::vector<std::uint8_t> text = MultilingualText();
+    UTF8Validator validator;
+
+    // Place an invalid octet at various positions
+    for (std::size_t i = 0; i < text.size(); i += 7)
+    {
+        std::vector<std::uint8_t> invalid = text;
+        invalid[i] = 0xff;
+
+        for (std::size_t chunk_size : {1, 2, 3, 5, 16, 64})
+        {
+            STF_ASSERT_FALSE(ValidateChunks(validator, invalid, chunk_size));
+        }
+    }
+}
+
+STF_TEST(TestUTF8Validator, TruncatedChunks)
+{
+    const std::vector<std::uint8_t> text = MultilingualText();
+    UTF8Validator validator;
+
+    // Truncate the text at every position, which is valid only when the
+    // truncation occurs at a character boundary
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        const std::vector<std::uint8_t> truncated(text.begin(),
+                                                  text.begin() + i);
+        bool expected = IsUTF8Valid(truncated);
+
+        for (std::size_t chunk_size : {1, 2, 3, 5, 16, 64})
+        {
+            STF_ASSERT_EQ(expected,
+                          ValidateChunks(validator, truncated, chunk_size));
+        }
+    }
+}
+
+STF_TEST(TestUTF8Validator, SplitSurrogate)
+{
+    UTF8Validator validator;
+
+    // An encoded surrogate split across chunks is rejected once complete
+    STF_ASSERT_TRUE(validator.Feed(std::vector<std::uint8_t>{'a', 0xed}));
+    STF_ASSERT_TRUE(validator.Feed(std::vector<std::uint8_t>{0xa0}));
+    STF_ASSERT_FALSE(validator.Feed(std::vector<std::uint8_t>{0x80, 'b'}));
+
+    // Further chunks are ignored once the stream is invalid
+    STF_ASSERT_FALSE(validator.Feed(std::vector<std::uint8_t>{'c'}));
+    STF_ASSERT_FALSE(validator.Finish());
+
+    // The validator may be used again after Finish()
+    STF_ASSERT_TRUE(validator.Feed(std::vector<std::uint8_t>{'a', 0xe4}));
+    STF_ASSERT_TRUE(validator.Feed(std::vector<std::uint8_t>{0xbd, 0xa0}));
+    STF_ASSERT_TRUE(validator.Finish());
+}
@@ -18,7 +18,9 @@
 
 #include <cstdint>
 #include <vector>
+#include <string>
 #include <terra/charutil/character_utilities.h>
+#include "simd_dispatch.h"
 #include <terra/stf/adapters/integral_vector.h>
 #include <terra/stf/stf.h>
 
@@ -150,3 +152,357 @@ STF_TEST(TestUTF8Validity, Invalid3)
 
     STF_ASSERT_FALSE(IsUTF8Valid(invalid_sequence));
 }
+
+namespace
+{
+
+// Produce a string long enough to be processed by the SIMD kernels
+std::u8string MultilingualText()
+{
+    std::u8string text;
+
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        text += u8"Hello, World! ";
+        text += u8"你好世界！";
+        text += u8"Привет, мир! ";
+        text += u8"😀 🌍 ";
+    }
+
+    return text;
+}
+
+// Call IsUTF8Valid() with every supported SIMD tier and ensure each yields
+// the expected result
+void CheckAllTiers(const std::u8string &text, bool expected)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+
+        STF_ASSERT_EQ(expected, IsUTF8Valid(octets));
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+// Call ValidateUTF8() with every supported SIMD tier and ensure each reports
+// the expected error at the expected position
+void CheckErrorAllTiers(const std::u8string &text,
+                        UnicodeError error,
+                        std::size_t position)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+
+        ValidationResult result = ValidateUTF8(octets);
+        STF_ASSERT_TRUE(result.error == error);
+        STF_ASSERT_EQ(position, result.position);
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+// Call MeasureUTF8() with every supported SIMD tier and ensure each yields
+// the same results as measuring the string in separate passes
+void CheckMeasureAllTiers(const std::u8string &text)
+{
+    const SIMD::Tier initial_tier = SIMD::GetTier();
+    const std::span<const std::uint8_t> octets(
+        reinterpret_cast<const std::uint8_t *>(text.data()),
+        text.size());
+    const ValidationResult expected = ValidateUTF8(octets);
+    const bool valid = (expected.error == UnicodeError::None);
+    bool ascii = valid;
+    for (char8_t c : text) ascii = ascii && (c < 0x80);
+
+    for (auto tier : {SIMD::Tier::Scalar,
+                      SIMD::Tier::SSE42,
+                      SIMD::Tier::AVX2,
+                      SIMD::Tier::AVX512})
+    {
+        if (!SIMD::SetTier(tier)) continue;
+
+        UTF8Measurement measurement = MeasureUTF8(octets);
+        STF_ASSERT_EQ(valid, measurement.valid);
+        STF_ASSERT_TRUE(measurement.error == expected.error);
+        STF_ASSERT_EQ(ascii, measurement.ascii);
+        STF_ASSERT_EQ(valid ? CountUTF8CodePoints(octets) : 0,
+                      measurement.code_points);
+        STF_ASSERT_EQ(valid ? UTF16LengthFromUTF8(octets) : 0,
+                      measurement.utf16_length);
+    }
+
+    SIMD::SetTier(initial_tier);
+}
+
+} // namespace
+
+STF_TEST(TestUTF8Validity, LongValid)
+{
+    const std::u8string text = MultilingualText();
+
+    // Check every alignment of the text relative to the SIMD block size
+    for (std::size_t i = 0; i < 64; i++)
+    {
+        CheckAllTiers(std::u8string(i, u8'x') + text, true);
+    }
+}
+
+STF_TEST(TestUTF8Validity, LongASCII)
+{
+    CheckAllTiers(std::u8string(1000, u8'a'), true);
+}
+
+STF_TEST(TestUTF8Validity, LongInvalidOctet)
+{
+    const std::u8string text = MultilingualText();
+
+    // Place an invalid octet at every position
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        std::u8string invalid = text;
+        invalid[i] = static_cast<char8_t>(0xff);
+        CheckAllTiers(invalid, false);
+    }
+}
+
+STF_TEST(TestUTF8Validity, LongTruncated)
+{
+    const std::u8string text = MultilingualText();
+
+    // Truncate the text at every position, which is valid only when the
+    // truncation occurs at a character boundary
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        std::u8string truncated = text.substr(0, i);
+        bool boundary = (i == text.size()) ||
+                        ((static_cast<std::uint8_t>(text[i]) & 0xc0) != 0x80);
+        CheckAllTiers(truncated, boundary);
+    }
+}
+
+STF_TEST(TestUTF8Validity, LongIncompleteBeforeASCII)
+{
+    // An incomplete sequence at the end of one block followed by a block
+    // containing only ASCII characters
+    std::u8string text(64, u8'a');
+    text[63] = static_cast<char8_t>(0xe4);
+    text += std::u8string(64, u8'b');
+
+    CheckAllTiers(text, false);
+}
+
+STF_TEST(TestUTF8Validity, LongSurrogate)
+{
+    std::u8string text(100, u8'a');
+
+    // Surrogate code point U+D800
+    text[70] = static_cast<char8_t>(0xed);
+    text[71] = static_cast<char8_t>(0xa0);
+    text[72] = static_cast<char8_t>(0x80);
+
+    CheckAllTiers(text, false);
+}
+
+STF_TEST(TestUTF8Validity, ErrorCategories)
+{
+    CheckErrorAllTiers(u8"", UnicodeError::None, 0);
+    CheckErrorAllTiers(u8"Hello, 世界", UnicodeError::None, 13);
+
+    // Continuation octet where a character should begin
+    CheckErrorAllTiers(u8"ab\x80", UnicodeError::InvalidLeadOctet, 2);
+
+    // Octet that is never valid in UTF-8
+    CheckErrorAllTiers(u8"ab\xfe", UnicodeError::InvalidLeadOctet, 2);
+
+    // Sequence interrupted by an ASCII character
+    CheckErrorAllTiers(u8"ab\xe4\xbd" u8"a",
+                       UnicodeError::TruncatedSequence,
+                       2);
+
+    // Sequence interrupted by the end of the input
+    CheckErrorAllTiers(u8"ab\xe4\xbd", UnicodeError::TruncatedSequence, 2);
+
+    // Surrogate code point U+D800
+    CheckErrorAllTiers(u8"ab\xed\xa0\x80", UnicodeError::Surrogate, 2);
+
+    // Code point U+110000
+    CheckErrorAllTiers(u8"ab\xf4\x90\x80\x80", UnicodeError::OutOfRange, 2);
+
+    // Overlong encodings of U+0000 and U+07FF
+    CheckErrorAllTiers(u8"ab\xc0\x80", UnicodeError::Overlong, 2);
+    CheckErrorAllTiers(u8"ab\xe0\x9f\xbf", UnicodeError::Overlong, 2);
+}
+
+STF_TEST(TestUTF8Validity, Overlong)
+{
+    // The shortest encoding of each length is valid
+    for (const std::u8string &valid : {std::u8string(u8"\xc2\x80"),
+                                       std::u8string(u8"\xe0\xa0\x80"),
+                                       std::u8string(u8"\xf0\x90\x80\x80"),
+                                       std::u8string(u8"\xed\x9f\xbf"),
+                                       std::u8string(u8"\xf4\x8f\xbf\xbf")})
+    {
+        CheckErrorAllTiers(valid, UnicodeError::None, valid.size());
+    }
+
+    // Overlong encodings are invalid
+    for (const std::u8string &overlong : {std::u8string(u8"\xc0\x80"),
+                                          std::u8string(u8"\xc1\xbf"),
+                                          std::u8string(u8"\xe0\x80\x80"),
+                                          std::u8string(u8"\xe0\x9f\xbf"),
+                                          std::u8string(u8"\xf0\x80\x80\x80"),
+                                          std::u8string(u8"\xf0\x8f\xbf\xbf")})
+    {
+        CheckErrorAllTiers(overlong, UnicodeError::Overlong, 0);
+    }
+
+    // An overlong encoding within a long string is found by every tier
+    const std::u8string text = MultilingualText();
+    for (std::size_t i = 0; i < 128; i++)
+    {
+        CheckErrorAllTiers(std::u8string(i, u8'x') + u8"\xc1\x81" + text,
+                           UnicodeError::Overlong,
+                           i);
+    }
+}
+
+STF_TEST(TestUTF8Validity, AllCharacters)
+{
+    // Encode every character and every surrogate, the latter being invalid
+    for (std::uint32_t c = 0; c <= 0x10'ffff; c++)
+    {
+        std::vector<std::uint8_t> octets;
+
+        if (c <= 0x7f)
+        {
+            octets = {static_cast<std::uint8_t>(c)};
+        }
+        else if (c <= 0x7ff)
+        {
+            octets = {static_cast<std::uint8_t>(0xc0 | (c >> 6)),
+                      static_cast<std::uint8_t>(0x80 | (c & 0x3f))};
+        }
+        else if (c <= 0xffff)
+        {
+            octets = {static_cast<std::uint8_t>(0xe0 | (c >> 12)),
+                      static_cast<std::uint8_t>(0x80 | ((c >> 6) & 0x3f)),
+                      static_cast<std::uint8_t>(0x80 | (c & 0x3f))};
+        }
+        else
+        {
+            octets = {static_cast<std::uint8_t>(0xf0 | (c >> 18)),
+                      static_cast<std::uint8_t>(0x80 | ((c >> 12) & 0x3f)),
+                      static_cast<std::uint8_t>(0x80 | ((c >> 6) & 0x3f)),
+                      static_cast<std::uint8_t>(0x80 | (c & 0x3f))};
+        }
+
+        bool surrogate = (c >= 0xd800) && (c <= 0xdfff);
+        STF_ASSERT_EQ(!surrogate, IsUTF8Valid(octets));
+    }
+}
+
+STF_TEST(TestUTF8Validity, LongErrorPosition)
+{
+    const std::u8string text = MultilingualText();
+
+    // Place an invalid octet at every position; in place of a lead octet
+    // that octet is reported, otherwise the character it interrupts is
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        std::u8string invalid = text;
+        invalid[i] = static_cast<char8_t>(0xff);
+
+        std::size_t start = i;
+        while ((static_cast<std::uint8_t>(text[start]) & 0xc0) == 0x80)
+        {
+            start--;
+        }
+
+        CheckErrorAllTiers(invalid,
+                           (start == i) ? UnicodeError::InvalidLeadOctet :
+                                          UnicodeError::TruncatedSequence,
+                           start);
+    }
+}
+
+STF_TEST(TestUTF8Validity, Measure)
+{
+    const std::u8string text = MultilingualText();
+
+    UTF8Measurement measurement = MeasureUTF8({});
+    STF_ASSERT_TRUE(measurement.valid);
+    STF_ASSERT_TRUE(measurement.ascii);
+    STF_ASSERT_EQ(0u, measurement.code_points);
+    STF_ASSERT_EQ(0u, measurement.utf16_length);
+
+    const std::u8string hello = u8"Hello, 世界😀";
+    measurement = MeasureUTF8({reinterpret_cast<const std::uint8_t *>(
+                                   hello.data()),
+                               hello.size()});
+    STF_ASSERT_TRUE(measurement.valid);
+    STF_ASSERT_FALSE(measurement.ascii);
+    STF_ASSERT_EQ(10u, measurement.code_points);
+    STF_ASSERT_EQ(22u, measurement.utf16_length);
+
+    CheckMeasureAllTiers(std::u8string(1000, u8'a'));
+
+    // Check every alignment of the text relative to the SIMD block size
+    for (std::size_t i = 0; i < 64; i++)
+    {
+        CheckMeasureAllTiers(std::u8string(i, u8'x') + text);
+    }
+
+    // Place an invalid octet at every position
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        std::u8string invalid = text;
+        invalid[i] = static_cast<char8_t>(0xff);
+        CheckMeasureAllTiers(invalid);
+    }
+}
+
+STF_TEST(TestUTF8Validity, MeasureLong)
+{
+    std::u8string text;
+    while (text.size() < 100'000) text += MultilingualText();
+
+    // Strings spanning several measurement blocks, with characters split
+    // across the block boundaries at every alignment
+    CheckMeasureAllTiers(std::u8string(100'000, u8'a'));
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        CheckMeasureAllTiers(std::u8string(i, u8'x') + text);
+    }
+
+    // Errors late in the string or split across a block boundary
+    std::u8string invalid = text;
+    invalid[invalid.size() - 10] = static_cast<char8_t>(0xc0);
+    CheckMeasureAllTiers(invalid);
+
+    invalid = std::u8string(16 * 1024 - 1, u8'a') + u8"\xe4\xbd" +
+              std::u8string(100, u8'b');
+    CheckMeasureAllTiers(invalid);
+
+    invalid = text;
+    invalid.push_back(static_cast<char8_t>(0xf0));
+    CheckMeasureAllTiers(invalid);
+}